@@ -322,6 +322,28 @@ interface IMessageFromWorker {
     callback?: (result: any) => void;
 }
 
+export interface IScreenRect {
+    x: number;
+    y: number;
+    width: number;
+    height: number;
+}
+
+export interface IScreenUpdate extends IScreenRect {
+    data: Uint8ClampedArray;
+}
+
+export interface IFrameStats {
+    frames: number;
+    lastTime: number;
+    avgTime: number;
+    maxTime: number;
+    lastFlushes: number;
+    lastPixels: number;
+    drawBufferSize: number;
+    numDrawBuffers: number;
+}
+
 // message data sent from WASM worker to renderer
 export interface WorkerToRenderMessage {
     // sent from worker once at the start
@@ -330,8 +352,14 @@ export interface WorkerToRenderMessage {
     // screen data (to be displayed in Canvas), sent from worker at each tick
     screen?: Uint8ClampedArray;
 
+    // changed parts of the screen, sent instead of screen after the first frame
+    screenUpdates?: IScreenUpdate[];
+
     isRTL?: boolean;
 
+    // render time statistics, sent from worker every FRAME_STATS_INTERVAL ms
+    frameStats?: IFrameStats;
+
     // message from worker to Studio debugger
     messageToDebugger?: Uint8Array;
 
@@ -567,9 +595,14 @@ export interface IWasmFlowRuntime {
     _init(wasmModuleId: number, debuggerMessageSubsciptionFilter: number, assets: number, assetsSize: number, displayWidth: number, displayHeight: number, darkTheme: boolean, timeZone: number, screensLifetimeSupport: boolean): void;
     _mainLoop(): boolean;
     _getSyncedBuffer(): number;
+    _getSyncedDirtyRectsCount?(): number;
+    _getSyncedDirtyRects?(): number;
+    _setDrawBufferDivisor?(divisor: number): void;
+    _getFrameStats?(): number;
     _onMouseWheelEvent(wheelDeltaY: number, pressed: number): void;
     _onPointerEvent(x: number, y: number, pressed: number): void;
     _onKeyPressed(key: number): void;
+    _onInputEvents?(events: number, count: number): void;
     _onMessageFromDebugger(messageData: number, messageDataSize: number): void;
 
     // eez flow API for Dashboard projects
@@ -729,6 +762,15 @@ export interface IWasmFlowRuntime {
     _lvglGroupAddObject(screenObj: number, groupObj: number, obj: number): void;
     _lvglGroupRemoveObjectsForScreen(screenObj: number): void;
 
+    _lvglSetNameCacheEntry?(kind: number, name: number, value: number): void;
+    _lvglClearNameCache?(): void;
+
+    _lvglAddTickProperty?(obj: number, flowState: number, componentIndex: number, propertyIndex: number): void;
+    _lvglIsTickPropertyChanged?(obj: number, componentIndex: number, propertyIndex: number): boolean;
+
+    _lvglGetCreateFunctionId?(name: number): number;
+    _lvglExecuteCommands?(commands: number, length: number, results: number, maxResults: number): number;
+
     _lvglObjInvalidate(obj: number);
 
     _lvglDeleteScreenOnUnload(screenIndex: number);
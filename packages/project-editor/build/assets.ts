@@ -84,7 +84,12 @@ import {
     FIRST_LVGL_WIDGET_COMPONENT_TYPE
 } from "project-editor/flow/components/component-types";
 
-import { DummyDataBuffer, DataBuffer } from "project-editor/build/data-buffer";
+import {
+    DummyDataBuffer,
+    DataBuffer,
+    AssetsBlock,
+    ASSETS_BLOCK_KIND_LANGUAGE
+} from "project-editor/build/data-buffer";
 
 import { LVGLBuild } from "project-editor/lvgl/build";
 import { ProjectEditor } from "project-editor/project-editor-interface";
@@ -1356,12 +1361,16 @@ function buildHeaderData(
     assets: Assets,
     uncompressedSize: number,
     dataBuffer: DataBuffer,
-    uncompressed: boolean
+    uncompressed: boolean,
+    chunked: boolean = false
 ) {
     // tag
     // HEADER_TAG = 0x5A45457E
     // HEADER_TAG_COMPRESSED = 0x7A65657E
-    const tag = new TextEncoder().encode(uncompressed ? "~EEZ" : "~eez");
+    // HEADER_TAG_CHUNKED = 0x637A657E
+    const tag = new TextEncoder().encode(
+        uncompressed ? "~EEZ" : chunked ? "~ezc" : "~eez"
+    );
     dataBuffer.writeUint8Array(tag);
 
     // projectMajorVersion
@@ -1389,10 +1398,79 @@ function buildHeaderData(
     dataBuffer.finalize();
 }
 
+// Aligned uncompressed format (HEADER_TAG_ALIGNED = 0x4145457E): tag,
+// reserved uint32 and then the same fields as in the uncompressed format.
+// Assets data starts at 8 byte aligned offset, as in the decompressed
+// assets, so the file can be memory mapped and used in place.
+function buildAlignedHeaderData(assets: Assets, dataBuffer: DataBuffer) {
+    dataBuffer.writeUint8Array(new TextEncoder().encode("~EEA"));
+
+    // reserved
+    dataBuffer.writeUint32(0);
+
+    // projectMajorVersion
+    dataBuffer.writeUint8(3); // PROJECT MAJOR VERSION: 3
+    // projectMinorVersion
+    dataBuffer.writeUint8(0); // PROJECT MINOR VERSION: 0
+
+    // assetsType
+    dataBuffer.writeUint8(assets.projectStore.projectTypeTraits.id);
+
+    // external
+    dataBuffer.writeUint8(0);
+
+    // reserved
+    dataBuffer.writeUint32(0);
+
+    dataBuffer.finalize();
+}
+
+// Chunked format: compressed header, number of blocks, block index
+// and then compressed data of each block. Block index entry:
+//   decompressedOffset, decompressedSize, compressedOffset, compressedSize
+//   (all uint32), kind (uint16), reserved (uint16), assetIndex (uint32)
+function buildChunkedAssetsData(
+    assets: Assets,
+    dataBuffer: DataBuffer,
+    blocks: AssetsBlock[],
+    compressedBlocks: Buffer[]
+) {
+    const headerBuffer = new DataBuffer(assets.utf8Support);
+    buildHeaderData(assets, dataBuffer.size, headerBuffer, false, true);
+
+    const BLOCK_INDEX_ENTRY_SIZE = 24;
+    const indexSize = 4 + blocks.length * BLOCK_INDEX_ENTRY_SIZE;
+
+    let compressedOffset = headerBuffer.size + indexSize;
+
+    const indexBuffer = Buffer.alloc(indexSize);
+    indexBuffer.writeUInt32LE(blocks.length, 0);
+    blocks.forEach((block, i) => {
+        const entryOffset = 4 + i * BLOCK_INDEX_ENTRY_SIZE;
+        indexBuffer.writeUInt32LE(block.decompressedOffset, entryOffset);
+        indexBuffer.writeUInt32LE(block.decompressedSize, entryOffset + 4);
+        indexBuffer.writeUInt32LE(compressedOffset, entryOffset + 8);
+        indexBuffer.writeUInt32LE(
+            compressedBlocks[i].length,
+            entryOffset + 12
+        );
+        indexBuffer.writeUInt16LE(block.kind, entryOffset + 16);
+        indexBuffer.writeUInt16LE(0, entryOffset + 18);
+        indexBuffer.writeUInt32LE(block.assetIndex, entryOffset + 20);
+        compressedOffset += compressedBlocks[i].length;
+    });
+
+    return Buffer.concat([
+        headerBuffer.buffer.subarray(0, headerBuffer.size),
+        indexBuffer,
+        ...compressedBlocks
+    ]);
+}
+
 function buildLanguages(assets: Assets, dataBuffer: DataBuffer) {
     dataBuffer.writeArray(
         assets.projectStore.project.texts?.languages ?? [],
-        language => {
+        (language, languageIndex) => {
             dataBuffer.writeObjectOffset(() => {
                 dataBuffer.writeString(language.languageID);
             });
@@ -1404,11 +1482,11 @@ function buildLanguages(assets: Assets, dataBuffer: DataBuffer) {
                         translation =>
                             translation.languageID == language.languageID
                     );
-                    if (translation) {
-                        dataBuffer.writeString(translation.text ?? "");
-                    } else {
-                        dataBuffer.writeString("");
-                    }
+                    dataBuffer.writeLazyString(
+                        translation?.text ?? "",
+                        ASSETS_BLOCK_KIND_LANGUAGE,
+                        languageIndex
+                    );
                 }
             );
         },
@@ -1416,7 +1494,10 @@ function buildLanguages(assets: Assets, dataBuffer: DataBuffer) {
     );
 }
 
-export async function buildGuiAssetsData(assets: Assets) {
+export async function buildGuiAssetsData(
+    assets: Assets,
+    buildChunkedData: boolean = false
+) {
     const dataBuffer = new DataBuffer(assets.utf8Support);
 
     // settings
@@ -1470,16 +1551,40 @@ export async function buildGuiAssetsData(assets: Assets) {
         uncompressedSize
     );
 
+    //
+    const alignedHeaderBuffer = new DataBuffer(assets.utf8Support);
+    buildAlignedHeaderData(assets, alignedHeaderBuffer);
+
+    const alignedData = Buffer.alloc(
+        alignedHeaderBuffer.size + uncompressedSize
+    );
+    alignedHeaderBuffer.buffer.copy(
+        alignedData,
+        0,
+        0,
+        alignedHeaderBuffer.size
+    );
+    dataBuffer.buffer.copy(
+        alignedData,
+        alignedHeaderBuffer.size,
+        0,
+        uncompressedSize
+    );
+
     //
     const COMPRESSION_LEVEL_FOR_DASHBOARD_PROJECTS = 1;
     const COMPRESSION_LEVEL_DEFAULT = 12;
-    const { compressedBuffer, compressedSize } = await dataBuffer.compress(
-        // use min compression level for dashboard projects to be faster,
-        // for other projects we
-        assets.projectStore.projectTypeTraits.isDashboard
-            ? COMPRESSION_LEVEL_FOR_DASHBOARD_PROJECTS
-            : COMPRESSION_LEVEL_DEFAULT
-    );
+    // use min compression level for dashboard projects to be faster,
+    // for other projects we
+    const compressionLevel = assets.projectStore.projectTypeTraits.isDashboard
+        ? COMPRESSION_LEVEL_FOR_DASHBOARD_PROJECTS
+        : COMPRESSION_LEVEL_DEFAULT;
+
+    // chunked data is compressed together with the whole data
+    const compressed = buildChunkedData
+        ? await dataBuffer.compressChunked(compressionLevel)
+        : await dataBuffer.compress(compressionLevel);
+    const { compressedBuffer, compressedSize } = compressed;
 
     const compressedHeaderBuffer = new DataBuffer(assets.utf8Support);
     buildHeaderData(assets, uncompressedSize, compressedHeaderBuffer, false);
@@ -1512,7 +1617,23 @@ export async function buildGuiAssetsData(assets: Assets) {
         "Compressed size: " + compressedSize
     );
 
-    return { uncompressedData, compressedData };
+    let chunkedData: Buffer | undefined;
+    if ("blocks" in compressed) {
+        chunkedData = buildChunkedAssetsData(
+            assets,
+            dataBuffer,
+            compressed.blocks,
+            compressed.compressedBlocks
+        );
+
+        assets.projectStore.outputSectionsStore.write(
+            Section.OUTPUT,
+            MessageType.INFO,
+            "Chunked size: " + chunkedData.length
+        );
+    }
+
+    return { uncompressedData, alignedData, compressedData, chunkedData };
 }
 
 export async function buildAssets(
@@ -1609,24 +1730,56 @@ export async function buildAssets(
         !sectionNames ||
         sectionNames.indexOf("GUI_ASSETS_DEF_COMPRESSED") !== -1;
 
+    // chunked format is built only on request, old firmware can't load it
+    const buildAssetsDeclChunked =
+        sectionNames != undefined &&
+        sectionNames.indexOf("GUI_ASSETS_DECL_CHUNKED") !== -1;
+
+    const buildAssetsDefChunked =
+        sectionNames != undefined &&
+        sectionNames.indexOf("GUI_ASSETS_DEF_CHUNKED") !== -1;
+
     const buildAssetsData =
         !sectionNames || sectionNames.indexOf("GUI_ASSETS_DATA") !== -1;
 
     const buildAssetsDataMap =
         !sectionNames || sectionNames.indexOf("GUI_ASSETS_DATA_MAP") !== -1;
 
+    // assets file for loadMainAssetsFromFile on native targets
+    const buildAssetsFile =
+        option == "buildFiles" &&
+        project.projectTypeTraits.isLVGL &&
+        project.projectTypeTraits.hasFlowSupport &&
+        project.settings.build.generateSourceCodeForEezFramework &&
+        project.settings.build.generateAssetsFile;
+
     if (
         buildAssetsDecl ||
         buildAssetsDeclCompressed ||
         buildAssetsDef ||
         buildAssetsDefCompressed ||
+        buildAssetsDeclChunked ||
+        buildAssetsDefChunked ||
         buildAssetsData ||
-        buildAssetsDataMap
+        buildAssetsDataMap ||
+        buildAssetsFile
     ) {
+        // eez-framework sources generated with the project can load the
+        // chunked format, where the translations of a language are
+        // decompressed when the language is used the first time
+        const lvglCompressFlowDefinition =
+            project.projectTypeTraits.isLVGL &&
+            project.settings.build.generateSourceCodeForEezFramework &&
+            project.settings.build.compressFlowDefinition;
+
         // build all assets as single data chunk
-        const { uncompressedData, compressedData } = await buildGuiAssetsData(
-            assets
-        );
+        const { uncompressedData, alignedData, compressedData, chunkedData } =
+            await buildGuiAssetsData(
+                assets,
+                buildAssetsDeclChunked ||
+                    buildAssetsDefChunked ||
+                    lvglCompressFlowDefinition
+            );
 
         if (option != "buildAssets") {
             if (
@@ -1635,15 +1788,10 @@ export async function buildAssets(
                     !project.projectTypeTraits.hasFlowSupport
                 )
             ) {
-                const lvglCompressFlowDefinition =
-                    project.projectTypeTraits.isLVGL &&
-                    project.settings.build.generateSourceCodeForEezFramework &&
-                    project.settings.build.compressFlowDefinition;
-
                 if (buildAssetsDecl) {
                     result.GUI_ASSETS_DECL = buildGuiAssetsDecl(
                         lvglCompressFlowDefinition
-                            ? compressedData
+                            ? chunkedData!
                             : uncompressedData
                     );
                 }
@@ -1656,7 +1804,7 @@ export async function buildAssets(
                 if (buildAssetsDef) {
                     result.GUI_ASSETS_DEF = await buildGuiAssetsDef(
                         lvglCompressFlowDefinition
-                            ? compressedData
+                            ? chunkedData!
                             : uncompressedData
                     );
                 }
@@ -1666,6 +1814,17 @@ export async function buildAssets(
                         compressedData
                     );
                 }
+
+                if (buildAssetsDeclChunked && chunkedData) {
+                    result.GUI_ASSETS_DECL_CHUNKED =
+                        buildGuiAssetsDecl(chunkedData);
+                }
+
+                if (buildAssetsDefChunked && chunkedData) {
+                    result.GUI_ASSETS_DEF_CHUNKED = await buildGuiAssetsDef(
+                        chunkedData
+                    );
+                }
             } else {
                 if (buildAssetsDecl) {
                     result.GUI_ASSETS_DECL = "";
@@ -1682,12 +1841,24 @@ export async function buildAssets(
                 if (buildAssetsDefCompressed) {
                     result.GUI_ASSETS_DEF_COMPRESSED = "";
                 }
+
+                if (buildAssetsDeclChunked) {
+                    result.GUI_ASSETS_DECL_CHUNKED = "";
+                }
+
+                if (buildAssetsDefChunked) {
+                    result.GUI_ASSETS_DEF_CHUNKED = "";
+                }
             }
         }
 
         if (buildAssetsData) {
             result.GUI_ASSETS_DATA = compressedData;
         }
+
+        if (buildAssetsFile) {
+            result.GUI_ASSETS_FILE = alignedData;
+        }
     }
 
     if (option != "buildAssets") {
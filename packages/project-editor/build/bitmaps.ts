@@ -1,6 +1,7 @@
 import { getBitmapDataAsync } from "project-editor/features/bitmap/bitmap";
 import type { Assets, DataBuffer } from "project-editor/build/assets";
 import { TAB, NamingConvention, getName } from "project-editor/build/helper";
+import { ASSETS_BLOCK_KIND_BITMAP } from "project-editor/build/data-buffer";
 
 export function buildGuiBitmapsEnum(assets: Assets) {
     let bitmaps = assets.bitmaps.map(
@@ -53,12 +54,16 @@ export async function buildGuiBitmapsData(
 ) {
     const bitmaps = await buildGuiBitmaps(assets);
 
-    dataBuffer.writeArray(bitmaps || [], bitmap => {
+    dataBuffer.writeArray(bitmaps || [], (bitmap, i) => {
         dataBuffer.writeInt16(bitmap.width);
         dataBuffer.writeInt16(bitmap.height);
         dataBuffer.writeInt16(bitmap.bpp);
         dataBuffer.writeInt16(0);
         dataBuffer.writeObjectOffset(() => dataBuffer.writeString(bitmap.name));
-        dataBuffer.writeUint8Array(bitmap.pixels);
+        dataBuffer.writeLazyUint8Array(
+            bitmap.pixels,
+            ASSETS_BLOCK_KIND_BITMAP,
+            i
+        );
     });
 }
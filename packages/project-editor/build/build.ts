@@ -433,6 +433,28 @@ export async function build(
                         "EEZ_FLOW_IS_USING_CRYPTO_SHA256"
                     ] as any as boolean
                 );
+
+                const assetsFile = configurationBuildResults["Default"]?.[0]?.[
+                    "GUI_ASSETS_FILE"
+                ] as any as Buffer | undefined;
+                if (assetsFile) {
+                    const baseName = path.basename(
+                        projectStore.filePath || "",
+                        ".eez-project"
+                    );
+
+                    const filePath = `${
+                        destinationFolderPath || ""
+                    }/${baseName}.eez-assets`;
+
+                    await writeBinaryData(filePath, assetsFile);
+
+                    OutputSections.write(
+                        Section.OUTPUT,
+                        MessageType.INFO,
+                        `File "${filePath}" built`
+                    );
+                }
             }
         } else {
             const baseName = path.basename(
@@ -1,4 +1,27 @@
-import { compress } from "project-editor/build/lz4";
+import {
+    compress,
+    compressBlocks,
+    joinBlocks
+} from "project-editor/build/lz4";
+
+// must be the same as ASSETS_BLOCK_KIND_* in eez-framework core/assets.h
+export const ASSETS_BLOCK_KIND_EAGER = 0;
+export const ASSETS_BLOCK_KIND_BITMAP = 1;
+export const ASSETS_BLOCK_KIND_FONT = 2;
+export const ASSETS_BLOCK_KIND_LANGUAGE = 3;
+
+// lazy ranges of the same asset which are at most this far apart are merged
+const MAX_LAZY_RANGE_GAP = 64;
+
+// max. size of a single eagerly decompressed block in the chunked format
+const CHUNKED_EAGER_BLOCK_SIZE = 64 * 1024;
+
+export interface AssetsBlock {
+    decompressedOffset: number;
+    decompressedSize: number;
+    kind: number;
+    assetIndex: number;
+}
 
 export class DataBuffer {
     buffer = Buffer.alloc(32 * 1024 * 1024);
@@ -16,6 +39,8 @@ export class DataBuffer {
         callback: () => void;
     }[] = [];
 
+    lazyRanges: AssetsBlock[] = [];
+
     constructor(public utf8Support: boolean) {}
 
     writeInt8(value: number) {
@@ -102,6 +127,51 @@ export class DataBuffer {
         this.addPadding();
     }
 
+    // Same as writeUint8Array, but in the chunked assets format the data is
+    // decompressed only when the asset (bitmap or font) is used the first time.
+    writeLazyUint8Array(
+        array: Uint8Array | number[],
+        kind: number,
+        assetIndex: number
+    ) {
+        const start = this.currentOffset;
+        this.writeUint8Array(array);
+        this.addLazyRange(start, this.currentOffset, kind, assetIndex);
+    }
+
+    // Same as writeString, used for the translations which are decompressed
+    // when the language is used the first time.
+    writeLazyString(str: string, kind: number, assetIndex: number) {
+        const start = this.currentOffset;
+        this.writeString(str);
+        this.addLazyRange(start, this.currentOffset, kind, assetIndex);
+    }
+
+    addLazyRange(
+        start: number,
+        end: number,
+        kind: number,
+        assetIndex: number
+    ) {
+        const last = this.lazyRanges[this.lazyRanges.length - 1];
+        if (
+            last &&
+            last.kind == kind &&
+            last.assetIndex == assetIndex &&
+            start - (last.decompressedOffset + last.decompressedSize) <=
+                MAX_LAZY_RANGE_GAP
+        ) {
+            last.decompressedSize = end - last.decompressedOffset;
+        } else {
+            this.lazyRanges.push({
+                decompressedOffset: start,
+                decompressedSize: end - start,
+                kind,
+                assetIndex
+            });
+        }
+    }
+
     writeString(str: string) {
         if (this.currentOffset % 4) {
             throw "invalid offset 9";
@@ -252,6 +322,59 @@ export class DataBuffer {
     async compress(compressionLevel: number) {
         return compress(this.buffer, compressionLevel);
     }
+
+    // Splits the buffer into lazy blocks (see writeLazyUint8Array) and eager
+    // blocks of at most CHUNKED_EAGER_BLOCK_SIZE bytes, each compressed
+    // independently. The blocks cover the whole buffer in order, so the
+    // single block image, as returned by compress, is made by joining them
+    // instead of compressing the buffer again.
+    async compressChunked(compressionLevel: number) {
+        const blocks: AssetsBlock[] = [];
+
+        const addEagerBlocks = (start: number, end: number) => {
+            for (
+                let offset = start;
+                offset < end;
+                offset += CHUNKED_EAGER_BLOCK_SIZE
+            ) {
+                blocks.push({
+                    decompressedOffset: offset,
+                    decompressedSize: Math.min(
+                        CHUNKED_EAGER_BLOCK_SIZE,
+                        end - offset
+                    ),
+                    kind: ASSETS_BLOCK_KIND_EAGER,
+                    assetIndex: 0
+                });
+            }
+        };
+
+        let offset = 0;
+        for (const lazyRange of this.lazyRanges) {
+            addEagerBlocks(offset, lazyRange.decompressedOffset);
+            blocks.push(lazyRange);
+            offset = lazyRange.decompressedOffset + lazyRange.decompressedSize;
+        }
+        addEagerBlocks(offset, this.size);
+
+        const compressedBlocks = await compressBlocks(
+            this.buffer,
+            blocks.map(block => ({
+                offset: block.decompressedOffset,
+                size: block.decompressedSize
+            })),
+            compressionLevel
+        );
+
+        const compressedBuffer = joinBlocks(compressedBlocks);
+
+        return {
+            compressedBuffer,
+            compressedSize: compressedBuffer.length,
+            blocks,
+            compressedBlocks
+        };
+    }
 }
 
 export class DummyDataBuffer {
@@ -298,6 +421,12 @@ export class DummyDataBuffer {
 
     writeUint8Array(array: Uint8Array | number[]) {}
 
+    writeLazyUint8Array(
+        array: Uint8Array | number[],
+        kind: number,
+        assetIndex: number
+    ) {}
+
     writeString(str: string) {}
 
     writeArray<T>(
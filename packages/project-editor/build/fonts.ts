@@ -1,6 +1,7 @@
 import type { Font } from "project-editor/features/font/font";
 import type { Assets, DataBuffer } from "project-editor/build/assets";
 import { TAB, NamingConvention, getName } from "project-editor/build/helper";
+import { ASSETS_BLOCK_KIND_FONT } from "project-editor/build/data-buffer";
 
 export function buildGuiFontsEnum(assets: Assets) {
     let fonts = assets.fonts.map(
@@ -18,7 +19,7 @@ export function buildGuiFontsEnum(assets: Assets) {
     return `enum FontsEnum {\n${fonts.join(",\n")}\n};`;
 }
 
-function buildFontData(font: Font, dataBuffer: DataBuffer) {
+function buildFontData(font: Font, fontIndex: number, dataBuffer: DataBuffer) {
     const glyphs = font.glyphs.slice().sort((a, b) => a.encoding - b.encoding);
 
     const groups: {
@@ -79,7 +80,11 @@ function buildFontData(font: Font, dataBuffer: DataBuffer) {
             dataBuffer.writeUint8(0); // reserved
             dataBuffer.writeUint8(0); // reserved
 
-            dataBuffer.writeUint8Array(glyph.pixelArray);
+            dataBuffer.writeLazyUint8Array(
+                glyph.pixelArray,
+                ASSETS_BLOCK_KIND_FONT,
+                fontIndex
+            );
         } else {
             dataBuffer.writeInt8(-128); // empty glyph
         }
@@ -88,5 +93,7 @@ function buildFontData(font: Font, dataBuffer: DataBuffer) {
 
 export function buildGuiFontsData(assets: Assets, dataBuffer: DataBuffer) {
     const fonts = assets.fonts.filter(font => !!font) as Font[];
-    dataBuffer.writeArray(fonts, font => buildFontData(font, dataBuffer));
+    dataBuffer.writeArray(fonts, (font, i) =>
+        buildFontData(font, i, dataBuffer)
+    );
 }
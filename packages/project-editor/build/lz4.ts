@@ -10,18 +10,76 @@ let lz4_module: {
         dstCapacity: number,
         compressionLevel: number
     ) => number;
+    // not available in older lz4.wasm builds
+    _encodeBlocksBound?: (
+        srcBlockSizesPtr: number,
+        numBlocks: number
+    ) => number;
+    _encodeBlocksHC?: (
+        srcPtr: number,
+        srcBlockOffsetsPtr: number,
+        srcBlockSizesPtr: number,
+        numBlocks: number,
+        dstPtr: number,
+        dstCapacity: number,
+        dstBlockSizesPtr: number,
+        compressionLevel: number,
+        numThreads: number
+    ) => number;
+    _encodeStreamCreate?: (
+        compressionLevel: number,
+        blockSize: number,
+        numThreads: number
+    ) => number;
+    _encodeStreamUpdate?: (
+        streamPtr: number,
+        srcPtr: number,
+        srcSize: number
+    ) => number;
+    _encodeStreamFinish?: (streamPtr: number) => number;
+    _encodeStreamNumBlocks?: (streamPtr: number) => number;
+    _encodeStreamCompressedBlockSizes?: (streamPtr: number) => number;
+    _encodeStreamData?: (streamPtr: number) => number;
+    _encodeStreamFree?: (streamPtr: number) => void;
 };
 
-export async function compress(buffer: Buffer, compressionLevel: number) {
+// size of the independently compressed blocks of the streaming encoder,
+// also the size of the input pieces copied to the wasm heap
+const STREAM_BLOCK_SIZE = 1024 * 1024;
+
+function requireLz4ModuleConstructor() {
+    // lz4_mt is built with pthreads and needs SharedArrayBuffer,
+    // it is not there if wasm/lz4 was built with LZ4_PTHREADS=OFF
+    if (typeof SharedArrayBuffer != "undefined") {
+        try {
+            return require("project-editor/flow/runtime/lz4_mt.js");
+        } catch (err) {}
+    }
+    return require("project-editor/flow/runtime/lz4.js");
+}
+
+async function loadLz4Module() {
     if (!lz4_module) {
         // load lz4 wasm module
         lz4_module = await new Promise<any>(resolve => {
-            const lz4_module_constructor = require("project-editor/flow/runtime/lz4.js");
+            const lz4_module_constructor = requireLz4ModuleConstructor();
             const lz4_module = lz4_module_constructor(() => {
                 resolve(lz4_module);
             });
         });
     }
+    return lz4_module;
+}
+
+export async function compress(buffer: Buffer, compressionLevel: number) {
+    await loadLz4Module();
+
+    if (lz4_module._encodeStreamCreate) {
+        const compressedBuffer = joinBlocks(
+            compressStream(buffer, compressionLevel)
+        );
+        return { compressedBuffer, compressedSize: compressedBuffer.length };
+    }
 
     const srcPtr = lz4_module._malloc(buffer.length);
     lz4_module.HEAPU8.set(buffer, srcPtr);
@@ -49,3 +107,288 @@ export async function compress(buffer: Buffer, compressionLevel: number) {
 
     return { compressedBuffer, compressedSize };
 }
+
+export interface Lz4Block {
+    offset: number;
+    size: number;
+}
+
+// Compresses blocks of the buffer independently of each other, blocks can
+// overlap. With lz4_mt blocks are compressed in parallel.
+export async function compressBlocks(
+    buffer: Buffer,
+    blocks: Lz4Block[],
+    compressionLevel: number
+) {
+    await loadLz4Module();
+
+    if (!lz4_module._encodeBlocksHC || !lz4_module._encodeBlocksBound) {
+        const compressedBlocks: Buffer[] = [];
+        for (const block of blocks) {
+            const { compressedBuffer, compressedSize } = await compress(
+                buffer.subarray(block.offset, block.offset + block.size),
+                compressionLevel
+            );
+            compressedBlocks.push(compressedBuffer.subarray(0, compressedSize));
+        }
+        return compressedBlocks;
+    }
+
+    const srcSize = blocks.reduce(
+        (size, block) => Math.max(size, block.offset + block.size),
+        0
+    );
+    const srcPtr = lz4_module._malloc(srcSize);
+    lz4_module.HEAPU8.set(buffer.subarray(0, srcSize), srcPtr);
+
+    const blockOffsetsPtr = lz4_module._malloc(4 * blocks.length);
+    new Int32Array(
+        lz4_module.HEAPU8.buffer,
+        blockOffsetsPtr,
+        blocks.length
+    ).set(blocks.map(block => block.offset));
+
+    const blockSizesPtr = lz4_module._malloc(4 * blocks.length);
+    new Int32Array(lz4_module.HEAPU8.buffer, blockSizesPtr, blocks.length).set(
+        blocks.map(block => block.size)
+    );
+
+    const dstBlockSizesPtr = lz4_module._malloc(4 * blocks.length);
+
+    const dstCapacity = lz4_module._encodeBlocksBound(
+        blockSizesPtr,
+        blocks.length
+    );
+    const dstPtr = lz4_module._malloc(dstCapacity);
+
+    const compressedSize = lz4_module._encodeBlocksHC(
+        srcPtr,
+        blockOffsetsPtr,
+        blockSizesPtr,
+        blocks.length,
+        dstPtr,
+        dstCapacity,
+        dstBlockSizesPtr,
+        compressionLevel,
+        0
+    );
+
+    lz4_module._free(srcPtr);
+    lz4_module._free(blockOffsetsPtr);
+    lz4_module._free(blockSizesPtr);
+
+    if (compressedSize < 0) {
+        lz4_module._free(dstPtr);
+        lz4_module._free(dstBlockSizesPtr);
+        throw "LZ4 block compression failed";
+    }
+
+    const dstBlockSizes = Array.from(
+        new Int32Array(
+            lz4_module.HEAPU8.buffer,
+            dstBlockSizesPtr,
+            blocks.length
+        )
+    );
+
+    const compressedBlocks: Buffer[] = [];
+    let offset = dstPtr;
+    for (const dstBlockSize of dstBlockSizes) {
+        compressedBlocks.push(
+            Buffer.from(
+                new Uint8Array(lz4_module.HEAPU8.buffer, offset, dstBlockSize)
+            )
+        );
+        offset += dstBlockSize;
+    }
+
+    lz4_module._free(dstPtr);
+    lz4_module._free(dstBlockSizesPtr);
+
+    return compressedBlocks;
+}
+
+// Compresses the buffer in STREAM_BLOCK_SIZE blocks with the streaming
+// encoder, only one piece of the input at a time is copied to the wasm heap.
+// With lz4_mt blocks are compressed in parallel.
+function compressStream(buffer: Buffer, compressionLevel: number) {
+    const streamPtr = lz4_module._encodeStreamCreate!(
+        compressionLevel,
+        STREAM_BLOCK_SIZE,
+        0
+    );
+    if (!streamPtr) {
+        throw "LZ4 stream compression failed";
+    }
+
+    const piecePtr = lz4_module._malloc(STREAM_BLOCK_SIZE);
+
+    let result = 0;
+    for (
+        let offset = 0;
+        offset < buffer.length && result == 0;
+        offset += STREAM_BLOCK_SIZE
+    ) {
+        const piece = buffer.subarray(offset, offset + STREAM_BLOCK_SIZE);
+        lz4_module.HEAPU8.set(piece, piecePtr);
+        result = lz4_module._encodeStreamUpdate!(
+            streamPtr,
+            piecePtr,
+            piece.length
+        );
+    }
+
+    lz4_module._free(piecePtr);
+
+    if (result < 0 || lz4_module._encodeStreamFinish!(streamPtr) < 0) {
+        lz4_module._encodeStreamFree!(streamPtr);
+        throw "LZ4 stream compression failed";
+    }
+
+    const numBlocks = lz4_module._encodeStreamNumBlocks!(streamPtr);
+
+    const compressedBlockSizes = Array.from(
+        new Int32Array(
+            lz4_module.HEAPU8.buffer,
+            lz4_module._encodeStreamCompressedBlockSizes!(streamPtr),
+            numBlocks
+        )
+    );
+
+    const compressedBlocks: Buffer[] = [];
+    let offset = lz4_module._encodeStreamData!(streamPtr);
+    for (const compressedBlockSize of compressedBlockSizes) {
+        compressedBlocks.push(
+            Buffer.from(
+                new Uint8Array(
+                    lz4_module.HEAPU8.buffer,
+                    offset,
+                    compressedBlockSize
+                )
+            )
+        );
+        offset += compressedBlockSize;
+    }
+
+    lz4_module._encodeStreamFree!(streamPtr);
+
+    // empty input, still one (empty) block
+    if (compressedBlocks.length == 0) {
+        compressedBlocks.push(Buffer.from([0]));
+    }
+
+    return compressedBlocks;
+}
+
+// Joins LZ4 blocks, compressed independently of each other, into a single
+// LZ4 block which decompresses to the concatenated data of all the blocks,
+// so it can be decoded with one LZ4_decompress_safe call (the "~eez" format).
+// Matches never reach before the start of their block, so only the last
+// sequence of a block, which has literals only, is changed: its literals
+// are moved into the first sequence of the next block.
+export function joinBlocks(compressedBlocks: Buffer[]) {
+    if (compressedBlocks.length == 1) {
+        return compressedBlocks[0];
+    }
+
+    const parts: Buffer[] = [];
+
+    // literals of the last sequence of the previous blocks
+    let pendingLiterals: Buffer[] = [];
+    let numPendingLiterals = 0;
+
+    const writeSequenceStart = (literals: Buffer, matchLengthBits: number) => {
+        const numLiterals = numPendingLiterals + literals.length;
+
+        const lengthBytes = [];
+        if (numLiterals >= 15) {
+            let n = numLiterals - 15;
+            while (n >= 255) {
+                lengthBytes.push(255);
+                n -= 255;
+            }
+            lengthBytes.push(n);
+        }
+
+        parts.push(
+            Buffer.from([
+                (Math.min(numLiterals, 15) << 4) | matchLengthBits,
+                ...lengthBytes
+            ])
+        );
+        parts.push(...pendingLiterals, literals);
+
+        pendingLiterals = [];
+        numPendingLiterals = 0;
+    };
+
+    for (const block of compressedBlocks) {
+        // find the first and the last sequence
+        let firstSequenceEnd = -1;
+        let lastSequenceStart = 0;
+        let lastSequenceLiterals: Buffer | undefined;
+        let firstSequenceLiterals: Buffer | undefined;
+
+        let i = 0;
+        while (i < block.length) {
+            const sequenceStart = i;
+            const token = block[i++];
+
+            let numLiterals = token >> 4;
+            if (numLiterals == 15) {
+                let n;
+                do {
+                    n = block[i++];
+                    numLiterals += n;
+                } while (n == 255);
+            }
+
+            const literals = block.subarray(i, i + numLiterals);
+            i += numLiterals;
+
+            if (sequenceStart == 0) {
+                firstSequenceLiterals = literals;
+            }
+
+            if (i >= block.length) {
+                // last sequence has no match
+                lastSequenceStart = sequenceStart;
+                lastSequenceLiterals = literals;
+                break;
+            }
+
+            if (sequenceStart == 0) {
+                firstSequenceEnd = i;
+            }
+
+            // offset
+            i += 2;
+
+            if ((token & 15) == 15) {
+                let n;
+                do {
+                    n = block[i++];
+                } while (n == 255);
+            }
+        }
+
+        if (firstSequenceEnd == -1) {
+            // only one sequence, with literals only
+            if (lastSequenceLiterals!.length > 0) {
+                pendingLiterals.push(lastSequenceLiterals!);
+                numPendingLiterals += lastSequenceLiterals!.length;
+            }
+            continue;
+        }
+
+        writeSequenceStart(firstSequenceLiterals!, block[0] & 15);
+        parts.push(block.subarray(firstSequenceEnd, lastSequenceStart));
+
+        pendingLiterals.push(lastSequenceLiterals!);
+        numPendingLiterals += lastSequenceLiterals!.length;
+    }
+
+    writeSequenceStart(Buffer.alloc(0), 0);
+
+    return Buffer.concat(parts);
+}
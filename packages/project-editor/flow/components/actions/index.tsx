@@ -1591,12 +1591,107 @@ export class DateNowActionComponent extends ActionComponent {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+class SortArrayThenBy extends EezObject {
+    structureFieldName: string;
+    ascending: boolean;
+    ignoreCase: boolean;
+
+    static classInfo: ClassInfo = {
+        properties: [
+            {
+                name: "structureFieldName",
+                type: PropertyType.Enum,
+                enumItems: (thenBy: SortArrayThenBy) => {
+                    const component = getParent(
+                        getParent(thenBy)!
+                    )! as SortArrayActionComponent;
+                    if (!component.structureName) {
+                        return [];
+                    }
+
+                    const project = ProjectEditor.getProject(component);
+                    const struct = getStructureFromType(
+                        project,
+                        `struct:${component.structureName}`
+                    );
+                    if (!struct) {
+                        return [];
+                    }
+
+                    return struct.fields.map(field => ({
+                        id: field.name,
+                        label: field.name
+                    }));
+                },
+                propertyGridGroup: specificGroup
+            },
+            {
+                name: "ascending",
+                type: PropertyType.Boolean,
+                checkboxStyleSwitch: true,
+                propertyGridGroup: specificGroup
+            },
+            {
+                name: "ignoreCase",
+                type: PropertyType.Boolean,
+                checkboxStyleSwitch: true,
+                propertyGridGroup: specificGroup
+            }
+        ],
+        check: (thenBy: SortArrayThenBy, messages: IMessage[]) => {
+            const component = getParent(
+                getParent(thenBy)!
+            )! as SortArrayActionComponent;
+            if (!thenBy.structureFieldName) {
+                messages.push(
+                    propertyNotSetMessage(thenBy, "structureFieldName")
+                );
+            } else if (component.structureName) {
+                const project = ProjectEditor.getProject(component);
+                const struct = getStructureFromType(
+                    project,
+                    `struct:${component.structureName}`
+                );
+                if (
+                    struct &&
+                    !struct.fieldsMap.get(thenBy.structureFieldName)
+                ) {
+                    messages.push(
+                        propertyNotFoundMessage(thenBy, "structureFieldName")
+                    );
+                }
+            }
+        },
+        defaultValue: {
+            ignoreCase: true,
+            ascending: true
+        },
+        listLabel: (thenBy: SortArrayThenBy, collapsed) =>
+            !collapsed
+                ? ""
+                : `${thenBy.structureFieldName}${
+                      thenBy.ascending ? " ASCENDING" : " DESCENDING"
+                  }${thenBy.ignoreCase ? " IGNORE CASE" : " CASE SENSITIVE"}`
+    };
+
+    override makeEditable() {
+        super.makeEditable();
+
+        makeObservable(this, {
+            structureFieldName: observable,
+            ascending: observable,
+            ignoreCase: observable
+        });
+    }
+}
+
 export class SortArrayActionComponent extends ActionComponent {
     array: string;
     structureName: string;
     structureFieldName: string;
     ascending: boolean;
     ignoreCase: boolean;
+    thenBy: SortArrayThenBy[];
 
     override makeEditable() {
         super.makeEditable();
@@ -1606,7 +1701,8 @@ export class SortArrayActionComponent extends ActionComponent {
             structureName: observable,
             structureFieldName: observable,
             ascending: observable,
-            ignoreCase: observable
+            ignoreCase: observable,
+            thenBy: observable
         });
     }
 
@@ -1679,6 +1775,18 @@ export class SortArrayActionComponent extends ActionComponent {
                 type: PropertyType.Boolean,
                 checkboxStyleSwitch: true,
                 propertyGridGroup: specificGroup
+            },
+            {
+                name: "thenBy",
+                displayName: "Then by",
+                type: PropertyType.Array,
+                typeClass: SortArrayThenBy,
+                propertyGridGroup: specificGroup,
+                partOfNavigation: false,
+                enumerable: false,
+                defaultValue: [],
+                disabled: (component: SortArrayActionComponent) =>
+                    !component.structureName
             }
         ],
         icon: (
@@ -1697,7 +1805,16 @@ export class SortArrayActionComponent extends ActionComponent {
         componentHeaderColor: "#C0C0C0",
         defaultValue: {
             ignoreCase: true,
-            ascending: true
+            ascending: true,
+            thenBy: []
+        },
+        beforeLoadHook: (
+            component: SortArrayActionComponent,
+            objectJS: any
+        ) => {
+            if (objectJS.thenBy == undefined) {
+                objectJS.thenBy = [];
+            }
         },
         check: (component: SortArrayActionComponent, messages: IMessage[]) => {
             if (component.structureName) {
@@ -1767,6 +1884,16 @@ export class SortArrayActionComponent extends ActionComponent {
 
         bodyText += this.ignoreCase ? " IGNORE CASE" : " CASE SENSITIVE";
 
+        if (this.structureName) {
+            for (const thenBy of this.thenBy) {
+                bodyText += `\nTHEN BY ${thenBy.structureFieldName}`;
+                bodyText += thenBy.ascending ? " ASCENDING" : " DESCENDING";
+                bodyText += thenBy.ignoreCase
+                    ? " IGNORE CASE"
+                    : " CASE SENSITIVE";
+            }
+        }
+
         return (
             <div className="body">
                 <pre>{bodyText}</pre>
@@ -1795,14 +1922,42 @@ export class SortArrayActionComponent extends ActionComponent {
         // flags
         const SORT_ARRAY_FLAG_ASCENDING = 1 << 0;
         const SORT_ARRAY_FLAG_IGNORE_CASE = 1 << 1;
-        let flags = 0;
-        if (this.ascending) {
-            flags |= SORT_ARRAY_FLAG_ASCENDING;
-        }
-        if (this.ignoreCase) {
-            flags |= SORT_ARRAY_FLAG_IGNORE_CASE;
+        const SORT_ARRAY_FLAG_THEN_BY = 1 << 2;
+
+        const getFlags = (ascending: boolean, ignoreCase: boolean) => {
+            let flags = 0;
+            if (ascending) {
+                flags |= SORT_ARRAY_FLAG_ASCENDING;
+            }
+            if (ignoreCase) {
+                flags |= SORT_ARRAY_FLAG_IGNORE_CASE;
+            }
+            return flags;
+        };
+
+        const thenBy = this.structureName ? this.thenBy : [];
+
+        let flags = getFlags(this.ascending, this.ignoreCase);
+        if (thenBy.length > 0) {
+            flags |= SORT_ARRAY_FLAG_THEN_BY;
         }
         dataBuffer.writeUint32(flags);
+
+        // thenBy
+        dataBuffer.writeArray(thenBy, thenBy => {
+            // structFieldIndex
+            dataBuffer.writeInt32(
+                assets.projectStore.typesStore.getFieldIndex(
+                    `struct:${this.structureName}`,
+                    thenBy.structureFieldName
+                ) ?? -1
+            );
+
+            // flags
+            dataBuffer.writeUint32(
+                getFlags(thenBy.ascending, thenBy.ignoreCase)
+            );
+        });
     }
 }
 
@@ -0,0 +1,195 @@
+import React from "react";
+import {
+    action,
+    computed,
+    makeObservable,
+    observable,
+    runInAction
+} from "mobx";
+import { observer } from "mobx-react";
+
+import { IconAction } from "eez-studio-ui/action";
+
+import { Panel } from "project-editor/ui-components/Panel";
+import { RuntimeBase } from "project-editor/flow/runtime/runtime";
+import {
+    ProfilerEntry,
+    ProfilerMode,
+    RemoteRuntime
+} from "project-editor/flow/runtime/remote-runtime";
+
+////////////////////////////////////////////////////////////////////////////////
+
+interface ProfilerRow {
+    id: string;
+    label: string;
+    count: number;
+    time: number;
+    allocs: number;
+}
+
+export const ProfilerPanel = observer(
+    class ProfilerPanel extends React.Component<{
+        runtime: RuntimeBase;
+    }> {
+        mode: ProfilerMode = ProfilerMode.OFF;
+        entries: ProfilerEntry[] = [];
+
+        constructor(props: { runtime: RuntimeBase }) {
+            super(props);
+
+            makeObservable(this, {
+                mode: observable,
+                entries: observable.ref,
+                rows: computed
+            });
+        }
+
+        get debuggerConnection() {
+            const runtime = this.props.runtime;
+            return runtime instanceof RemoteRuntime
+                ? runtime.debuggerConnection
+                : undefined;
+        }
+
+        onChangeMode = action((event: React.ChangeEvent<HTMLSelectElement>) => {
+            this.mode = parseInt(event.currentTarget.value);
+            this.debuggerConnection?.setProfilerMode(this.mode);
+        });
+
+        refresh = async () => {
+            const debuggerConnection = this.debuggerConnection;
+            if (!debuggerConnection) {
+                return;
+            }
+            const entries = await debuggerConnection.requestProfilerData();
+            runInAction(() => (this.entries = entries));
+        };
+
+        // Times are self times: time spent in nested property evaluations
+        // is not included in the time of the component executing them.
+        // Sampled totals are scaled up to all calls.
+        get rows(): ProfilerRow[] {
+            const runtime = this.props.runtime;
+            if (!(runtime instanceof RemoteRuntime)) {
+                return [];
+            }
+
+            const rows = this.entries.map(entry => {
+                const flowInAssetsMap =
+                    runtime.assetsMap.flows[entry.flowIndex];
+                const componentInAssetsMap =
+                    flowInAssetsMap?.components[entry.componentIndex];
+
+                let label = componentInAssetsMap
+                    ? componentInAssetsMap.readablePath
+                    : `${entry.flowIndex}/${entry.componentIndex}`;
+
+                if (entry.propertyIndex != -1) {
+                    const propertyName = componentInAssetsMap
+                        ? Object.keys(
+                              componentInAssetsMap.propertyIndexes
+                          ).find(
+                              propertyName =>
+                                  componentInAssetsMap.propertyIndexes[
+                                      propertyName
+                                  ] == entry.propertyIndex
+                          )
+                        : undefined;
+                    label += ` [${propertyName ?? entry.propertyIndex}]`;
+                }
+
+                const scale =
+                    entry.sampledCount > 0
+                        ? entry.count / entry.sampledCount
+                        : 0;
+
+                return {
+                    id: `${entry.flowIndex}.${entry.componentIndex}.${entry.propertyIndex}`,
+                    label,
+                    count: entry.count,
+                    time: entry.sampledTime * scale,
+                    allocs: entry.sampledAllocs * scale
+                };
+            });
+
+            rows.sort((a, b) => b.time - a.time);
+
+            return rows;
+        }
+
+        render() {
+            const enabled = !!this.debuggerConnection;
+
+            return (
+                <div className="EezStudio_DebuggerPanel">
+                    <Panel
+                        id="project-editor/debugger/profiler"
+                        title=""
+                        buttons={[
+                            <div key="mode">
+                                <span style={{ marginRight: 5 }}>Mode:</span>
+                                <select
+                                    className="form-select"
+                                    value={this.mode}
+                                    onChange={this.onChangeMode}
+                                    disabled={!enabled}
+                                >
+                                    <option value={ProfilerMode.OFF}>
+                                        Off
+                                    </option>
+                                    <option value={ProfilerMode.SAMPLING}>
+                                        Sampling
+                                    </option>
+                                    <option value={ProfilerMode.EXACT}>
+                                        Exact
+                                    </option>
+                                </select>
+                            </div>,
+                            <IconAction
+                                key="refresh"
+                                icon="material:refresh"
+                                iconSize={20}
+                                title="Get profiler data"
+                                onClick={this.refresh}
+                                enabled={enabled}
+                            ></IconAction>
+                        ]}
+                        body={
+                            <div className="EezStudio_DebuggerVariablesTable">
+                                <table className="table table-sm">
+                                    <thead>
+                                        <tr>
+                                            <th>Component</th>
+                                            <th>Count</th>
+                                            <th>Time (ms)</th>
+                                            <th>Allocs</th>
+                                        </tr>
+                                    </thead>
+                                    <tbody>
+                                        {this.rows.map(row => (
+                                            <tr key={row.id}>
+                                                <td title={row.label}>
+                                                    {row.label}
+                                                </td>
+                                                <td>{row.count}</td>
+                                                <td>
+                                                    {(row.time / 1000).toFixed(
+                                                        2
+                                                    )}
+                                                </td>
+                                                <td>
+                                                    {Math.round(row.allocs)}
+                                                </td>
+                                            </tr>
+                                        ))}
+                                    </tbody>
+                                </table>
+                            </div>
+                        }
+                    />
+                </div>
+            );
+        }
+    }
+);
@@ -14,20 +14,37 @@ export const QueuePanel = observer(
     class QueuePanel extends React.Component<{
         runtime: RuntimeBase;
     }> {
-        render() {
+        get title() {
+            const titles = [];
+
             const memTotal = this.props.runtime.totalMemory;
-            const memAlloc = memTotal - this.props.runtime.freeMemory;
+            if (memTotal != 0) {
+                const memAlloc = memTotal - this.props.runtime.freeMemory;
+                titles.push(
+                    `Memory usage: ${memAlloc} of ${memTotal} (${Math.round(
+                        (memAlloc * 100) / memTotal
+                    )}%)`
+                );
+            }
+
+            const frameStats = this.props.runtime.frameStats;
+            if (frameStats && frameStats.frames > 0) {
+                titles.push(
+                    `Frame time: ${frameStats.avgTime.toFixed(
+                        1
+                    )} ms avg, ${frameStats.maxTime.toFixed(1)} ms max`
+                );
+            }
+
+            return titles.join(", ");
+        }
+
+        render() {
             return (
                 <div className="EezStudio_DebuggerPanel">
                     <Panel
                         id="project-editor/debugger/queue"
-                        title={
-                            this.props.runtime.totalMemory != 0
-                                ? `Memory usage: ${memAlloc} of ${memTotal} (${Math.round(
-                                      (memAlloc * 100) / memTotal
-                                  )}%)`
-                                : ""
-                        }
+                        title={this.title}
                         buttons={
                             this.props.runtime instanceof DebugInfoRuntime
                                 ? []
@@ -266,6 +266,19 @@ const WatchTable = observer(
 
                 const MAX_CHILDREN = 1000; // MAX_ARRAY_SIZE_TRANSFERRED_IN_DEBUGGER
 
+                const pageSize =
+                    this.props.runtime.getDebuggerValuePageSize(value);
+                if (pageSize != undefined && isArray(value)) {
+                    return this.getPagedValueChildren(
+                        id,
+                        value,
+                        type,
+                        pageSize,
+                        0,
+                        value.length
+                    );
+                }
+
                 if (isArray(value) || value instanceof Uint8Array) {
                     return () => {
                         const elementType = type
@@ -462,6 +475,109 @@ const WatchTable = observer(
             }
         );
 
+        // Elements of the large arrays and blobs are transferred from the
+        // debugger page by page, so they are grouped in the ranges of at most
+        // pageSize children and the page is requested when its range is
+        // expanded.
+        getPagedValueChildren(
+            id: string,
+            value: any,
+            type: string | null,
+            pageSize: number,
+            start: number,
+            end: number
+        ): () => ITreeNode[] {
+            return () => {
+                const children: ITreeNode[] = [];
+
+                if (end - start <= pageSize) {
+                    this.props.runtime.requestDebuggerValuePage(
+                        value,
+                        start,
+                        end - start
+                    );
+
+                    const elementType = type
+                        ? getArrayElementTypeFromType(type)
+                        : undefined;
+
+                    for (let i = start; i < end; i++) {
+                        const elementValue = value[i];
+                        const name = `[${i}]`;
+                        const type = elementType ?? typeof elementValue;
+                        const valueLabel = (
+                            <span>
+                                {getValueLabel(
+                                    this.props.runtime.projectStore.project,
+                                    elementValue,
+                                    type
+                                )}
+                            </span>
+                        );
+
+                        children.push(
+                            observable({
+                                id: id + name,
+                                name,
+                                nameTitle: name,
+                                value: valueLabel,
+                                valueTitle: valueLabel,
+                                type: type,
+
+                                children: this.getValueChildren(
+                                    id + name,
+                                    elementValue,
+                                    type
+                                ),
+                                selected: false,
+                                expanded: this.expanded(id + name, false)
+                            })
+                        );
+                    }
+
+                    return children;
+                }
+
+                let rangeSize = pageSize;
+                while ((end - start) / rangeSize > pageSize) {
+                    rangeSize *= pageSize;
+                }
+
+                for (
+                    let rangeStart = start;
+                    rangeStart < end;
+                    rangeStart += rangeSize
+                ) {
+                    const rangeEnd = Math.min(rangeStart + rangeSize, end);
+                    const name = `[${rangeStart}..${rangeEnd - 1}]`;
+
+                    children.push(
+                        observable({
+                            id: id + name,
+                            name,
+                            nameTitle: name,
+                            value: "",
+                            valueTitle: "",
+                            type: "",
+
+                            children: this.getPagedValueChildren(
+                                id + name,
+                                value,
+                                type,
+                                pageSize,
+                                rangeStart,
+                                rangeEnd
+                            ),
+                            selected: false,
+                            expanded: this.expanded(id + name, false)
+                        })
+                    );
+                }
+
+                return children;
+            };
+        }
+
         get watchExpressions() {
             const result = this.selectedComponent;
 
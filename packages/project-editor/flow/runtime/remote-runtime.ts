@@ -68,7 +68,20 @@ export enum MessagesToDebugger {
     MESSAGE_TO_DEBUGGER_PAGE_CHANGED, // PAGE_ID
 
     MESSAGE_TO_DEBUGGER_COMPONENT_EXECUTION_STATE_CHANGED, // FLOW_STATE_INDEX, COMPONENT_INDEX, STATE
-    MESSAGE_TO_DEBUGGER_COMPONENT_ASYNC_STATE_CHANGED // FLOW_STATE_INDEX, COMPONENT_INDEX, STATE
+    MESSAGE_TO_DEBUGGER_COMPONENT_ASYNC_STATE_CHANGED, // FLOW_STATE_INDEX, COMPONENT_INDEX, STATE
+
+    MESSAGE_TO_DEBUGGER_VALUES_CHANGED, // VALUE_ADDR_1,VALUE_ADDR_2,..., VALUE
+
+    MESSAGE_TO_DEBUGGER_PROTOCOL_CHANGED, // PROTOCOL (0:TEXT | 1:BINARY)
+
+    MESSAGE_TO_DEBUGGER_QUEUE_STATS, // NUM_ADDED, NUM_REMOVED, FREE_MEMORY, TOTAL_MEMORY
+    MESSAGE_TO_DEBUGGER_QUEUE_RESET, // no params
+
+    MESSAGE_TO_DEBUGGER_ARRAY_PAGE, // ARRAY_ADDR, OFFSET, ELEMENT_ADDR_1,ELEMENT_ADDR_2,...
+    MESSAGE_TO_DEBUGGER_BLOB_PAGE, // BLOB_ADDR, OFFSET, HEX_DATA
+
+    MESSAGE_TO_DEBUGGER_PROFILER_ENTRY, // FLOW_INDEX, COMPONENT_INDEX, PROPERTY_INDEX, COUNT, SAMPLED_COUNT, SAMPLED_TIME_US, SAMPLED_ALLOCS
+    MESSAGE_TO_DEBUGGER_PROFILER_DATA_END // NUM_ENTRIES, NUM_DROPPED_ENTRIES
 }
 
 enum MessagesFromDebugger {
@@ -81,9 +94,56 @@ enum MessagesFromDebugger {
     MESSAGE_FROM_DEBUGGER_ENABLE_BREAKPOINT, // FLOW_INDEX, COMPONENT_INDEX
     MESSAGE_FROM_DEBUGGER_DISABLE_BREAKPOINT, // FLOW_INDEX, COMPONENT_INDEX
 
-    MESSAGE_FROM_DEBUGGER_MODE // MODE (0:RUN | 1:DEBUG)
+    MESSAGE_FROM_DEBUGGER_MODE, // MODE (0:RUN | 1:DEBUG)
+
+    MESSAGE_FROM_DEBUGGER_PROTOCOL, // PROTOCOL (0:TEXT | 1:BINARY)
+
+    MESSAGE_FROM_DEBUGGER_COALESCE, // MAX_UPDATES_PER_SECOND (0: disabled)
+
+    MESSAGE_FROM_DEBUGGER_PAGED_VALUES, // PAGE_SIZE (0: disabled)
+    MESSAGE_FROM_DEBUGGER_REQUEST_ARRAY_PAGE, // ARRAY_ADDR, OFFSET, COUNT
+    MESSAGE_FROM_DEBUGGER_REQUEST_BLOB_PAGE, // BLOB_ADDR, OFFSET, COUNT
+
+    MESSAGE_FROM_DEBUGGER_PROFILER, // MODE (0:OFF | 1:SAMPLING | 2:EXACT), SAMPLING_PERIOD
+    MESSAGE_FROM_DEBUGGER_REQUEST_PROFILER_DATA // no params
+}
+
+export enum ProfilerMode {
+    OFF,
+    SAMPLING,
+    EXACT
 }
 
+// Component execution has PROPERTY_INDEX -1, expression evaluation of a
+// component property has the index of that property. Times and allocations
+// are self values, the evaluations done while a component executes are only
+// counted in their own entries. In sampling mode only every
+// SAMPLING_PERIOD-th call is timed, so the estimated total time is
+// sampledTime * count / sampledCount. Times are in microseconds.
+export interface ProfilerEntry {
+    flowIndex: number;
+    componentIndex: number;
+    propertyIndex: number;
+    count: number;
+    sampledCount: number;
+    sampledTime: number;
+    sampledAllocs: number;
+}
+
+const DEBUGGER_PROTOCOL_BINARY = 1;
+
+const DEBUGGER_COALESCE_MAX_UPDATES_PER_SECOND = 30;
+
+// Arrays with more elements than this are sent as handles
+// ([ADDR,SIZE,TYPE,HASH]) and their elements are requested page by page.
+const DEBUGGER_PAGE_SIZE = 100;
+
+const DEBUGGER_BLOB_PAGE_SIZE = 4096;
+
+// Same as EEZ_FLOW_DEBUGGER_PAGED_VALUES_SIZE for the simulator, the least
+// recently received handles are forgotten after this many.
+const MAX_PAGED_VALUES = 64;
+
 const DEBUGGER_STATE_RESUMED = 0;
 const DEBUGGER_STATE_PAUSED = 1;
 const DEBUGGER_STATE_SINGLE_STEP = 2;
@@ -120,6 +180,20 @@ export class RemoteRuntime extends RuntimeBase {
         return undefined;
     }
 
+    override getDebuggerValuePageSize(value: any) {
+        return this.debuggerConnection?.isPagedValue(value)
+            ? DEBUGGER_PAGE_SIZE
+            : undefined;
+    }
+
+    override requestDebuggerValuePage(
+        value: any,
+        offset: number,
+        count: number
+    ) {
+        this.debuggerConnection?.requestPagedValueRange(value, offset, count);
+    }
+
     async doStartRuntime(isDebuggerActive: boolean) {
         const partsPromise = this.projectStore.build();
 
@@ -583,8 +657,471 @@ export class RemoteRuntime extends RuntimeBase {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Binary debugger protocol: every record is VARINT(LENGTH) followed by
+// LENGTH bytes, which start with VARINT(MESSAGE_TYPE) and continue with the
+// message fields. Records are decoded into the same parameters the text
+// protocol produces, so both protocols share the message handling code.
+
+enum BinaryValueTag {
+    UNDEFINED,
+    NULL,
+    FALSE,
+    TRUE,
+    INT,
+    UINT,
+    FLOAT,
+    DOUBLE,
+    STRING,
+    ARRAY,
+    BLOB,
+    STREAM,
+    JSON,
+    DATE,
+    POINTER,
+    WIDGET,
+    EVENT,
+    UNKNOWN,
+    ARRAY_HANDLE,
+    BLOB_HANDLE
+}
+
+enum BinaryField {
+    INT,
+    UINT,
+    ADDR,
+    DOUBLE,
+    VALUE,
+    ERROR_MESSAGE,
+    LOG_MESSAGE,
+    ADDR_LIST,
+    HEX_DATA
+}
+
+const BINARY_MESSAGE_FIELDS: {
+    [messageType: number]: BinaryField[];
+} = {
+    [MessagesToDebugger.MESSAGE_TO_DEBUGGER_STATE_CHANGED]: [BinaryField.INT],
+    [MessagesToDebugger.MESSAGE_TO_DEBUGGER_ADD_TO_QUEUE]: [
+        BinaryField.INT,
+        BinaryField.INT,
+        BinaryField.INT,
+        BinaryField.INT,
+        BinaryField.INT,
+        BinaryField.UINT,
+        BinaryField.UINT
+    ],
+    [MessagesToDebugger.MESSAGE_TO_DEBUGGER_REMOVE_FROM_QUEUE]: [],
+    [MessagesToDebugger.MESSAGE_TO_DEBUGGER_GLOBAL_VARIABLE_INIT]: [
+        BinaryField.INT,
+        BinaryField.ADDR,
+        BinaryField.VALUE
+    ],
+    [MessagesToDebugger.MESSAGE_TO_DEBUGGER_LOCAL_VARIABLE_INIT]: [
+        BinaryField.INT,
+        BinaryField.INT,
+        BinaryField.ADDR,
+        BinaryField.VALUE
+    ],
+    [MessagesToDebugger.MESSAGE_TO_DEBUGGER_COMPONENT_INPUT_INIT]: [
+        BinaryField.INT,
+        BinaryField.INT,
+        BinaryField.ADDR,
+        BinaryField.VALUE
+    ],
+    [MessagesToDebugger.MESSAGE_TO_DEBUGGER_VALUE_CHANGED]: [
+        BinaryField.ADDR,
+        BinaryField.VALUE
+    ],
+    [MessagesToDebugger.MESSAGE_TO_DEBUGGER_FLOW_STATE_CREATED]: [
+        BinaryField.INT,
+        BinaryField.INT,
+        BinaryField.INT,
+        BinaryField.INT
+    ],
+    [MessagesToDebugger.MESSAGE_TO_DEBUGGER_FLOW_STATE_TIMELINE_CHANGED]: [
+        BinaryField.INT,
+        BinaryField.DOUBLE
+    ],
+    [MessagesToDebugger.MESSAGE_TO_DEBUGGER_FLOW_STATE_DESTROYED]: [
+        BinaryField.INT
+    ],
+    [MessagesToDebugger.MESSAGE_TO_DEBUGGER_FLOW_STATE_ERROR]: [
+        BinaryField.INT,
+        BinaryField.INT,
+        BinaryField.ERROR_MESSAGE
+    ],
+    [MessagesToDebugger.MESSAGE_TO_DEBUGGER_LOG]: [
+        BinaryField.INT,
+        BinaryField.INT,
+        BinaryField.INT,
+        BinaryField.LOG_MESSAGE
+    ],
+    [MessagesToDebugger.MESSAGE_TO_DEBUGGER_PAGE_CHANGED]: [BinaryField.INT],
+    [MessagesToDebugger.MESSAGE_TO_DEBUGGER_COMPONENT_EXECUTION_STATE_CHANGED]:
+        [BinaryField.INT, BinaryField.INT, BinaryField.ADDR],
+    [MessagesToDebugger.MESSAGE_TO_DEBUGGER_COMPONENT_ASYNC_STATE_CHANGED]: [
+        BinaryField.INT,
+        BinaryField.INT,
+        BinaryField.INT
+    ],
+    [MessagesToDebugger.MESSAGE_TO_DEBUGGER_VALUES_CHANGED]: [
+        BinaryField.ADDR_LIST,
+        BinaryField.VALUE
+    ],
+    [MessagesToDebugger.MESSAGE_TO_DEBUGGER_PROTOCOL_CHANGED]: [
+        BinaryField.INT
+    ],
+    [MessagesToDebugger.MESSAGE_TO_DEBUGGER_QUEUE_STATS]: [
+        BinaryField.UINT,
+        BinaryField.UINT,
+        BinaryField.UINT,
+        BinaryField.UINT
+    ],
+    [MessagesToDebugger.MESSAGE_TO_DEBUGGER_QUEUE_RESET]: [],
+    [MessagesToDebugger.MESSAGE_TO_DEBUGGER_ARRAY_PAGE]: [
+        BinaryField.ADDR,
+        BinaryField.UINT,
+        BinaryField.ADDR_LIST
+    ],
+    [MessagesToDebugger.MESSAGE_TO_DEBUGGER_BLOB_PAGE]: [
+        BinaryField.ADDR,
+        BinaryField.UINT,
+        BinaryField.HEX_DATA
+    ],
+    [MessagesToDebugger.MESSAGE_TO_DEBUGGER_PROFILER_ENTRY]: [
+        BinaryField.INT,
+        BinaryField.INT,
+        BinaryField.INT,
+        BinaryField.UINT,
+        BinaryField.UINT,
+        BinaryField.DOUBLE,
+        BinaryField.UINT
+    ],
+    [MessagesToDebugger.MESSAGE_TO_DEBUGGER_PROFILER_DATA_END]: [
+        BinaryField.UINT,
+        BinaryField.UINT
+    ]
+};
+
+// Value decoded by BinaryDebuggerRecordReader. Arrays, blobs and JSON
+// objects need the connection state and are turned into values by
+// DebuggerConnectionBase.parseDebuggerValue, like their text forms.
+type BinaryDebuggerValue =
+    | { kind: "value"; value: any }
+    | {
+          kind: "array";
+          arraySize: number;
+          arrayType: number;
+          elementAddresses: number[];
+      }
+    | {
+          kind: "arrayHandle";
+          addr: number;
+          arraySize: number;
+          arrayType: number;
+          hash: number;
+      }
+    | { kind: "blobHandle"; len: number; addr: number; hash: number }
+    | { kind: "json"; id: number };
+
+// Parameter of a message to the debugger: a string from the text protocol
+// or the decoded field from the binary protocol.
+type DebuggerMessageParameter =
+    | string
+    | number
+    | bigint
+    | number[]
+    | Buffer
+    | BinaryDebuggerValue;
+
+function intParameter(parameter: DebuggerMessageParameter) {
+    return typeof parameter == "string"
+        ? parseInt(parameter)
+        : Number(parameter);
+}
+
+function addrParameter(parameter: DebuggerMessageParameter) {
+    return typeof parameter == "string"
+        ? parseInt(parameter, 16)
+        : Number(parameter);
+}
+
+function doubleParameter(parameter: DebuggerMessageParameter) {
+    return typeof parameter == "string"
+        ? Number.parseFloat(parameter)
+        : Number(parameter);
+}
+
+function addrListParameter(parameter: DebuggerMessageParameter) {
+    if (Array.isArray(parameter)) {
+        return parameter;
+    }
+    return parameter
+        ? (parameter as string)
+              .split(",")
+              .map(addressStr => parseInt(addressStr, 16))
+        : [];
+}
+
+function hexDataParameter(parameter: DebuggerMessageParameter) {
+    return Buffer.isBuffer(parameter)
+        ? parameter
+        : Buffer.from(parameter as string, "hex");
+}
+
+const MAX_SAFE_BIGINT = BigInt(Number.MAX_SAFE_INTEGER);
+
+function toSafeNumber(value: bigint) {
+    return value <= MAX_SAFE_BIGINT && value >= -MAX_SAFE_BIGINT
+        ? Number(value)
+        : value;
+}
+
+class BinaryDebuggerRecordReader {
+    constructor(public data: string, public offset: number) {}
+
+    // 64-bit values which don't fit into a number are returned as bigint
+    readVarint(): number | bigint | undefined {
+        let value = 0;
+        let multiplier = 1;
+        while (true) {
+            if (this.offset >= this.data.length) {
+                return undefined;
+            }
+            const byte = this.data.charCodeAt(this.offset++);
+            if (multiplier > 2 ** 46) {
+                return this.readBigVarint(
+                    BigInt(value),
+                    BigInt(multiplier),
+                    byte
+                );
+            }
+            value += (byte & 0x7f) * multiplier;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+            multiplier *= 128;
+        }
+    }
+
+    readBigVarint(value: bigint, multiplier: bigint, byte: number) {
+        while (true) {
+            value += BigInt(byte & 0x7f) * multiplier;
+            if ((byte & 0x80) == 0) {
+                return toSafeNumber(value);
+            }
+            if (this.offset >= this.data.length) {
+                return undefined;
+            }
+            byte = this.data.charCodeAt(this.offset++);
+            multiplier *= BigInt(128);
+        }
+    }
+
+    readUnsigned() {
+        return this.readVarint() ?? 0;
+    }
+
+    readInt() {
+        const value = this.readUnsigned();
+        if (typeof value == "bigint") {
+            return toSafeNumber(
+                value % BigInt(2) == BigInt(0)
+                    ? value / BigInt(2)
+                    : -(value + BigInt(1)) / BigInt(2)
+            );
+        }
+        return value % 2 == 0 ? value / 2 : -(value + 1) / 2;
+    }
+
+    readNumber() {
+        return Number(this.readUnsigned());
+    }
+
+    readBytes(length: number) {
+        const bytes = Buffer.from(
+            this.data.substring(this.offset, this.offset + length),
+            "binary"
+        );
+        this.offset += length;
+        return bytes;
+    }
+
+    readAddr() {
+        return this.readNumber();
+    }
+
+    readAddrs(count: number) {
+        const addrs = new Array<number>(count);
+        for (let i = 0; i < count; i++) {
+            addrs[i] = this.readAddr();
+        }
+        return addrs;
+    }
+
+    readDouble() {
+        return this.readBytes(8).readDoubleLE(0);
+    }
+
+    readFloat() {
+        return this.readBytes(4).readFloatLE(0);
+    }
+
+    readUtf8String() {
+        return this.readBytes(this.readNumber()).toString("utf8");
+    }
+
+    readValue(): BinaryDebuggerValue {
+        const tag = this.readNumber() as BinaryValueTag;
+        switch (tag) {
+            case BinaryValueTag.UNDEFINED:
+                return { kind: "value", value: undefined };
+            case BinaryValueTag.NULL:
+                return { kind: "value", value: null };
+            case BinaryValueTag.FALSE:
+                return { kind: "value", value: false };
+            case BinaryValueTag.TRUE:
+                return { kind: "value", value: true };
+            case BinaryValueTag.INT:
+                return { kind: "value", value: this.readInt() };
+            case BinaryValueTag.UINT:
+                return { kind: "value", value: this.readUnsigned() };
+            case BinaryValueTag.FLOAT:
+                return { kind: "value", value: this.readFloat() };
+            case BinaryValueTag.DOUBLE:
+                return { kind: "value", value: this.readDouble() };
+            case BinaryValueTag.STRING:
+                return { kind: "value", value: this.readUtf8String() };
+            case BinaryValueTag.ARRAY: {
+                this.readAddr();
+                const arraySize = this.readNumber();
+                const arrayType = this.readNumber();
+                const elementAddresses = this.readAddrs(this.readNumber());
+                return {
+                    kind: "array",
+                    arraySize,
+                    arrayType,
+                    elementAddresses
+                };
+            }
+            case BinaryValueTag.BLOB:
+                return {
+                    kind: "value",
+                    value: `blob (size=${this.readNumber()})`
+                };
+            case BinaryValueTag.STREAM:
+                return {
+                    kind: "value",
+                    value: `stream (id=${this.readInt()})`
+                };
+            case BinaryValueTag.JSON:
+                return { kind: "json", id: Number(this.readInt()) };
+            case BinaryValueTag.DATE:
+                return { kind: "value", value: new Date(this.readDouble()) };
+            case BinaryValueTag.POINTER:
+                return { kind: "value", value: this.readAddr() };
+            case BinaryValueTag.WIDGET:
+                return {
+                    kind: "value",
+                    value: `widget (0x${this.readAddr().toString(16)})`
+                };
+            case BinaryValueTag.EVENT:
+                return {
+                    kind: "value",
+                    value: `event (0x${this.readAddr().toString(16)})`
+                };
+            case BinaryValueTag.ARRAY_HANDLE: {
+                const addr = this.readAddr();
+                const arraySize = this.readNumber();
+                const arrayType = this.readNumber();
+                const hash = this.readNumber();
+                return {
+                    kind: "arrayHandle",
+                    addr,
+                    arraySize,
+                    arrayType,
+                    hash
+                };
+            }
+            case BinaryValueTag.BLOB_HANDLE: {
+                const len = this.readNumber();
+                const addr = this.readAddr();
+                const hash = this.readNumber();
+                return { kind: "blobHandle", len, addr, hash };
+            }
+            default:
+                return { kind: "value", value: undefined };
+        }
+    }
+
+    readField(field: BinaryField): DebuggerMessageParameter {
+        switch (field) {
+            case BinaryField.INT:
+                return this.readInt();
+            case BinaryField.UINT:
+                return this.readUnsigned();
+            case BinaryField.ADDR:
+                return this.readAddr();
+            case BinaryField.DOUBLE:
+                return this.readDouble();
+            case BinaryField.VALUE:
+                return this.readValue();
+            case BinaryField.ERROR_MESSAGE:
+            case BinaryField.LOG_MESSAGE:
+                return this.readUtf8String();
+            case BinaryField.ADDR_LIST:
+                return this.readAddrs(this.readNumber());
+            case BinaryField.HEX_DATA:
+                return this.readBytes(this.readNumber());
+            default:
+                return "";
+        }
+    }
+}
+
+function decodeBinaryDebuggerRecord(data: string) {
+    const reader = new BinaryDebuggerRecordReader(data, 0);
+
+    const recordLength = reader.readVarint();
+    if (recordLength == undefined) {
+        return undefined;
+    }
+
+    const recordEnd = reader.offset + Number(recordLength);
+    if (recordEnd > data.length) {
+        return undefined;
+    }
+
+    const messageType = reader.readNumber();
+
+    const messageParameters: DebuggerMessageParameter[] = [messageType];
+    const fields = BINARY_MESSAGE_FIELDS[messageType] ?? [];
+    for (const field of fields) {
+        messageParameters.push(reader.readField(field));
+    }
+
+    return { messageParameters, recordEnd };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+interface PagedDebuggerValue {
+    addr: number;
+    hash: number;
+    value: any;
+    // undefined for blobs
+    type?: AssetsMap["types"][number];
+    requestedPages: Set<number>;
+}
+
 export abstract class DebuggerConnectionBase {
     dataAccumulated: string = "";
+    binaryProtocol: boolean = false;
+    pagedValues = new Map<number, PagedDebuggerValue>();
+    pagedValueAddresses = new WeakMap<any, number>();
+
+    profilerEntries: ProfilerEntry[] = [];
+    profilerDataRequests: ((entries: ProfilerEntry[]) => void)[] = [];
 
     timeoutTimerId: any;
 
@@ -622,17 +1159,24 @@ export abstract class DebuggerConnectionBase {
             .split(",")
             .map(addressStr => parseInt(addressStr, 16));
 
-        const arraySize = addresses[1];
+        return this.createArrayOrStructDebuggerValue(
+            addresses[1],
+            addresses[2],
+            addresses.slice(3)
+        );
+    }
 
-        const arrayType = addresses[2];
+    createArrayOrStructDebuggerValue(
+        arraySize: number,
+        arrayType: number,
+        arrayElementAddresses: number[]
+    ) {
         const type = this.runtime.assetsMap.types[arrayType];
         if (!type) {
             console.error("UNEXPECTED!");
             return undefined;
         }
 
-        const arrayElementAddresses = addresses.slice(3);
-
         let value = observable(
             type.kind == "array" ||
                 (type.kind == "basic" && type.valueType == "array:any")
@@ -640,23 +1184,43 @@ export abstract class DebuggerConnectionBase {
                 : {}
         );
 
+        if (
+            !this.addArrayElementDebuggerValues(
+                value,
+                type,
+                0,
+                arrayElementAddresses
+            )
+        ) {
+            return undefined;
+        }
+
+        return value;
+    }
+
+    addArrayElementDebuggerValues(
+        value: any,
+        type: AssetsMap["types"][number],
+        offset: number,
+        arrayElementAddresses: number[]
+    ) {
         for (let i = 0; i < arrayElementAddresses.length; i++) {
             let propertyName: string | number;
             let propertyType: string;
 
             if (type.kind == "array") {
-                propertyName = i;
+                propertyName = offset + i;
                 propertyType = type.elementType.valueType;
             } else if (type.kind == "object") {
-                const field = type.fields[i];
+                const field = type.fields[offset + i];
                 if (!field) {
                     console.error("UNEXPECTED!");
-                    return undefined;
+                    return false;
                 }
                 propertyName = field.name;
                 propertyType = field.valueType;
             } else {
-                propertyName = i;
+                propertyName = offset + i;
                 propertyType = type.valueType;
             }
 
@@ -675,10 +1239,211 @@ export abstract class DebuggerConnectionBase {
             );
         }
 
-        return value;
+        return true;
+    }
+
+    // Returns the value already received for this handle if the content
+    // hash is the same, otherwise the new value which is filled in as the
+    // pages are received.
+    getPagedValue(
+        addr: number,
+        hash: number,
+        type: AssetsMap["types"][number] | undefined,
+        createValue: () => any
+    ) {
+        let pagedValue = this.pagedValues.get(addr);
+        if (pagedValue) {
+            // most recently used is the last one in the map
+            this.pagedValues.delete(addr);
+        }
+
+        if (
+            !pagedValue ||
+            pagedValue.hash != hash ||
+            pagedValue.type != type
+        ) {
+            pagedValue = {
+                addr,
+                hash,
+                value: createValue(),
+                type,
+                requestedPages: new Set<number>()
+            };
+            this.pagedValueAddresses.set(pagedValue.value, addr);
+        }
+
+        this.pagedValues.set(addr, pagedValue);
+
+        if (this.pagedValues.size > MAX_PAGED_VALUES) {
+            this.pagedValues.delete(this.pagedValues.keys().next().value!);
+        }
+
+        return pagedValue;
+    }
+
+    parsePagedArrayDebuggerValue(str: string) {
+        const [addr, arraySize, arrayType, hash] = str
+            .substring(1, str.length - 1)
+            .split(",")
+            .map(numStr => parseInt(numStr, 16));
+
+        return this.createPagedArrayDebuggerValue(
+            addr,
+            arraySize,
+            arrayType,
+            hash
+        );
+    }
+
+    createPagedArrayDebuggerValue(
+        addr: number,
+        arraySize: number,
+        arrayType: number,
+        hash: number
+    ) {
+        const type = this.runtime.assetsMap.types[arrayType];
+        if (!type) {
+            console.error("UNEXPECTED!");
+            return undefined;
+        }
+
+        const pagedValue = this.getPagedValue(addr, hash, type, () =>
+            observable(type.kind == "object" ? {} : new Array(arraySize))
+        );
+
+        // elements are requested when shown in the Watch panel, all the
+        // fields of the structure are needed for its value
+        this.requestPagedValueRange(
+            pagedValue.value,
+            0,
+            type.kind == "object" ? type.fields.length : DEBUGGER_PAGE_SIZE
+        );
+
+        return pagedValue.value;
+    }
+
+    parseBlobDebuggerValue(str: string) {
+        const [len, addr, hash] = str.substring(1).split(",");
+
+        if (addr == undefined) {
+            return `blob (size=${Number.parseInt(len)})`;
+        }
+
+        return this.createBlobDebuggerValue(
+            Number.parseInt(len),
+            parseInt(addr, 16),
+            parseInt(hash, 16)
+        );
+    }
+
+    createBlobDebuggerValue(len: number, addr: number, hash: number) {
+        // bytes are requested when shown in the Watch panel
+        return this.getPagedValue(addr, hash, undefined, () =>
+            observable(new Array(len))
+        ).value;
+    }
+
+    getJSONDebuggerValue(objID: number) {
+        const wasmModuleId = this.runtime.getWasmModuleId();
+        if (wasmModuleId) {
+            return getJSObjectFromID(objID, wasmModuleId);
+        }
+        return `json (id=${objID})`;
+    }
+
+    binaryDebuggerValue(value: BinaryDebuggerValue) {
+        switch (value.kind) {
+            case "array":
+                return this.createArrayOrStructDebuggerValue(
+                    value.arraySize,
+                    value.arrayType,
+                    value.elementAddresses
+                );
+            case "arrayHandle":
+                return this.createPagedArrayDebuggerValue(
+                    value.addr,
+                    value.arraySize,
+                    value.arrayType,
+                    value.hash
+                );
+            case "blobHandle":
+                return this.createBlobDebuggerValue(
+                    value.len,
+                    value.addr,
+                    value.hash
+                );
+            case "json":
+                return this.getJSONDebuggerValue(value.id);
+            default:
+                return value.value;
+        }
+    }
+
+    isPagedValue(value: any) {
+        return this.pagedValueAddresses.has(value);
+    }
+
+    requestPagedValueRange(value: any, offset: number, count: number) {
+        const addr = this.pagedValueAddresses.get(value);
+        if (addr == undefined) {
+            return;
+        }
+
+        const pagedValue = this.pagedValues.get(addr);
+        if (!pagedValue || pagedValue.value !== value) {
+            // evicted or replaced by the newer content
+            return;
+        }
+
+        const pageSize = pagedValue.type
+            ? DEBUGGER_PAGE_SIZE
+            : DEBUGGER_BLOB_PAGE_SIZE;
+
+        for (
+            let page = Math.floor(offset / pageSize);
+            page * pageSize < offset + count;
+            page++
+        ) {
+            if (!pagedValue.requestedPages.has(page)) {
+                pagedValue.requestedPages.add(page);
+                if (pagedValue.type) {
+                    this.requestArrayPage(addr, page * pageSize, pageSize);
+                } else {
+                    this.requestBlobPage(addr, page * pageSize, pageSize);
+                }
+            }
+        }
     }
 
-    parseDebuggerValue(str: string) {
+    requestArrayPage(
+        addr: number,
+        offset: number,
+        count: number = DEBUGGER_PAGE_SIZE
+    ) {
+        this.sendMessageFromDebugger(
+            `${
+                MessagesFromDebugger.MESSAGE_FROM_DEBUGGER_REQUEST_ARRAY_PAGE
+            }\t${addr.toString(16)}\t${offset}\t${count}\n`
+        );
+    }
+
+    requestBlobPage(
+        addr: number,
+        offset: number,
+        count: number = DEBUGGER_BLOB_PAGE_SIZE
+    ) {
+        this.sendMessageFromDebugger(
+            `${
+                MessagesFromDebugger.MESSAGE_FROM_DEBUGGER_REQUEST_BLOB_PAGE
+            }\t${addr.toString(16)}\t${offset}\t${count}\n`
+        );
+    }
+
+    parseDebuggerValue(str: DebuggerMessageParameter) {
+        if (typeof str != "string") {
+            return this.binaryDebuggerValue(str as BinaryDebuggerValue);
+        }
+
         if (str == "undefined") {
             return undefined;
         }
@@ -708,8 +1473,12 @@ export abstract class DebuggerConnectionBase {
             return this.parseArrayOrStructDebuggerValue(str);
         }
 
+        if (str[0] == "[") {
+            return this.parsePagedArrayDebuggerValue(str);
+        }
+
         if (str[0] == "@") {
-            return `blob (size=${Number.parseInt(str.substring(1))})`;
+            return this.parseBlobDebuggerValue(str);
         }
 
         if (str[0] == ">") {
@@ -717,12 +1486,9 @@ export abstract class DebuggerConnectionBase {
         }
 
         if (str[0] == "#") {
-            const objID = Number.parseInt(str.substring(1));
-            const wasmModuleId = this.runtime.getWasmModuleId();
-            if (wasmModuleId) {
-                return getJSObjectFromID(objID, wasmModuleId);
-            }
-            return `json (id=${Number.parseInt(str.substring(1))})`;
+            return this.getJSONDebuggerValue(
+                Number.parseInt(str.substring(1))
+            );
         }
 
         if (str[0] == "*") {
@@ -771,28 +1537,83 @@ export abstract class DebuggerConnectionBase {
     }
 
     onConnected() {
+        this.binaryProtocol = false;
+        this.pagedValues.clear();
+        this.profilerEntries = [];
         this.runtime.onDebuggerActiveChanged();
     }
 
+    requestBinaryProtocol() {
+        this.sendMessageFromDebugger(
+            `${MessagesFromDebugger.MESSAGE_FROM_DEBUGGER_PROTOCOL}\t${DEBUGGER_PROTOCOL_BINARY}\n`
+        );
+    }
+
+    requestCoalescing() {
+        this.sendMessageFromDebugger(
+            `${MessagesFromDebugger.MESSAGE_FROM_DEBUGGER_COALESCE}\t${DEBUGGER_COALESCE_MAX_UPDATES_PER_SECOND}\n`
+        );
+    }
+
+    setProfilerMode(mode: ProfilerMode, samplingPeriod: number = 16) {
+        this.sendMessageFromDebugger(
+            `${MessagesFromDebugger.MESSAGE_FROM_DEBUGGER_PROFILER}\t${mode}\t${samplingPeriod}\n`
+        );
+    }
+
+    requestProfilerData() {
+        return new Promise<ProfilerEntry[]>(resolve => {
+            this.profilerDataRequests.push(resolve);
+            if (this.profilerDataRequests.length == 1) {
+                this.sendMessageFromDebugger(
+                    `${MessagesFromDebugger.MESSAGE_FROM_DEBUGGER_REQUEST_PROFILER_DATA}\n`
+                );
+            }
+        });
+    }
+
+    requestPagedValues() {
+        this.sendMessageFromDebugger(
+            `${MessagesFromDebugger.MESSAGE_FROM_DEBUGGER_PAGED_VALUES}\t${DEBUGGER_PAGE_SIZE}\n`
+        );
+    }
+
     counter = 0;
 
     onMessageToDebugger(data: string) {
         this.dataAccumulated += data;
 
         while (true) {
-            const newLineIndex = this.dataAccumulated.indexOf("\n");
-            if (newLineIndex == -1) {
-                break;
-            }
+            let messageParameters: DebuggerMessageParameter[];
 
-            const message = this.dataAccumulated.substring(0, newLineIndex);
-            this.dataAccumulated = this.dataAccumulated.substr(
-                newLineIndex + 1
-            );
+            if (this.binaryProtocol) {
+                const record = decodeBinaryDebuggerRecord(this.dataAccumulated);
+                if (!record) {
+                    break;
+                }
 
-            const messageParameters = message.split("\t");
+                messageParameters = record.messageParameters;
+                this.dataAccumulated = this.dataAccumulated.substr(
+                    record.recordEnd
+                );
+            } else {
+                const newLineIndex = this.dataAccumulated.indexOf("\n");
+                if (newLineIndex == -1) {
+                    break;
+                }
 
-            const messageType = parseInt(
+                const message = this.dataAccumulated.substring(
+                    0,
+                    newLineIndex
+                );
+                this.dataAccumulated = this.dataAccumulated.substr(
+                    newLineIndex + 1
+                );
+
+                messageParameters = message.split("\t");
+            }
+
+            const messageType = intParameter(
                 messageParameters[0]
             ) as MessagesToDebugger;
 
@@ -801,7 +1622,7 @@ export abstract class DebuggerConnectionBase {
             switch (messageType) {
                 case MessagesToDebugger.MESSAGE_TO_DEBUGGER_STATE_CHANGED:
                     {
-                        const state = parseInt(messageParameters[1]);
+                        const state = intParameter(messageParameters[1]);
 
                         if (state == DEBUGGER_STATE_RESUMED) {
                             if (runtime.transitionToRunningMode) {
@@ -829,23 +1650,27 @@ export abstract class DebuggerConnectionBase {
 
                 case MessagesToDebugger.MESSAGE_TO_DEBUGGER_ADD_TO_QUEUE:
                     {
-                        const flowStateIndex = parseInt(messageParameters[1]);
-                        const sourceComponentIndex = parseInt(
+                        const flowStateIndex = intParameter(
+                            messageParameters[1]
+                        );
+                        const sourceComponentIndex = intParameter(
                             messageParameters[2]
                         );
-                        const sourceOutputIndex = parseInt(
+                        const sourceOutputIndex = intParameter(
                             messageParameters[3]
                         );
-                        const targetComponentIndex = parseInt(
+                        const targetComponentIndex = intParameter(
                             messageParameters[4]
                         );
-                        const targetInputIndex = parseInt(messageParameters[5]);
+                        const targetInputIndex = intParameter(
+                            messageParameters[5]
+                        );
 
                         runInAction(() => {
-                            this.runtime.freeMemory = parseInt(
+                            this.runtime.freeMemory = intParameter(
                                 messageParameters[6]
                             );
-                            this.runtime.totalMemory = parseInt(
+                            this.runtime.totalMemory = intParameter(
                                 messageParameters[7]
                             );
                         });
@@ -976,10 +1801,12 @@ export abstract class DebuggerConnectionBase {
                         //     messageParameters
                         // );
 
-                        const globalVariableIndex = parseInt(
+                        const globalVariableIndex = intParameter(
                             messageParameters[1]
                         );
-                        const valueAddress = parseInt(messageParameters[2], 16);
+                        const valueAddress = addrParameter(
+                            messageParameters[2]
+                        );
                         const value = messageParameters[3];
 
                         const globalVariableInAssetsMap =
@@ -1030,11 +1857,15 @@ export abstract class DebuggerConnectionBase {
                         //     messageParameters
                         // );
 
-                        const flowStateIndex = parseInt(messageParameters[1]);
-                        const localVariableIndex = parseInt(
+                        const flowStateIndex = intParameter(
+                            messageParameters[1]
+                        );
+                        const localVariableIndex = intParameter(
                             messageParameters[2]
                         );
-                        const valueAddress = parseInt(messageParameters[3], 16);
+                        const valueAddress = addrParameter(
+                            messageParameters[3]
+                        );
                         const value = messageParameters[4];
 
                         const { flowIndex, flowState } =
@@ -1099,11 +1930,15 @@ export abstract class DebuggerConnectionBase {
                         //     messageParameters
                         // );
 
-                        const flowStateIndex = parseInt(messageParameters[1]);
-                        const componentInputIndex = parseInt(
+                        const flowStateIndex = intParameter(
+                            messageParameters[1]
+                        );
+                        const componentInputIndex = intParameter(
                             messageParameters[2]
                         );
-                        const valueAddress = parseInt(messageParameters[3], 16);
+                        const valueAddress = addrParameter(
+                            messageParameters[3]
+                        );
                         const value = messageParameters[4];
 
                         const { flowIndex, flowState } =
@@ -1174,7 +2009,9 @@ export abstract class DebuggerConnectionBase {
 
                 case MessagesToDebugger.MESSAGE_TO_DEBUGGER_VALUE_CHANGED:
                     {
-                        const valueAddress = parseInt(messageParameters[1], 16);
+                        const valueAddress = addrParameter(
+                            messageParameters[1]
+                        );
                         const value = messageParameters[2];
 
                         const debuggerValueArr =
@@ -1196,14 +2033,44 @@ export abstract class DebuggerConnectionBase {
                     }
                     break;
 
+                case MessagesToDebugger.MESSAGE_TO_DEBUGGER_VALUES_CHANGED:
+                    {
+                        const valueAddresses = addrListParameter(
+                            messageParameters[1]
+                        );
+                        const value = messageParameters[2];
+
+                        const parsedValue = this.parseDebuggerValue(value);
+
+                        for (const valueAddress of valueAddresses) {
+                            const debuggerValueArr =
+                                runtime.debuggerValues.get(valueAddress);
+                            if (!debuggerValueArr) {
+                                console.log(
+                                    "MESSAGE_TO_DEBUGGER_VALUES_CHANGED",
+                                    messageParameters
+                                );
+                                console.error("UNEXPECTED!");
+                                return;
+                            }
+
+                            debuggerValueArr.forEach(debuggerValue =>
+                                debuggerValue.set(parsedValue)
+                            );
+                        }
+                    }
+                    break;
+
                 case MessagesToDebugger.MESSAGE_TO_DEBUGGER_FLOW_STATE_CREATED:
                     {
-                        const flowStateIndex = parseInt(messageParameters[1]);
-                        const flowIndex = parseInt(messageParameters[2]);
-                        const parentFlowStateIndex = parseInt(
+                        const flowStateIndex = intParameter(
+                            messageParameters[1]
+                        );
+                        const flowIndex = intParameter(messageParameters[2]);
+                        const parentFlowStateIndex = intParameter(
                             messageParameters[3]
                         );
-                        const parentComponentIndex = parseInt(
+                        const parentComponentIndex = intParameter(
                             messageParameters[4]
                         );
 
@@ -1306,8 +2173,10 @@ export abstract class DebuggerConnectionBase {
 
                 case MessagesToDebugger.MESSAGE_TO_DEBUGGER_FLOW_STATE_TIMELINE_CHANGED:
                     {
-                        const flowStateIndex = parseInt(messageParameters[1]);
-                        const timelinePosition = parseFloat(
+                        const flowStateIndex = intParameter(
+                            messageParameters[1]
+                        );
+                        const timelinePosition = doubleParameter(
                             messageParameters[2]
                         );
 
@@ -1333,7 +2202,9 @@ export abstract class DebuggerConnectionBase {
 
                 case MessagesToDebugger.MESSAGE_TO_DEBUGGER_FLOW_STATE_DESTROYED:
                     {
-                        const flowStateIndex = parseInt(messageParameters[1]);
+                        const flowStateIndex = intParameter(
+                            messageParameters[1]
+                        );
 
                         // console.log(
                         //     "MESSAGE_TO_DEBUGGER_FLOW_STATE_DESTROYED",
@@ -1358,14 +2229,22 @@ export abstract class DebuggerConnectionBase {
 
                 case MessagesToDebugger.MESSAGE_TO_DEBUGGER_FLOW_STATE_ERROR:
                     {
-                        const flowStateIndex = parseInt(messageParameters[1]);
-                        const componentIndex = parseInt(messageParameters[2]);
-                        const errorMessage = this.parseStringDebuggerValue(
-                            messageParameters[3].substr(
-                                1,
-                                messageParameters[3].length - 2
-                            )
+                        const flowStateIndex = intParameter(
+                            messageParameters[1]
                         );
+                        const componentIndex = intParameter(
+                            messageParameters[2]
+                        );
+                        const errorMessageParameter =
+                            messageParameters[3] as string;
+                        const errorMessage = this.binaryProtocol
+                            ? errorMessageParameter
+                            : this.parseStringDebuggerValue(
+                                  errorMessageParameter.substr(
+                                      1,
+                                      errorMessageParameter.length - 2
+                                  )
+                              );
 
                         runInAction(() => {
                             runtime.error = errorMessage;
@@ -1414,10 +2293,14 @@ export abstract class DebuggerConnectionBase {
 
                 case MessagesToDebugger.MESSAGE_TO_DEBUGGER_LOG:
                     {
-                        const logItemType = parseInt(messageParameters[1]);
-                        const flowStateIndex = parseInt(messageParameters[2]);
-                        const componentIndex = parseInt(messageParameters[3]);
-                        const message = messageParameters[4];
+                        const logItemType = intParameter(messageParameters[1]);
+                        const flowStateIndex = intParameter(
+                            messageParameters[2]
+                        );
+                        const componentIndex = intParameter(
+                            messageParameters[3]
+                        );
+                        const message = messageParameters[4] as string;
 
                         const { flowIndex, flowState } =
                             this.getFlowState(flowStateIndex);
@@ -1472,7 +2355,7 @@ export abstract class DebuggerConnectionBase {
 
                 case MessagesToDebugger.MESSAGE_TO_DEBUGGER_PAGE_CHANGED:
                     {
-                        let pageId = parseInt(messageParameters[1]);
+                        let pageId = intParameter(messageParameters[1]);
 
                         if (pageId < 0) {
                             pageId = -pageId;
@@ -1505,11 +2388,14 @@ export abstract class DebuggerConnectionBase {
 
                 case MessagesToDebugger.MESSAGE_TO_DEBUGGER_COMPONENT_EXECUTION_STATE_CHANGED:
                     {
-                        const flowStateIndex = parseInt(messageParameters[1]);
-                        const componentIndex = parseInt(messageParameters[2]);
-                        const executionState = parseInt(
-                            messageParameters[3],
-                            16
+                        const flowStateIndex = intParameter(
+                            messageParameters[1]
+                        );
+                        const componentIndex = intParameter(
+                            messageParameters[2]
+                        );
+                        const executionState = addrParameter(
+                            messageParameters[3]
                         );
 
                         const { flowIndex, flowState } =
@@ -1569,9 +2455,13 @@ export abstract class DebuggerConnectionBase {
 
                 case MessagesToDebugger.MESSAGE_TO_DEBUGGER_COMPONENT_ASYNC_STATE_CHANGED:
                     {
-                        const flowStateIndex = parseInt(messageParameters[1]);
-                        const componentIndex = parseInt(messageParameters[2]);
-                        const asyncState = parseInt(messageParameters[3]);
+                        const flowStateIndex = intParameter(
+                            messageParameters[1]
+                        );
+                        const componentIndex = intParameter(
+                            messageParameters[2]
+                        );
+                        const asyncState = intParameter(messageParameters[3]);
 
                         const { flowIndex, flowState } =
                             this.getFlowState(flowStateIndex);
@@ -1609,6 +2499,101 @@ export abstract class DebuggerConnectionBase {
                         );
                     }
                     break;
+
+                case MessagesToDebugger.MESSAGE_TO_DEBUGGER_PROTOCOL_CHANGED:
+                    {
+                        const protocol = intParameter(messageParameters[1]);
+                        this.binaryProtocol =
+                            protocol == DEBUGGER_PROTOCOL_BINARY;
+                    }
+                    break;
+
+                case MessagesToDebugger.MESSAGE_TO_DEBUGGER_QUEUE_STATS:
+                    {
+                        runInAction(() => {
+                            this.runtime.freeMemory = intParameter(
+                                messageParameters[3]
+                            );
+                            this.runtime.totalMemory = intParameter(
+                                messageParameters[4]
+                            );
+                        });
+                    }
+                    break;
+
+                case MessagesToDebugger.MESSAGE_TO_DEBUGGER_QUEUE_RESET:
+                    {
+                        runInAction(() =>
+                            runtime.queue.splice(0, runtime.queue.length)
+                        );
+                    }
+                    break;
+
+                case MessagesToDebugger.MESSAGE_TO_DEBUGGER_ARRAY_PAGE:
+                    {
+                        const arrayAddress = addrParameter(
+                            messageParameters[1]
+                        );
+                        const offset = intParameter(messageParameters[2]);
+                        const arrayElementAddresses = addrListParameter(
+                            messageParameters[3]
+                        );
+
+                        // could be evicted since requested
+                        const pagedValue = this.pagedValues.get(arrayAddress);
+                        if (pagedValue && pagedValue.type) {
+                            this.addArrayElementDebuggerValues(
+                                pagedValue.value,
+                                pagedValue.type,
+                                offset,
+                                arrayElementAddresses
+                            );
+                        }
+                    }
+                    break;
+
+                case MessagesToDebugger.MESSAGE_TO_DEBUGGER_BLOB_PAGE:
+                    {
+                        const blobAddress = addrParameter(messageParameters[1]);
+                        const offset = intParameter(messageParameters[2]);
+                        const data = hexDataParameter(messageParameters[3]);
+
+                        // could be evicted since requested
+                        const pagedValue = this.pagedValues.get(blobAddress);
+                        if (pagedValue && !pagedValue.type) {
+                            const bytes = pagedValue.value;
+                            runInAction(() => {
+                                for (let i = 0; i < data.length; i++) {
+                                    bytes[offset + i] = data[i];
+                                }
+                            });
+                        }
+                    }
+                    break;
+
+                case MessagesToDebugger.MESSAGE_TO_DEBUGGER_PROFILER_ENTRY:
+                    {
+                        this.profilerEntries.push({
+                            flowIndex: intParameter(messageParameters[1]),
+                            componentIndex: intParameter(messageParameters[2]),
+                            propertyIndex: intParameter(messageParameters[3]),
+                            count: intParameter(messageParameters[4]),
+                            sampledCount: intParameter(messageParameters[5]),
+                            sampledTime: doubleParameter(messageParameters[6]),
+                            sampledAllocs: intParameter(messageParameters[7])
+                        });
+                    }
+                    break;
+
+                case MessagesToDebugger.MESSAGE_TO_DEBUGGER_PROFILER_DATA_END:
+                    {
+                        const entries = this.profilerEntries;
+                        const requests = this.profilerDataRequests;
+                        this.profilerEntries = [];
+                        this.profilerDataRequests = [];
+                        requests.forEach(resolve => resolve(entries));
+                    }
+                    break;
             }
         }
     }
@@ -1667,6 +2652,9 @@ class SocketDebuggerConnection extends DebuggerConnectionBase {
                 connectionParameters.ethernetParameters.address,
                 () => {
                     this.onConnected();
+                    this.requestBinaryProtocol();
+                    this.requestCoalescing();
+                    this.requestPagedValues();
                     if (!this.runtime.isDebuggerActive) {
                         this.runtime.resume();
                     }
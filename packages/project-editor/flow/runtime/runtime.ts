@@ -43,6 +43,7 @@ import {
     IExpressionContext
 } from "project-editor/flow/expression";
 import type {
+    IFrameStats,
     IObjectVariableValue,
     ValueType,
     ValueWithType
@@ -114,6 +115,9 @@ export abstract class RuntimeBase implements IRuntime {
     freeMemory: number = 0;
     totalMemory: number = 0;
 
+    // render time statistics, only from the simulator
+    frameStats: IFrameStats | undefined = undefined;
+
     isRTL: boolean = false;
 
     get isPaused() {
@@ -183,6 +187,7 @@ export abstract class RuntimeBase implements IRuntime {
             showNextQueueTask: action,
             freeMemory: observable,
             totalMemory: observable,
+            frameStats: observable.ref,
             isRTL: observable
         });
 
@@ -569,6 +574,15 @@ export abstract class RuntimeBase implements IRuntime {
 
     abstract destroyObjectLocalVariables(flowState: FlowState): void;
 
+    // Large arrays and blobs are transferred from the debugger in pages,
+    // see RemoteRuntime. Returns the number of elements shown per page or
+    // undefined if the value is not paged.
+    getDebuggerValuePageSize(value: any): number | undefined {
+        return undefined;
+    }
+
+    requestDebuggerValuePage(value: any, offset: number, count: number) {}
+
     get debugInfo() {
         return {
             state: this.state,
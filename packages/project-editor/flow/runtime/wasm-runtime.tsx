@@ -34,12 +34,16 @@ import type {
     RendererToWorkerMessage
 } from "project-editor/flow/runtime/wasm-worker-interfaces";
 
+import { pasteScreenRect } from "project-editor/flow/runtime/wasm-screen";
+
 import type {
     ScpiCommand,
     WorkerToRenderMessage,
     IPropertyValue,
     ValueWithType,
-    AssetsMap
+    AssetsMap,
+    IScreenRect,
+    IScreenUpdate
 } from "eez-studio-types";
 
 import {
@@ -142,6 +146,7 @@ export class WasmRuntime extends RemoteRuntime {
 
     keysPressed: number[] = [];
     screen: any;
+    screenUpdates: IScreenUpdate[] | undefined;
     lastScreen: any;
 
     mainLoopTimeoutId: any;
@@ -553,6 +558,7 @@ export class WasmRuntime extends RemoteRuntime {
             }
 
             this.screen = workerToRenderMessage.screen;
+            this.screenUpdates = workerToRenderMessage.screenUpdates;
 
             runInAction(() => {
                 if (
@@ -561,6 +567,10 @@ export class WasmRuntime extends RemoteRuntime {
                 ) {
                     this.isRTL = workerToRenderMessage.isRTL ? true : false;
                 }
+
+                if (workerToRenderMessage.frameStats) {
+                    this.frameStats = workerToRenderMessage.frameStats;
+                }
             });
 
             this.requestAnimationFrameId = window.requestAnimationFrame(
@@ -604,6 +614,16 @@ export class WasmRuntime extends RemoteRuntime {
         if (this.screen) {
             this.lastScreen = this.screen;
             this.updateCanvasContext();
+        } else if (this.screenUpdates && this.lastScreen) {
+            for (const screenUpdate of this.screenUpdates) {
+                pasteScreenRect(
+                    this.lastScreen,
+                    this.displayWidth,
+                    screenUpdate,
+                    screenUpdate.data
+                );
+            }
+            this.updateCanvasContext(this.screenUpdates);
         }
 
         const message: RendererToWorkerMessage = {
@@ -634,7 +654,7 @@ export class WasmRuntime extends RemoteRuntime {
         this.updateCanvasContext();
     }
 
-    updateCanvasContext() {
+    updateCanvasContext(rects?: IScreenRect[]) {
         if (!this.lastScreen || !this.ctx) {
             return;
         }
@@ -650,16 +670,37 @@ export class WasmRuntime extends RemoteRuntime {
         const width = this.selectedPage.width;
         const height = this.selectedPage.height;
 
-        this.ctx.clearRect(0, 0, this.displayWidth, this.displayHeight);
-        this.ctx.putImageData(
-            imgData,
-            this.isDebuggerActive ? 0 : left + (this.displayWidth - width) / 2,
-            this.isDebuggerActive ? 0 : top + (this.displayHeight - height) / 2,
-            left,
-            top,
-            width,
-            height
-        );
+        const dx = this.isDebuggerActive
+            ? 0
+            : left + (this.displayWidth - width) / 2;
+        const dy = this.isDebuggerActive
+            ? 0
+            : top + (this.displayHeight - height) / 2;
+
+        if (!rects) {
+            this.ctx.clearRect(0, 0, this.displayWidth, this.displayHeight);
+            this.ctx.putImageData(imgData, dx, dy, left, top, width, height);
+            return;
+        }
+
+        // only the changed parts, clipped to the page
+        for (const rect of rects) {
+            const x1 = Math.max(rect.x, left);
+            const y1 = Math.max(rect.y, top);
+            const x2 = Math.min(rect.x + rect.width, left + width);
+            const y2 = Math.min(rect.y + rect.height, top + height);
+            if (x1 < x2 && y1 < y2) {
+                this.ctx.putImageData(
+                    imgData,
+                    dx,
+                    dy,
+                    x1,
+                    y1,
+                    x2 - x1,
+                    y2 - y1
+                );
+            }
+        }
     }
 
     ////////////////////////////////////////////////////////////////////////////////
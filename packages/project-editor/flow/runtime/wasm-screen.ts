@@ -0,0 +1,120 @@
+import type {
+    IFrameStats,
+    IScreenRect,
+    IWasmFlowRuntime
+} from "eez-studio-types";
+
+// Displays with more pixels than this render through two partial draw buffers
+// of 1/LARGE_DISPLAY_DRAW_BUFFER_DIVISOR of the screen instead of one full
+// screen buffer.
+export const LARGE_DISPLAY_PIXELS = 800 * 480;
+export const LARGE_DISPLAY_DRAW_BUFFER_DIVISOR = 10;
+
+export function setDrawBufferDivisor(
+    wasm: IWasmFlowRuntime,
+    displayWidth: number,
+    displayHeight: number
+) {
+    if (
+        wasm._setDrawBufferDivisor &&
+        displayWidth * displayHeight > LARGE_DISPLAY_PIXELS
+    ) {
+        wasm._setDrawBufferDivisor(LARGE_DISPLAY_DRAW_BUFFER_DIVISOR);
+    }
+}
+
+// How often the worker sends render time statistics to the renderer (ms).
+export const FRAME_STATS_INTERVAL = 500;
+
+// Render time statistics, undefined if the runtime doesn't collect them.
+export function getFrameStats(
+    wasm: IWasmFlowRuntime
+): IFrameStats | undefined {
+    if (!wasm._getFrameStats) {
+        return undefined;
+    }
+
+    const ptr = wasm._getFrameStats() >> 3;
+
+    return {
+        frames: wasm.HEAPF64[ptr + 0],
+        lastTime: wasm.HEAPF64[ptr + 1],
+        avgTime: wasm.HEAPF64[ptr + 2],
+        maxTime: wasm.HEAPF64[ptr + 3],
+        lastFlushes: wasm.HEAPF64[ptr + 4],
+        lastPixels: wasm.HEAPF64[ptr + 5],
+        drawBufferSize: wasm.HEAPF64[ptr + 6],
+        numDrawBuffers: wasm.HEAPF64[ptr + 7]
+    };
+}
+
+// Rectangles changed in the buffer returned by the last non-zero
+// _getSyncedBuffer() call. Runtimes without dirty rectangle tracking
+// report the whole screen.
+export function getSyncedDirtyRects(
+    wasm: IWasmFlowRuntime,
+    displayWidth: number,
+    displayHeight: number
+): IScreenRect[] {
+    if (!wasm._getSyncedDirtyRectsCount || !wasm._getSyncedDirtyRects) {
+        return [{ x: 0, y: 0, width: displayWidth, height: displayHeight }];
+    }
+
+    const count = wasm._getSyncedDirtyRectsCount();
+    const ptr = wasm._getSyncedDirtyRects() >> 2;
+
+    const rects: IScreenRect[] = [];
+    for (let i = 0; i < count; i++) {
+        rects.push({
+            x: wasm.HEAP32[ptr + 4 * i + 0],
+            y: wasm.HEAP32[ptr + 4 * i + 1],
+            width: wasm.HEAP32[ptr + 4 * i + 2],
+            height: wasm.HEAP32[ptr + 4 * i + 3]
+        });
+    }
+    return rects;
+}
+
+export function isFullScreenRect(
+    rects: IScreenRect[],
+    displayWidth: number,
+    displayHeight: number
+) {
+    return (
+        rects.length == 1 &&
+        rects[0].x == 0 &&
+        rects[0].y == 0 &&
+        rects[0].width == displayWidth &&
+        rects[0].height == displayHeight
+    );
+}
+
+// Copies rectangle pixels out of a full screen RGBA buffer.
+export function copyScreenRect(
+    screen: Uint8Array | Uint8ClampedArray,
+    displayWidth: number,
+    rect: IScreenRect
+) {
+    const data = new Uint8ClampedArray(rect.width * rect.height * 4);
+    const rowSize = rect.width * 4;
+    for (let row = 0; row < rect.height; row++) {
+        const offset = ((rect.y + row) * displayWidth + rect.x) * 4;
+        data.set(screen.subarray(offset, offset + rowSize), row * rowSize);
+    }
+    return data;
+}
+
+// Writes rectangle pixels, as returned by copyScreenRect, back into
+// a full screen RGBA buffer.
+export function pasteScreenRect(
+    screen: Uint8ClampedArray,
+    displayWidth: number,
+    rect: IScreenRect,
+    data: Uint8ClampedArray
+) {
+    const rowSize = rect.width * 4;
+    for (let row = 0; row < rect.height; row++) {
+        const offset = ((rect.y + row) * displayWidth + rect.x) * 4;
+        screen.set(data.subarray(row * rowSize, (row + 1) * rowSize), offset);
+    }
+}
@@ -19,6 +19,14 @@ import {
 } from "project-editor/flow/runtime/wasm-value";
 
 import { DashboardComponentContext } from "project-editor/flow/runtime/worker-dashboard-component-context";
+import {
+    getSyncedDirtyRects,
+    isFullScreenRect,
+    copyScreenRect,
+    setDrawBufferDivisor,
+    getFrameStats,
+    FRAME_STATS_INTERVAL
+} from "project-editor/flow/runtime/wasm-screen";
 
 import { isArray } from "eez-studio-shared/util";
 import { getLvglWasmFlowRuntimeConstructor } from "project-editor/lvgl/lvgl-versions";
@@ -698,6 +706,64 @@ function lvglOnEventHandler(
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// must be the same as in lvgl-runtime/common/main.c
+const INPUT_EVENT_POINTER = 1;
+const INPUT_EVENT_KEY = 2;
+const INPUT_EVENT_WHEEL = 3;
+const INPUT_EVENT_SIZE = 4;
+
+// Sends all input events collected by the renderer since the last message
+// with a single _onInputEvents call.
+function sendInputEvents(
+    WasmFlowRuntime: IWasmFlowRuntime,
+    rendererToWorkerMessage: RendererToWorkerMessage
+) {
+    const events: number[] = [];
+
+    if (
+        rendererToWorkerMessage.wheel &&
+        rendererToWorkerMessage.wheel.updated
+    ) {
+        events.push(
+            INPUT_EVENT_WHEEL,
+            Math.round(rendererToWorkerMessage.wheel.deltaY),
+            rendererToWorkerMessage.wheel.pressed,
+            0
+        );
+    }
+
+    if (rendererToWorkerMessage.pointerEvents) {
+        for (const pointerEvent of rendererToWorkerMessage.pointerEvents) {
+            events.push(
+                INPUT_EVENT_POINTER,
+                pointerEvent.x,
+                pointerEvent.y,
+                pointerEvent.pressed
+            );
+        }
+    }
+
+    if (rendererToWorkerMessage.keysPressed) {
+        for (const key of rendererToWorkerMessage.keysPressed) {
+            events.push(INPUT_EVENT_KEY, key, 0, 0);
+        }
+    }
+
+    if (events.length == 0) {
+        return;
+    }
+
+    const eventsPtr = WasmFlowRuntime._malloc(events.length * 4);
+    WasmFlowRuntime.HEAP32.set(events, eventsPtr >> 2);
+    WasmFlowRuntime._onInputEvents!(
+        eventsPtr,
+        events.length / INPUT_EVENT_SIZE
+    );
+    WasmFlowRuntime._free(eventsPtr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 export function createWasmWorker(
     wasmModuleId: number,
     debuggerMessageSubsciptionFilter: number,
@@ -745,6 +811,9 @@ export function createWasmWorker(
 
     wasmFlowRuntimes.set(wasmModuleId, WasmFlowRuntime);
 
+    let screenSent = false;
+    let frameStatsTime = 0;
+
     function initObjectGlobalVariableValues(
         WasmFlowRuntime: IWasmFlowRuntime,
         globalVariables: IGlobalVariable[]
@@ -943,6 +1012,8 @@ export function createWasmWorker(
             var ptr = WasmFlowRuntime._malloc(assets.length);
             WasmFlowRuntime.HEAPU8.set(assets, ptr);
 
+            setDrawBufferDivisor(WasmFlowRuntime, displayWidth, displayHeight);
+
             WasmFlowRuntime._init(
                 wasmModuleId,
                 debuggerMessageSubsciptionFilter,
@@ -963,38 +1034,43 @@ export function createWasmWorker(
             );
         }
 
-        if (rendererToWorkerMessage.wheel) {
-            if (rendererToWorkerMessage.wheel.updated) {
-                WasmFlowRuntime._onMouseWheelEvent(
-                    rendererToWorkerMessage.wheel.deltaY,
-                    rendererToWorkerMessage.wheel.pressed
-                );
+        if (WasmFlowRuntime._onInputEvents) {
+            sendInputEvents(WasmFlowRuntime, rendererToWorkerMessage);
+        } else {
+            if (rendererToWorkerMessage.wheel) {
+                if (rendererToWorkerMessage.wheel.updated) {
+                    WasmFlowRuntime._onMouseWheelEvent(
+                        rendererToWorkerMessage.wheel.deltaY,
+                        rendererToWorkerMessage.wheel.pressed
+                    );
+                }
             }
-        }
 
-        if (rendererToWorkerMessage.pointerEvents) {
-            for (
-                let i = 0;
-                i < rendererToWorkerMessage.pointerEvents.length;
-                i++
-            ) {
-                const pointerEvent = rendererToWorkerMessage.pointerEvents[i];
-                WasmFlowRuntime._onPointerEvent(
-                    pointerEvent.x,
-                    pointerEvent.y,
-                    pointerEvent.pressed
-                );
+            if (rendererToWorkerMessage.pointerEvents) {
+                for (
+                    let i = 0;
+                    i < rendererToWorkerMessage.pointerEvents.length;
+                    i++
+                ) {
+                    const pointerEvent =
+                        rendererToWorkerMessage.pointerEvents[i];
+                    WasmFlowRuntime._onPointerEvent(
+                        pointerEvent.x,
+                        pointerEvent.y,
+                        pointerEvent.pressed
+                    );
+                }
             }
-        }
 
-        if (rendererToWorkerMessage.keysPressed) {
-            for (
-                let i = 0;
-                i < rendererToWorkerMessage.keysPressed.length;
-                i++
-            ) {
-                const key = rendererToWorkerMessage.keysPressed[i];
-                WasmFlowRuntime._onKeyPressed(key);
+            if (rendererToWorkerMessage.keysPressed) {
+                for (
+                    let i = 0;
+                    i < rendererToWorkerMessage.keysPressed.length;
+                    i++
+                ) {
+                    const key = rendererToWorkerMessage.keysPressed[i];
+                    WasmFlowRuntime._onKeyPressed(key);
+                }
             }
         }
 
@@ -1083,19 +1159,42 @@ export function createWasmWorker(
 
         var buf_addr = WasmFlowRuntime._getSyncedBuffer();
         if (buf_addr != 0) {
-            workerToRenderMessage.screen = new Uint8ClampedArray(
-                WasmFlowRuntime.HEAPU8.subarray(
-                    buf_addr,
-                    buf_addr +
-                        WasmFlowRuntime.assetsMap.displayWidth *
-                            WasmFlowRuntime.assetsMap.displayHeight *
-                            4
-                )
+            const displayWidth = WasmFlowRuntime.assetsMap.displayWidth;
+            const displayHeight = WasmFlowRuntime.assetsMap.displayHeight;
+
+            const screen = WasmFlowRuntime.HEAPU8.subarray(
+                buf_addr,
+                buf_addr + displayWidth * displayHeight * 4
             );
+
+            const rects = getSyncedDirtyRects(
+                WasmFlowRuntime,
+                displayWidth,
+                displayHeight
+            );
+
+            if (
+                !screenSent ||
+                isFullScreenRect(rects, displayWidth, displayHeight)
+            ) {
+                workerToRenderMessage.screen = new Uint8ClampedArray(screen);
+                screenSent = true;
+            } else {
+                workerToRenderMessage.screenUpdates = rects.map(rect => ({
+                    ...rect,
+                    data: copyScreenRect(screen, displayWidth, rect)
+                }));
+            }
         }
 
         workerToRenderMessage.isRTL = WasmFlowRuntime._isRTL();
 
+        const now = Date.now();
+        if (now - frameStatsTime >= FRAME_STATS_INTERVAL) {
+            workerToRenderMessage.frameStats = getFrameStats(WasmFlowRuntime);
+            frameStatsTime = now;
+        }
+
         let messageToDebugger = wasmModuleToMessageToDebugger.get(wasmModuleId);
         if (messageToDebugger != undefined) {
             workerToRenderMessage.messageToDebugger = messageToDebugger;
@@ -68,6 +68,7 @@ import {
     getName
 } from "project-editor/build/helper";
 import { SimulatorLVGLCode } from "project-editor/lvgl/to-lvgl-code";
+import { getSyncedDirtyRects } from "project-editor/flow/runtime/wasm-screen";
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -77,6 +78,54 @@ interface LVGLCreateContext {
     flowState: number;
 }
 
+function putSyncedBuffer(
+    wasm: IWasmFlowRuntime,
+    ctx: CanvasRenderingContext2D,
+    buf_addr: number,
+    displayWidth: number,
+    displayHeight: number
+) {
+    // view into the WASM heap, no copy of the whole screen
+    const imgData = new ImageData(
+        new Uint8ClampedArray(
+            wasm.HEAPU8.buffer,
+            buf_addr,
+            displayWidth * displayHeight * 4
+        ),
+        displayWidth,
+        displayHeight
+    );
+
+    const rects = getSyncedDirtyRects(wasm, displayWidth, displayHeight);
+    for (const rect of rects) {
+        ctx.putImageData(
+            imgData,
+            0,
+            0,
+            rect.x,
+            rect.y,
+            rect.width,
+            rect.height
+        );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// must be the same as LvglCommand in lvgl-runtime/common/src/studio_api.cpp
+const LVGL_COMMAND_CREATE = 1;
+const LVGL_COMMAND_SET_POS = 3;
+const LVGL_COMMAND_SET_SIZE = 4;
+const LVGL_COMMAND_SET_OBJECT_INDEX = 5;
+const LVGL_COMMAND_SET_LOCAL_STYLE_PROP_NUM = 10;
+const LVGL_COMMAND_SET_LOCAL_STYLE_PROP_PTR = 12;
+const LVGL_COMMAND_SET_LOCAL_STYLE_PROP_BUILT_IN_FONT = 13;
+
+// object argument referencing the first object created in the command stream
+const LVGL_COMMAND_FIRST_RESULT = -1;
+
+////////////////////////////////////////////////////////////////////////////////
+
 export abstract class LVGLPageRuntime {
     lvglVersion: "8.3" | "9.0";
     wasm: IWasmFlowRuntime;
@@ -109,6 +158,8 @@ export abstract class LVGLPageRuntime {
         callback: () => void;
     }[] = [];
     stringLiterals = new Map<string, number>();
+    createFunctionIds = new Map<string, number>();
+    lvglCommands: number[] = [];
 
     constructor(public page: Page) {
         this.lvglVersion = this.project.settings.general.lvglVersion;
@@ -223,6 +274,9 @@ export abstract class LVGLPageRuntime {
             if (cachedBitmap) {
                 this.wasm._free(cachedBitmap.bitmapPtr);
                 this.bitmapsCache.delete(bitmap);
+
+                // the runtime could have cached the freed image by name
+                this.wasm._lvglClearNameCache?.();
             }
 
             if (!bitmap.imageElement) {
@@ -264,11 +318,11 @@ export abstract class LVGLPageRuntime {
             if (!fontMemPtr) {
                 return 0;
             }
-            for (let i = 0; i < bin.length; i++) {
-                this.wasm.HEAP8[fontMemPtr + i] = bin[i];
-            }
+            this.wasm.HEAPU8.set(bin, fontMemPtr);
 
-            const fontPathStr = this.wasm.allocateUTF8("M:" + fontMemPtr);
+            const fontPathStr = this.wasm.allocateUTF8(
+                "M:" + fontMemPtr + ":" + bin.length
+            );
 
             let fallbackUserFont = 0;
             let fallbackBuiltinFont = -1;
@@ -330,6 +384,169 @@ export abstract class LVGLPageRuntime {
         return ptr;
     }
 
+    getCreateFunctionId(createFunction: string) {
+        let id = this.createFunctionIds.get(createFunction);
+        if (id == undefined) {
+            id = this.wasm._lvglGetCreateFunctionId
+                ? this.wasm._lvglGetCreateFunctionId(
+                      this.stringLiteral(createFunction)
+                  )
+                : -1;
+            this.createFunctionIds.set(createFunction, id);
+        }
+        return id;
+    }
+
+    lvglExecuteCommands(commands: number[], maxResults: number) {
+        const commandsPtr = this.wasm._malloc(commands.length * 4);
+        this.wasm.HEAP32.set(commands, commandsPtr >> 2);
+
+        const resultsPtr =
+            maxResults > 0 ? this.wasm._malloc(maxResults * 4) : 0;
+
+        const numResults = this.wasm._lvglExecuteCommands!(
+            commandsPtr,
+            commands.length,
+            resultsPtr,
+            maxResults
+        );
+
+        const results: number[] = [];
+        for (let i = 0; i < numResults; i++) {
+            results.push(this.wasm.HEAP32[(resultsPtr >> 2) + i]);
+        }
+
+        this.wasm._free(commandsPtr);
+        if (resultsPtr) {
+            this.wasm._free(resultsPtr);
+        }
+
+        if (numResults < 0) {
+            console.error("lvglExecuteCommands: invalid command stream");
+        }
+
+        return results;
+    }
+
+    // Creates, indexes, positions and sizes the object with a single call into
+    // the runtime. Returns undefined if the runtime can't do it, and then the
+    // caller must create the object with individual calls.
+    lvglCreateObject(
+        createFunction: string,
+        parentObj: number,
+        widgetIndex: number,
+        left: number,
+        top: number,
+        width: number,
+        height: number
+    ): number | undefined {
+        if (!this.wasm._lvglExecuteCommands) {
+            return undefined;
+        }
+
+        const createFunctionId = this.getCreateFunctionId(createFunction);
+        if (createFunctionId == -1) {
+            return undefined;
+        }
+
+        this.flushLvglCommands();
+
+        const results = this.lvglExecuteCommands(
+            [
+                LVGL_COMMAND_CREATE,
+                createFunctionId,
+                parentObj,
+                LVGL_COMMAND_SET_OBJECT_INDEX,
+                LVGL_COMMAND_FIRST_RESULT,
+                widgetIndex,
+                LVGL_COMMAND_SET_POS,
+                LVGL_COMMAND_FIRST_RESULT,
+                left,
+                top,
+                LVGL_COMMAND_SET_SIZE,
+                LVGL_COMMAND_FIRST_RESULT,
+                width,
+                height
+            ],
+            1
+        );
+
+        return results.length == 1 ? results[0] : undefined;
+    }
+
+    // Local style properties are queued and set with one call into the runtime
+    // by flushLvglCommands, if the runtime supports it.
+
+    lvglObjSetLocalStylePropNum(
+        obj: number,
+        prop: number,
+        num: number,
+        selector: number
+    ) {
+        if (this.wasm._lvglExecuteCommands) {
+            this.lvglCommands.push(
+                LVGL_COMMAND_SET_LOCAL_STYLE_PROP_NUM,
+                obj,
+                prop,
+                num,
+                selector
+            );
+        } else {
+            this.wasm._lvglObjSetLocalStylePropNum(obj, prop, num, selector);
+        }
+    }
+
+    lvglObjSetLocalStylePropPtr(
+        obj: number,
+        prop: number,
+        ptr: number,
+        selector: number
+    ) {
+        if (this.wasm._lvglExecuteCommands) {
+            this.lvglCommands.push(
+                LVGL_COMMAND_SET_LOCAL_STYLE_PROP_PTR,
+                obj,
+                prop,
+                ptr,
+                selector
+            );
+        } else {
+            this.wasm._lvglObjSetLocalStylePropPtr(obj, prop, ptr, selector);
+        }
+    }
+
+    lvglObjSetLocalStylePropBuiltInFont(
+        obj: number,
+        prop: number,
+        fontIndex: number,
+        selector: number
+    ) {
+        if (this.wasm._lvglExecuteCommands) {
+            this.lvglCommands.push(
+                LVGL_COMMAND_SET_LOCAL_STYLE_PROP_BUILT_IN_FONT,
+                obj,
+                prop,
+                fontIndex,
+                selector
+            );
+        } else {
+            this.wasm._lvglObjSetLocalStylePropBuiltInFont(
+                obj,
+                prop,
+                fontIndex,
+                selector
+            );
+        }
+    }
+
+    flushLvglCommands() {
+        if (this.lvglCommands.length > 0) {
+            const commands = this.lvglCommands;
+            this.lvglCommands = [];
+            this.lvglExecuteCommands(commands, 0);
+        }
+    }
+
     freePointers() {
         for (const ptr of this.pointers) {
             this.wasm._free(ptr);
@@ -554,7 +771,12 @@ export abstract class LVGLPageRuntime {
         return strPtr;
     }
 
-    addTickCallback(callback: (flowState: number) => void) {}
+    addTickCallback(
+        callback: (flowState: number) => void,
+        obj: number,
+        componentIndex: number,
+        propertyIndex: number
+    ) {}
 
     addEventHandler(
         obj: number,
@@ -567,6 +789,13 @@ export abstract class LVGLPageRuntime {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// must be the same as NameCacheKind in lvgl-runtime/common/src/flow.cpp
+const LVGL_NAME_CACHE_SCREEN = 0;
+const LVGL_NAME_CACHE_GROUP = 2;
+const LVGL_NAME_CACHE_STYLE = 3;
+
+////////////////////////////////////////////////////////////////////////////////
+
 export class LVGLPageEditorRuntime extends LVGLPageRuntime {
     autorRunDispose: IReactionDisposer | undefined;
     dispose2: IReactionDisposer | undefined;
@@ -753,25 +982,10 @@ export class LVGLPageEditorRuntime extends LVGLPageRuntime {
 
         var buf_addr = this.wasm._getSyncedBuffer();
         if (buf_addr != 0) {
-            const screen = new Uint8ClampedArray(
-                this.wasm.HEAPU8.subarray(
-                    buf_addr,
-                    buf_addr + this.displayWidth * this.displayHeight * 4
-                )
-            );
-
-            var imgData = new ImageData(
-                screen,
-                this.displayWidth,
-                this.displayHeight
-            );
-
-            this.ctx.putImageData(
-                imgData,
-                0,
-                0,
-                0,
-                0,
+            putSyncedBuffer(
+                this.wasm,
+                this.ctx,
+                buf_addr,
                 this.displayWidth,
                 this.displayHeight
             );
@@ -889,25 +1103,10 @@ export class LVGLNonActivePageViewerRuntime extends LVGLPageRuntime {
 
         var buf_addr = this.wasm._getSyncedBuffer();
         if (buf_addr != 0) {
-            const screen = new Uint8ClampedArray(
-                this.wasm.HEAPU8.subarray(
-                    buf_addr,
-                    buf_addr + this.displayWidth * this.displayHeight * 4
-                )
-            );
-
-            var imgData = new ImageData(
-                screen,
-                this.displayWidth,
-                this.displayHeight
-            );
-
-            this.ctx.putImageData(
-                imgData,
-                0,
-                0,
-                0,
-                0,
+            putSyncedBuffer(
+                this.wasm,
+                this.ctx,
+                buf_addr,
                 this.displayWidth,
                 this.displayHeight
             );
@@ -974,6 +1173,7 @@ export class LVGLPageViewerRuntime extends LVGLPageRuntime {
         page: Page;
         flowState: number;
         callback: (flowState: number) => void;
+        isChanged: (() => boolean) | undefined;
     }[] = [];
     eventHandlers: {
         page: Page;
@@ -1065,6 +1265,8 @@ export class LVGLPageViewerRuntime extends LVGLPageRuntime {
 
         this.pageGroupWidgets.clear();
 
+        this.setNameCacheEntries();
+
         for (const page of this.pages) {
             if (
                 !this.project.settings.build.screensLifetimeSupport ||
@@ -1104,6 +1306,42 @@ export class LVGLPageViewerRuntime extends LVGLPageRuntime {
         this.isMounted = false;
     }
 
+    // Screen, group and style names are known at startup, push them to the
+    // runtime so it can resolve them without calling back into JavaScript.
+    setNameCacheEntries() {
+        if (!this.wasm._lvglSetNameCacheEntry) {
+            return;
+        }
+
+        const setNameCacheEntry = (
+            kind: number,
+            name: string,
+            value: number
+        ) => {
+            const namePtr = this.wasm.allocateUTF8(name);
+            this.wasm._lvglSetNameCacheEntry!(kind, namePtr, value);
+            this.wasm._free(namePtr);
+        };
+
+        this.project._store.lvglIdentifiers.pages
+            .filter(page => !page.isUsedAsUserWidget)
+            .forEach((page, pageIndex) =>
+                setNameCacheEntry(
+                    LVGL_NAME_CACHE_SCREEN,
+                    page.name,
+                    pageIndex + 1
+                )
+            );
+
+        this.project.lvglGroups.groups.forEach((group, groupIndex) =>
+            setNameCacheEntry(LVGL_NAME_CACHE_GROUP, group.name, groupIndex)
+        );
+
+        this.projectStore.lvglIdentifiers.styles.forEach((style, styleIndex) =>
+            setNameCacheEntry(LVGL_NAME_CACHE_STYLE, style.name, styleIndex)
+        );
+    }
+
     lvglCreateScreen(screenIndex: number) {
         const page = this.pages[screenIndex];
 
@@ -1135,8 +1373,10 @@ export class LVGLPageViewerRuntime extends LVGLPageRuntime {
 
             this.wasm._lvglDeleteObject(pageState.pageObj);
 
-            for (const widgetIndex of pageState.widgetIndexes) {
-                this.wasm._lvglDeleteObjectIndex(widgetIndex);
+            // in reverse creation order, the runtime removes the most
+            // recently added update tasks cheaply
+            for (let i = pageState.widgetIndexes.length - 1; i >= 0; i--) {
+                this.wasm._lvglDeleteObjectIndex(pageState.widgetIndexes[i]);
             }
 
             this.wasm._lvglDeletePageFlowState(screenIndex);
@@ -1362,17 +1602,46 @@ export class LVGLPageViewerRuntime extends LVGLPageRuntime {
         return this.runtime.assetsMap.lvglWidgetIndexes[identifier];
     }
 
-    override addTickCallback(callback: (flowState: number) => void) {
+    override addTickCallback(
+        callback: (flowState: number) => void,
+        obj: number,
+        componentIndex: number,
+        propertyIndex: number
+    ) {
+        const flowState = this.lvglCreateContext.flowState;
+
+        // runtime tells when the property has to be evaluated again, older
+        // runtimes without this export evaluate it on every tick
+        let isChanged: (() => boolean) | undefined;
+        if (this.wasm._lvglAddTickProperty) {
+            this.wasm._lvglAddTickProperty(
+                obj,
+                flowState,
+                componentIndex,
+                propertyIndex
+            );
+            isChanged = () =>
+                this.wasm._lvglIsTickPropertyChanged!(
+                    obj,
+                    componentIndex,
+                    propertyIndex
+                );
+        }
+
         this.tickCallbacks.push({
             page: this.page,
-            flowState: this.lvglCreateContext.flowState,
-            callback
+            flowState,
+            callback,
+            isChanged
         });
     }
 
     lvglScreenTick() {
         for (let tickCallback of this.tickCallbacks) {
-            if (this.runtime.selectedPage == tickCallback.page) {
+            if (
+                this.runtime.selectedPage == tickCallback.page &&
+                (!tickCallback.isChanged || tickCallback.isChanged())
+            ) {
                 tickCallback.callback(tickCallback.flowState);
             }
         }
@@ -1640,28 +1909,13 @@ export class LVGLStylesEditorRuntime extends LVGLPageRuntime {
 
             var buf_addr = this.wasm._getSyncedBuffer();
             if (buf_addr != 0) {
-                const screen = new Uint8ClampedArray(
-                    this.wasm.HEAPU8.subarray(
-                        buf_addr,
-                        buf_addr + this.displayWidth * this.displayHeight * 4
-                    )
-                );
-
-                var imgData = new ImageData(
-                    screen,
-                    this.displayWidth,
-                    this.displayHeight
-                );
-
                 const ctx = this.canvas.getContext("2d");
 
                 if (ctx) {
-                    ctx.putImageData(
-                        imgData,
-                        0,
-                        0,
-                        0,
-                        0,
+                    putSyncedBuffer(
+                        this.wasm,
+                        ctx,
+                        buf_addr,
                         this.displayWidth,
                         this.displayHeight
                     );
@@ -494,7 +494,7 @@ export class LVGLStylesDefinition extends EezObject {
                             if (propertyInfo == text_font_property_info) {
                                 const index = BUILT_IN_FONTS.indexOf(value);
                                 if (index != -1) {
-                                    runtime.wasm._lvglObjSetLocalStylePropBuiltInFont(
+                                    runtime.lvglObjSetLocalStylePropBuiltInFont(
                                         obj,
                                         runtime.getLvglStylePropCode(
                                             propertyInfo.lvglStyleProp.code
@@ -512,7 +512,7 @@ export class LVGLStylesDefinition extends EezObject {
                                         const fontPtr =
                                             runtime.getFontPtr(font);
                                         if (fontPtr) {
-                                            runtime.wasm._lvglObjSetLocalStylePropPtr(
+                                            runtime.lvglObjSetLocalStylePropPtr(
                                                 obj,
                                                 runtime.getLvglStylePropCode(
                                                     propertyInfo.lvglStyleProp
@@ -533,7 +533,7 @@ export class LVGLStylesDefinition extends EezObject {
                                       )
                                     : value;
 
-                                runtime.wasm._lvglObjSetLocalStylePropNum(
+                                runtime.lvglObjSetLocalStylePropNum(
                                     obj,
                                     runtime.getLvglStylePropCode(
                                         propertyInfo.lvglStyleProp.code
@@ -559,7 +559,7 @@ export class LVGLStylesDefinition extends EezObject {
 
                             arrValue.push(LV_GRID_TEMPLATE_LAST);
 
-                            runtime.wasm._lvglObjSetLocalStylePropPtr(
+                            runtime.lvglObjSetLocalStylePropPtr(
                                 obj,
                                 runtime.getLvglStylePropCode(
                                     propertyInfo.lvglStyleProp.code
@@ -570,7 +570,7 @@ export class LVGLStylesDefinition extends EezObject {
                         } else if (propertyInfo.type == PropertyType.Boolean) {
                             const numValue = value ? 1 : 0;
 
-                            runtime.wasm._lvglObjSetLocalStylePropNum(
+                            runtime.lvglObjSetLocalStylePropNum(
                                 obj,
                                 runtime.getLvglStylePropCode(
                                     propertyInfo.lvglStyleProp.code
@@ -590,7 +590,7 @@ export class LVGLStylesDefinition extends EezObject {
                             if (bitmap && bitmap.image) {
                                 const bitmapPtr = runtime.getBitmapPtr(bitmap);
                                 if (bitmapPtr) {
-                                    runtime.wasm._lvglObjSetLocalStylePropPtr(
+                                    runtime.lvglObjSetLocalStylePropPtr(
                                         obj,
                                         runtime.getLvglStylePropCode(
                                             propertyInfo.lvglStyleProp.code
@@ -605,6 +605,8 @@ export class LVGLStylesDefinition extends EezObject {
                 );
             });
         });
+
+        runtime.flushLvglCommands();
     }
 
     lvglBuild(build: LVGLBuild) {
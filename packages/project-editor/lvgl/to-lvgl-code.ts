@@ -330,6 +330,25 @@ export class SimulatorLVGLCode implements LVGLCode {
     }
 
     createObject(createObjectFunction: string, ...args: any[]) {
+        if (args.length == 0) {
+            const rect = this.widget.getLvglCreateRect();
+
+            const obj = this.runtime.lvglCreateObject(
+                createObjectFunction,
+                this.parentObj,
+                this.runtime.getCreateWidgetIndex(this.widget),
+                rect.left,
+                rect.top,
+                rect.width,
+                rect.height
+            );
+
+            if (obj != undefined) {
+                this.obj = obj;
+                return;
+            }
+        }
+
         this.obj = this.callFreeFunction(
             createObjectFunction,
             this.parentObj,
@@ -554,14 +573,19 @@ export class SimulatorLVGLCode implements LVGLCode {
         const obj = this.obj;
         const flowState = this.runtime.lvglCreateContext.flowState;
         if (propExpr) {
-            this.runtime.addTickCallback((flowState1: number) => {
-                this.widget = widget;
-                this.obj = obj;
-                this.flowState = flowState;
-                this.componentIndex = propExpr.componentIndex;
-                this.propertyIndex = propExpr.propertyIndex;
-                callback();
-            });
+            this.runtime.addTickCallback(
+                (flowState1: number) => {
+                    this.widget = widget;
+                    this.obj = obj;
+                    this.flowState = flowState;
+                    this.componentIndex = propExpr.componentIndex;
+                    this.propertyIndex = propExpr.propertyIndex;
+                    callback();
+                },
+                obj,
+                propExpr.componentIndex,
+                propExpr.propertyIndex
+            );
         }
     }
 
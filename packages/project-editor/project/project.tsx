@@ -276,6 +276,7 @@ export class Build extends EezObject {
     screensLifetimeSupport: boolean;
     generateSourceCodeForEezFramework: boolean;
     compressFlowDefinition: boolean;
+    generateAssetsFile: boolean;
     executionQueueSize: number;
     expressionEvaluatorStackSize: number;
     fontsAreStoredInFilesystem: boolean;
@@ -355,6 +356,16 @@ export class Build extends EezObject {
                     !getProject(object).projectTypeTraits.hasFlowSupport ||
                     !object.generateSourceCodeForEezFramework
             },
+            {
+                name: "generateAssetsFile",
+                displayName: "Generate assets file for loadMainAssetsFromFile",
+                type: PropertyType.Boolean,
+                checkboxStyleSwitch: true,
+                disabled: (object: Build) =>
+                    isNotLVGLProject(object) ||
+                    !getProject(object).projectTypeTraits.hasFlowSupport ||
+                    !object.generateSourceCodeForEezFramework
+            },
             {
                 name: "executionQueueSize",
                 type: PropertyType.Number,
@@ -386,6 +397,10 @@ export class Build extends EezObject {
                 jsObject.compressFlowDefinition = false;
             }
 
+            if (jsObject.generateAssetsFile == undefined) {
+                jsObject.generateAssetsFile = false;
+            }
+
             if (jsObject.executionQueueSize == undefined) {
                 jsObject.executionQueueSize = 1000;
             }
@@ -438,6 +453,7 @@ export class Build extends EezObject {
             screensLifetimeSupport: observable,
             generateSourceCodeForEezFramework: observable,
             compressFlowDefinition: observable,
+            generateAssetsFile: observable,
             executionQueueSize: observable,
             expressionEvaluatorStackSize: observable
         });
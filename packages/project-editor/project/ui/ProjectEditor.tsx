@@ -27,6 +27,7 @@ import { ThemesSideView } from "project-editor/features/style/theme";
 import { getEditorComponent } from "project-editor/project/ui/EditorComponentFactory";
 import { QueuePanel } from "project-editor/flow/debugger/QueuePanel";
 import { WatchPanel } from "project-editor/flow/debugger/WatchPanel";
+import { ProfilerPanel } from "project-editor/flow/debugger/ProfilerPanel";
 import { ActiveFlowsPanel } from "project-editor/flow/debugger/ActiveFlowsPanel";
 import { LogsPanel } from "project-editor/flow/debugger/LogsPanel";
 import { ListNavigation } from "project-editor/ui-components/ListNavigation";
@@ -202,6 +203,10 @@ const Content = observer(
                 if (component === "logs") {
                     return <LogsPanel runtime={this.context.runtime} />;
                 }
+
+                if (component === "profiler") {
+                    return <ProfilerPanel runtime={this.context.runtime} />;
+                }
             }
 
             if (component === "propertiesPanel") {
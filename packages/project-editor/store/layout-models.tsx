@@ -546,7 +546,7 @@ export class LayoutModels extends AbstractLayoutModels {
             },
             {
                 name: "rootRuntime",
-                version: 54,
+                version: 55,
                 json: {
                     global: LayoutModels.GLOBAL_OPTIONS,
                     layout: {
@@ -618,7 +618,14 @@ export class LayoutModels extends AbstractLayoutModels {
                                                 icon: "svg:queue_panel",
                                                 component: "queue"
                                             },
-                                            LayoutModels.BREAKPOINTS_TAB
+                                            LayoutModels.BREAKPOINTS_TAB,
+                                            {
+                                                type: "tab",
+                                                enableClose: false,
+                                                name: "Profiler",
+                                                icon: "material:speed",
+                                                component: "profiler"
+                                            }
                                         ]
                                     },
                                     {
@@ -46,6 +46,7 @@ void executeActionFunction(int actionId) {
 #include <assert.h>
 #include <string.h>
 namespace eez {
+uint32_t g_numAllocs;
 #if defined(EEZ_FOR_LVGL)
 void initAllocHeap(uint8_t *heap, size_t heapSize) {
     EEZ_UNUSED(heap);
@@ -53,6 +54,7 @@ void initAllocHeap(uint8_t *heap, size_t heapSize) {
 }
 void *alloc(size_t size, uint32_t id) {
     EEZ_UNUSED(id);
+    g_numAllocs++;
 #if LVGL_VERSION_MAJOR >= 9
     return lv_malloc(size);
 #else
@@ -85,6 +87,7 @@ void getAllocInfo(uint32_t &free, uint32_t &alloc) {
 void initAllocHeap(uint8_t *heap, size_t heapSize) {
 }
 void *alloc(size_t size, uint32_t id) {
+    g_numAllocs++;
     return ::malloc(size);
 }
 void free(void *ptr) {
@@ -153,6 +156,7 @@ void *alloc(size_t size, uint32_t id) {
 		}
 		block->free = 0;
 		block->id = id;
+        g_numAllocs++;
 		EEZ_MUTEX_RELEASE(alloc);
 		return block + 1;
 	}
@@ -250,19 +254,198 @@ using namespace eez::gui;
 #else
 #define SCPI_ERROR_OUT_OF_DEVICE_MEMORY -321
 #define SCPI_ERROR_INVALID_BLOCK_DATA -161
+#define SCPI_ERROR_MASS_STORAGE_ERROR -250
+#define SCPI_ERROR_FILE_NAME_NOT_FOUND -256
+#endif
+#if EEZ_OPTION_ASSETS_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #endif
 namespace eez {
 bool g_isMainAssetsLoaded;
 Assets *g_mainAssets;
 bool g_mainAssetsUncompressed;
 Assets *g_externalAssets;
+#if EEZ_OPTION_ASSETS_MMAP
+static struct {
+    void *data;
+    size_t size;
+} g_mainAssetsMapping;
+#endif
+static NameIndex g_variableNameIndex;
+static NameIndex g_actionNameIndex;
+#if EEZ_OPTION_GUI
+static NameIndex g_bitmapNameIndex;
+#endif
+static void resetMainAssetsNameIndexes() {
+    g_variableNameIndex.reset();
+    g_actionNameIndex.reset();
+#if EEZ_OPTION_GUI
+    g_bitmapNameIndex.reset();
+#endif
+}
+#if EEZ_FOR_LVGL_LZ4_OPTION
+static struct {
+    ChunkedHeader *header;
+#if EEZ_OPTION_GUI
+    uint8_t *loadedBitmaps;
+    uint8_t *loadedFonts;
+#endif
+    uint8_t *loadedLanguages;
+} g_mainLazyAssets;
+#endif
 void fixOffsets(Assets *assets);
+#if EEZ_FOR_LVGL_LZ4_OPTION
+static bool decompressAssetsBlock(const ChunkedHeader *header, const AssetsBlock &block, Assets *decompressedAssets) {
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+#endif
+	auto decompressedDataOffset = offsetof(Assets, settings);
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+    int decompressResult = LZ4_decompress_safe(
+		(const char *)header + block.compressedOffset,
+		(char *)decompressedAssets + decompressedDataOffset + block.decompressedOffset,
+		block.compressedSize,
+		block.decompressedSize
+	);
+    return decompressResult == (int)block.decompressedSize;
+}
+static bool decompressChunkedAssetsData(const ChunkedHeader *header, uint32_t assetsDataSize, Assets *decompressedAssets, bool eagerBlocksOnly) {
+    if (sizeof(Header) + sizeof(uint32_t) + header->numBlocks * sizeof(AssetsBlock) > assetsDataSize) {
+        return false;
+    }
+    for (uint32_t i = 0; i < header->numBlocks; i++) {
+        auto &block = header->blocks[i];
+        if (
+            block.compressedOffset + block.compressedSize > assetsDataSize ||
+            block.decompressedOffset + block.decompressedSize > header->decompressedSize
+        ) {
+            return false;
+        }
+        if (eagerBlocksOnly && block.kind != ASSETS_BLOCK_KIND_EAGER) {
+            continue;
+        }
+        if (!decompressAssetsBlock(header, block, decompressedAssets)) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+#if EEZ_FOR_LVGL_LZ4_OPTION
+static void loadLazyAssets(uint16_t kind, uint32_t assetIndex) {
+    auto header = g_mainLazyAssets.header;
+    for (uint32_t i = 0; i < header->numBlocks; i++) {
+        auto &block = header->blocks[i];
+        if (block.kind == kind && block.assetIndex == assetIndex) {
+            if (!decompressAssetsBlock(header, block, g_mainAssets)) {
+                ErrorTrace("Failed to decompress assets block %d\n", (int)i);
+            }
+        }
+    }
+}
+static ChunkedHeader *copyLazyAssetsBlocks(const ChunkedHeader *header) {
+    uint32_t indexSize = sizeof(Header) + sizeof(uint32_t) + header->numBlocks * sizeof(AssetsBlock);
+    uint32_t size = indexSize;
+    uint32_t numLazyBlocks = 0;
+    for (uint32_t i = 0; i < header->numBlocks; i++) {
+        if (header->blocks[i].kind != ASSETS_BLOCK_KIND_EAGER) {
+            size += header->blocks[i].compressedSize;
+            numLazyBlocks++;
+        }
+    }
+    if (numLazyBlocks == 0) {
+        return nullptr;
+    }
+    auto copy = (ChunkedHeader *)eez::alloc(size, 0x2d8e41b7);
+    if (!copy) {
+        return nullptr;
+    }
+    memcpy(copy, header, indexSize);
+    uint32_t compressedOffset = indexSize;
+    for (uint32_t i = 0; i < copy->numBlocks; i++) {
+        auto &block = copy->blocks[i];
+        if (block.kind != ASSETS_BLOCK_KIND_EAGER) {
+            memcpy((uint8_t *)copy + compressedOffset, (const uint8_t *)header + block.compressedOffset, block.compressedSize);
+            block.compressedOffset = compressedOffset;
+            compressedOffset += block.compressedSize;
+        }
+    }
+    return copy;
+}
+static uint8_t *allocLoadedAssetsFlags(uint32_t count, uint32_t id) {
+    if (count == 0) {
+        return nullptr;
+    }
+    auto loadedAssets = (uint8_t *)eez::alloc(count, id);
+    memset(loadedAssets, 0, count);
+    return loadedAssets;
+}
+static void resetMainLazyAssets() {
+    if (g_mainLazyAssets.header) {
+        eez::free(g_mainLazyAssets.header);
+        g_mainLazyAssets.header = nullptr;
+    }
+#if EEZ_OPTION_GUI
+    if (g_mainLazyAssets.loadedBitmaps) {
+        eez::free(g_mainLazyAssets.loadedBitmaps);
+        g_mainLazyAssets.loadedBitmaps = nullptr;
+    }
+    if (g_mainLazyAssets.loadedFonts) {
+        eez::free(g_mainLazyAssets.loadedFonts);
+        g_mainLazyAssets.loadedFonts = nullptr;
+    }
+#endif
+    if (g_mainLazyAssets.loadedLanguages) {
+        eez::free(g_mainLazyAssets.loadedLanguages);
+        g_mainLazyAssets.loadedLanguages = nullptr;
+    }
+}
+#endif
+#if EEZ_OPTION_GUI
+static inline void loadLazyBitmap(uint32_t bitmapIndex) {
+#if EEZ_FOR_LVGL_LZ4_OPTION
+    if (g_mainLazyAssets.loadedBitmaps && bitmapIndex < g_mainAssets->bitmaps.count && !g_mainLazyAssets.loadedBitmaps[bitmapIndex]) {
+        loadLazyAssets(ASSETS_BLOCK_KIND_BITMAP, bitmapIndex);
+        g_mainLazyAssets.loadedBitmaps[bitmapIndex] = 1;
+    }
+#else
+    EEZ_UNUSED(bitmapIndex);
+#endif
+}
+static inline void loadLazyFont(uint32_t fontIndex) {
+#if EEZ_FOR_LVGL_LZ4_OPTION
+    if (g_mainLazyAssets.loadedFonts && fontIndex < g_mainAssets->fonts.count && !g_mainLazyAssets.loadedFonts[fontIndex]) {
+        loadLazyAssets(ASSETS_BLOCK_KIND_FONT, fontIndex);
+        g_mainLazyAssets.loadedFonts[fontIndex] = 1;
+    }
+#else
+    EEZ_UNUSED(fontIndex);
+#endif
+}
+#endif
+void loadLazyLanguage(Assets *assets, uint32_t languageIndex) {
+#if EEZ_FOR_LVGL_LZ4_OPTION
+    if (assets == g_mainAssets && g_mainLazyAssets.loadedLanguages && languageIndex < assets->languages.count && !g_mainLazyAssets.loadedLanguages[languageIndex]) {
+        loadLazyAssets(ASSETS_BLOCK_KIND_LANGUAGE, languageIndex);
+        g_mainLazyAssets.loadedLanguages[languageIndex] = 1;
+    }
+#else
+    EEZ_UNUSED(assets);
+    EEZ_UNUSED(languageIndex);
+#endif
+}
 bool decompressAssetsData(const uint8_t *assetsData, uint32_t assetsDataSize, Assets *decompressedAssets, uint32_t maxDecompressedAssetsSize, int *err) {
 #if EEZ_FOR_LVGL_LZ4_OPTION
 	uint32_t compressedDataOffset;
 	uint32_t decompressedSize;
 	auto header = (Header *)assetsData;
-	if (header->tag == HEADER_TAG_COMPRESSED) {
+	if (header->tag == HEADER_TAG_COMPRESSED || header->tag == HEADER_TAG_CHUNKED) {
 		decompressedAssets->projectMajorVersion = header->projectMajorVersion;
 		decompressedAssets->projectMinorVersion = header->projectMinorVersion;
         decompressedAssets->assetsType = header->assetsType;
@@ -289,6 +472,15 @@ bool decompressAssetsData(const uint8_t *assetsData, uint32_t assetsDataSize, As
 		}
 		return false;
 	}
+    if (header->tag == HEADER_TAG_CHUNKED) {
+        if (!decompressChunkedAssetsData((const ChunkedHeader *)header, assetsDataSize, decompressedAssets, false)) {
+            if (err) {
+                *err = SCPI_ERROR_INVALID_BLOCK_DATA;
+            }
+            return false;
+        }
+        return true;
+    }
 	int compressedSize = assetsDataSize - compressedDataOffset;
     int decompressResult = LZ4_decompress_safe(
 		(const char *)(assetsData + compressedDataOffset),
@@ -323,16 +515,24 @@ static void allocMemoryForDecompressedAssets(const uint8_t *assetsData, uint32_t
 #pragma GCC diagnostic pop
 #endif
     auto header = (Header *)assetsData;
-    assert (header->tag == HEADER_TAG_COMPRESSED);
+    assert (header->tag == HEADER_TAG_COMPRESSED || header->tag == HEADER_TAG_CHUNKED);
     uint32_t decompressedSize = header->decompressedSize;
     decompressedAssetsMemoryBufferSize = decompressedDataOffset + decompressedSize;
     decompressedAssetsMemoryBuffer = (uint8_t *)eez::alloc(decompressedAssetsMemoryBufferSize, 0x587da194);
 }
 void loadMainAssets(const uint8_t *assets, uint32_t assetsSize) {
+    resetMainAssetsNameIndexes();
+#if EEZ_FOR_LVGL_LZ4_OPTION
+    resetMainLazyAssets();
+#endif
+    g_isMainAssetsLoaded = false;
     auto header = (Header *)assets;
     if (header->tag == HEADER_TAG) {
         g_mainAssets = (Assets *)(assets + sizeof(uint32_t));
         g_mainAssetsUncompressed = true;
+    } else if (header->tag == HEADER_TAG_ALIGNED) {
+        g_mainAssets = (Assets *)(assets + 2 * sizeof(uint32_t));
+        g_mainAssetsUncompressed = true;
     } else {
 #if defined(EEZ_FOR_LVGL) || defined(EEZ_DASHBOARD_API)
         uint8_t *DECOMPRESSED_ASSETS_START_ADDRESS = 0;
@@ -342,11 +542,112 @@ void loadMainAssets(const uint8_t *assets, uint32_t assetsSize) {
         g_mainAssets = (Assets *)DECOMPRESSED_ASSETS_START_ADDRESS;
         g_mainAssetsUncompressed = false;
         g_mainAssets->external = false;
-        auto decompressedSize = decompressAssetsData(assets, assetsSize, g_mainAssets, MAX_DECOMPRESSED_ASSETS_SIZE, nullptr);
-        assert(decompressedSize);
+#if EEZ_FOR_LVGL_LZ4_OPTION
+        if (header->tag == HEADER_TAG_CHUNKED) {
+            auto chunkedHeader = (const ChunkedHeader *)header;
+            g_mainAssets->projectMajorVersion = header->projectMajorVersion;
+            g_mainAssets->projectMinorVersion = header->projectMinorVersion;
+            g_mainAssets->assetsType = header->assetsType;
+            if (!decompressChunkedAssetsData(chunkedHeader, assetsSize, g_mainAssets, true)) {
+                ErrorTrace("Failed to decompress main assets\n");
+#if defined(EEZ_FOR_LVGL) || defined(EEZ_DASHBOARD_API)
+                eez::free(g_mainAssets);
+#endif
+                g_mainAssets = nullptr;
+                return;
+            }
+            g_mainLazyAssets.header = copyLazyAssetsBlocks(chunkedHeader);
+            if (g_mainLazyAssets.header) {
+#if EEZ_OPTION_GUI
+                g_mainLazyAssets.loadedBitmaps = allocLoadedAssetsFlags(g_mainAssets->bitmaps.count, 0x6c2e7a14);
+                g_mainLazyAssets.loadedFonts = allocLoadedAssetsFlags(g_mainAssets->fonts.count, 0x3f1b9c52);
+#endif
+                g_mainLazyAssets.loadedLanguages = allocLoadedAssetsFlags(g_mainAssets->languages.count, 0x91c4f06a);
+            }
+            g_isMainAssetsLoaded = true;
+            return;
+        }
+#endif
+        if (!decompressAssetsData(assets, assetsSize, g_mainAssets, MAX_DECOMPRESSED_ASSETS_SIZE, nullptr)) {
+            ErrorTrace("Failed to decompress main assets\n");
+#if defined(EEZ_FOR_LVGL) || defined(EEZ_DASHBOARD_API)
+            eez::free(g_mainAssets);
+#endif
+            g_mainAssets = nullptr;
+            return;
+        }
     }
     g_isMainAssetsLoaded = true;
 }
+#if EEZ_OPTION_ASSETS_MMAP
+bool loadMainAssetsFromFile(const char *filePath, int *err) {
+    int fd = open(filePath, O_RDONLY);
+    if (fd == -1) {
+        if (err) {
+            *err = SCPI_ERROR_FILE_NAME_NOT_FOUND;
+        }
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1 || (size_t)st.st_size < sizeof(Header)) {
+        close(fd);
+        if (err) {
+            *err = SCPI_ERROR_INVALID_BLOCK_DATA;
+        }
+        return false;
+    }
+    void *data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        if (err) {
+            *err = SCPI_ERROR_MASS_STORAGE_ERROR;
+        }
+        return false;
+    }
+    auto header = (const Header *)data;
+    if (header->tag != HEADER_TAG && header->tag != HEADER_TAG_ALIGNED && header->tag != HEADER_TAG_COMPRESSED && header->tag != HEADER_TAG_CHUNKED) {
+        munmap(data, (size_t)st.st_size);
+        if (err) {
+            *err = SCPI_ERROR_INVALID_BLOCK_DATA;
+        }
+        return false;
+    }
+    unloadMainAssets();
+    loadMainAssets((const uint8_t *)data, (uint32_t)st.st_size);
+    if (!g_isMainAssetsLoaded) {
+        munmap(data, (size_t)st.st_size);
+        if (err) {
+            *err = SCPI_ERROR_INVALID_BLOCK_DATA;
+        }
+        return false;
+    }
+    if (header->tag != HEADER_TAG && header->tag != HEADER_TAG_ALIGNED) {
+        munmap(data, (size_t)st.st_size);
+    } else {
+        g_mainAssetsMapping.data = data;
+        g_mainAssetsMapping.size = (size_t)st.st_size;
+    }
+    return true;
+}
+void unloadMainAssets() {
+#if EEZ_FOR_LVGL_LZ4_OPTION
+    resetMainLazyAssets();
+#endif
+#if defined(EEZ_FOR_LVGL) || defined(EEZ_DASHBOARD_API)
+    if (g_mainAssets && !g_mainAssetsUncompressed) {
+        eez::free(g_mainAssets);
+    }
+#endif
+    if (g_mainAssetsMapping.data) {
+        munmap(g_mainAssetsMapping.data, g_mainAssetsMapping.size);
+        g_mainAssetsMapping.data = nullptr;
+        g_mainAssetsMapping.size = 0;
+    }
+    resetMainAssetsNameIndexes();
+    g_mainAssets = nullptr;
+    g_isMainAssetsLoaded = false;
+}
+#endif
 void unloadExternalAssets() {
 	if (g_externalAssets) {
 #if EEZ_OPTION_GUI
@@ -393,6 +694,7 @@ const gui::Style *getStyle(int styleID) {
 }
 const gui::FontData *getFontData(int fontID) {
 	if (fontID > 0) {
+        loadLazyFont(fontID - 1);
 		return g_mainAssets->fonts[fontID - 1];
 	} else if (fontID < 0) {
 		if (g_externalAssets == nullptr) {
@@ -404,6 +706,7 @@ const gui::FontData *getFontData(int fontID) {
 }
 const gui::Bitmap *getBitmap(int bitmapID) {
 	if (bitmapID > 0) {
+        loadLazyBitmap(bitmapID - 1);
 		return g_mainAssets->bitmaps[bitmapID - 1];
 	} else if (bitmapID < 0) {
 		if (g_externalAssets == nullptr) {
@@ -414,12 +717,10 @@ const gui::Bitmap *getBitmap(int bitmapID) {
 	return nullptr;
 }
 const int getBitmapIdByName(const char *bitmapName) {
-    for (uint32_t i = 0; i < g_mainAssets->bitmaps.count; i++) {
-		if (strcmp(g_mainAssets->bitmaps[i]->name, bitmapName) == 0) {
-            return i + 1;
-        }
-	}
-    return 0;
+    auto &bitmaps = g_mainAssets->bitmaps;
+    return g_bitmapNameIndex.find(g_mainAssets, bitmaps.count, bitmapName, [&bitmaps](uint32_t i) {
+        return static_cast<const char *>(bitmaps[i]->name);
+    }) + 1;
 }
 #endif 
 int getThemesCount() {
@@ -459,6 +760,18 @@ const uint16_t *getColors() {
 int getExternalAssetsMainPageId() {
 	return -1;
 }
+int getVariableIdByName(const char *variableName) {
+    auto &variableNames = g_mainAssets->variableNames;
+    return g_variableNameIndex.find(g_mainAssets, variableNames.count, variableName, [&variableNames](uint32_t i) {
+        return variableNames[i];
+    }) + 1;
+}
+int getActionIdByName(const char *actionName) {
+    auto &actionNames = g_mainAssets->actionNames;
+    return g_actionNameIndex.find(g_mainAssets, actionNames.count, actionName, [&actionNames](uint32_t i) {
+        return actionNames[i];
+    }) + 1;
+}
 #if EEZ_OPTION_GUI
 const char *getActionName(const WidgetCursor &widgetCursor, int16_t actionId) {
 	if (actionId == 0) {
@@ -477,6 +790,9 @@ int16_t getDataIdFromName(const WidgetCursor &widgetCursor, const char *name) {
 	if (!widgetCursor.assets) {
 		return 0;
 	}
+	if (widgetCursor.assets == g_mainAssets) {
+		return -(int16_t)getVariableIdByName(name);
+	}
 	for (uint32_t i = 0; i < widgetCursor.assets->variableNames.count; i++) {
 		if (strcmp(widgetCursor.assets->variableNames[i], name) == 0) {
 			return -((int16_t)i + 1);
@@ -618,6 +934,9 @@ uint8_t *allocBuffer(uint32_t size) {
 #if defined(__EMSCRIPTEN__)
 #include <sys/time.h>
 #endif
+#if defined(EEZ_FOR_LVGL) && !defined(EEZ_FLOW_MICROS) && (defined(__linux__) || defined(__APPLE__) || defined(_WIN32))
+#include <chrono>
+#endif
 namespace eez {
 uint32_t millis() {
 #if defined(EEZ_PLATFORM_STM32)
@@ -640,6 +959,32 @@ uint32_t millis() {
     #error "Missing millis implementation";
 #endif
 }
+uint32_t micros() {
+#if defined(EEZ_FLOW_MICROS)
+    return EEZ_FLOW_MICROS();
+#elif defined(__EMSCRIPTEN__)
+	return (uint32_t)(uint64_t)(emscripten_get_now() * 1000);
+#elif defined(EEZ_PLATFORM_STM32)
+    uint32_t ms;
+    uint32_t ticks;
+    do {
+        ms = HAL_GetTick();
+        ticks = SysTick->VAL;
+    } while (ms != HAL_GetTick());
+    uint32_t load = SysTick->LOAD + 1;
+    return ms * 1000 + (uint32_t)((uint64_t)(load - ticks) * HAL_GetTickFreq() * 1000 / load);
+#elif defined(EEZ_PLATFORM_ESP32)
+	return (uint32_t)esp_timer_get_time();
+#elif defined(EEZ_PLATFORM_PICO)
+    return time_us_32();
+#elif defined(EEZ_PLATFORM_RASPBERRY)
+    return CTimer::Get()->GetClockTicks();
+#elif defined(EEZ_FOR_LVGL) && (defined(__linux__) || defined(__APPLE__) || defined(_WIN32))
+    return (uint32_t)(uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+    return millis() * 1000;
+#endif
+}
 } 
 // -----------------------------------------------------------------------------
 // core/unit.cpp
@@ -841,33 +1186,62 @@ static Unit getDerivedUnit(Unit unit, float factor) {
 	return UNIT_UNKNOWN;
 }
 static const float FACTORS[] = { 1E-12F, 1E-9F, 1E-6F, 1E-3F, 1E0F, 1E3F, 1E6F, 1E9F, 1E12F };
-Unit findDerivedUnit(float value, Unit unit) {
-	Unit result;
-	for (int factorIndex = 1; ; factorIndex++) {
-		float factor = FACTORS[factorIndex];
-		if (factor > 1.0F) {
-			break;
-		}
-		if (value < factor) {
-			result = getDerivedUnit(unit, FACTORS[factorIndex - 1]);
+static const int NUM_FACTORS = sizeof(FACTORS) / sizeof(float);
+static const int NUM_UNITS = sizeof(g_baseUnit) / sizeof(Unit);
+static const int FACTOR_ONE_INDEX = 4;
+static uint8_t g_derivedUnitTable[NUM_UNITS][NUM_FACTORS];
+static bool g_derivedUnitTableInitialized;
+static Unit findDerivedUnitInBucket(Unit unit, int bucket) {
+	if (bucket < FACTOR_ONE_INDEX) {
+		for (int factorIndex = bucket; factorIndex < FACTOR_ONE_INDEX; factorIndex++) {
+			Unit result = getDerivedUnit(unit, FACTORS[factorIndex]);
 			if (result != UNIT_UNKNOWN) {
 				return result;
 			}
 		}
-	}
-	for (int factorIndex = sizeof(FACTORS) / sizeof(float) - 1; factorIndex >= 0; factorIndex--) {
-		float factor = FACTORS[factorIndex];
-		if (factor == 1.0F) {
-			break;
-		}
-		if (value >= factor) {
-			result = getDerivedUnit(unit, factor);
+	} else {
+		for (int factorIndex = bucket; factorIndex > FACTOR_ONE_INDEX; factorIndex--) {
+			Unit result = getDerivedUnit(unit, FACTORS[factorIndex]);
 			if (result != UNIT_UNKNOWN) {
 				return result;
 			}
 		}
 	}
-	return unit;
+	return UNIT_UNKNOWN;
+}
+static void initDerivedUnitTable() {
+	for (int unit = 0; unit < NUM_UNITS; unit++) {
+		for (int bucket = 0; bucket < NUM_FACTORS; bucket++) {
+			g_derivedUnitTable[unit][bucket] = (uint8_t)findDerivedUnitInBucket((Unit)unit, bucket);
+		}
+	}
+	g_derivedUnitTableInitialized = true;
+}
+static inline int getFactorBucket(float value) {
+	int bucket = 0;
+	if (value >= FACTORS[4]) {
+		bucket = 4;
+	}
+	if (value >= FACTORS[bucket + 2]) {
+		bucket += 2;
+	}
+	if (value >= FACTORS[bucket + 1]) {
+		bucket += 1;
+	}
+	if (bucket == 7 && value >= FACTORS[8]) {
+		bucket = 8;
+	}
+	return bucket;
+}
+Unit findDerivedUnit(float value, Unit unit) {
+	if (unit == UNIT_UNKNOWN || isNaN(value)) {
+		return unit;
+	}
+	if (!g_derivedUnitTableInitialized) {
+		initDerivedUnitTable();
+	}
+	Unit result = (Unit)g_derivedUnitTable[unit][getFactorBucket(value)];
+	return result != UNIT_UNKNOWN ? result : unit;
 }
 static float getSmallerFactor(float factor) {
 	for (int factorIndex = sizeof(FACTORS) / sizeof(float) - 1; factorIndex > 0; factorIndex--) {
@@ -1014,21 +1388,179 @@ void stringAppendUInt64(char *str, size_t maxStrLength, uint64_t value) {
     auto n = strlen(str);
     snprintf(str + n, maxStrLength - n, "%ju", value);
 }
+static const int MAX_FAST_FORMAT_DECIMALS = 40;
+static bool splitDouble(double value, bool &negative, uint64_t &integerPart, uint64_t &fraction, int &fractionBits) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    negative = (bits >> 63) != 0;
+    int exponent = (int)((bits >> 52) & 0x7FF);
+    if (exponent == 0 || exponent == 0x7FF) {
+        if ((bits & 0x7FFFFFFFFFFFFFFFULL) == 0) {
+            integerPart = 0;
+            fraction = 0;
+            fractionBits = 0;
+            return true;
+        }
+        return false;
+    }
+    uint64_t mantissa = (bits & 0xFFFFFFFFFFFFFULL) | 0x10000000000000ULL;
+    int shift = 1075 - exponent;
+    if (shift < 0) {
+        return false;
+    }
+    if (shift >= 64) {
+        integerPart = 0;
+        fraction = mantissa;
+    } else {
+        integerPart = mantissa >> shift;
+        fraction = mantissa & ((1ULL << shift) - 1);
+    }
+    if (fraction == 0) {
+        shift = 0;
+    } else {
+        while ((fraction & 1) == 0) {
+            fraction >>= 1;
+            shift--;
+        }
+    }
+    if (shift > 60) {
+        return false;
+    }
+    fractionBits = shift;
+    return true;
+}
+static int formatUInt64(char *buf, uint64_t value) {
+    char digits[20];
+    int n = 0;
+    do {
+        digits[n++] = '0' + (char)(value % 10);
+        value /= 10;
+    } while (value);
+    for (int i = 0; i < n; i++) {
+        buf[i] = digits[n - 1 - i];
+    }
+    return n;
+}
+static int formatFixedExact(char *buf, bool negative, uint64_t integerPart, uint64_t fraction, int fractionBits, int numDecimalPlaces) {
+    char decimals[MAX_FAST_FORMAT_DECIMALS];
+    uint64_t mask = fractionBits > 0 ? (1ULL << fractionBits) - 1 : 0;
+    for (int i = 0; i < numDecimalPlaces; i++) {
+        fraction *= 10;
+        decimals[i] = '0' + (char)(fraction >> fractionBits);
+        fraction &= mask;
+    }
+    if (fractionBits > 0) {
+        uint64_t half = 1ULL << (fractionBits - 1);
+        bool lastDigitOdd = numDecimalPlaces > 0 ? ((decimals[numDecimalPlaces - 1] - '0') & 1) : (integerPart & 1);
+        if (fraction > half || (fraction == half && lastDigitOdd)) {
+            int i;
+            for (i = numDecimalPlaces - 1; i >= 0 && decimals[i] == '9'; i--) {
+                decimals[i] = '0';
+            }
+            if (i >= 0) {
+                decimals[i]++;
+            } else {
+                integerPart++;
+            }
+        }
+    }
+    int n = 0;
+    if (negative) {
+        buf[n++] = '-';
+    }
+    n += formatUInt64(buf + n, integerPart);
+    if (numDecimalPlaces > 0) {
+        buf[n++] = '.';
+        memcpy(buf + n, decimals, numDecimalPlaces);
+        n += numDecimalPlaces;
+    }
+    buf[n] = 0;
+    return n;
+}
+static int copyFormatted(char *str, size_t strSize, const char *formatted, int length) {
+    if (strSize > 0) {
+        size_t n = MIN((size_t)length, strSize - 1);
+        memcpy(str, formatted, n);
+        str[n] = 0;
+    }
+    return length;
+}
+int formatDoubleFixed(char *str, size_t strSize, double value, int numDecimalPlaces) {
+    bool negative;
+    uint64_t integerPart;
+    uint64_t fraction;
+    int fractionBits;
+    if (numDecimalPlaces >= 0 && numDecimalPlaces <= MAX_FAST_FORMAT_DECIMALS && splitDouble(value, negative, integerPart, fraction, fractionBits)) {
+        char buf[24 + MAX_FAST_FORMAT_DECIMALS];
+        int n = formatFixedExact(buf, negative, integerPart, fraction, fractionBits, numDecimalPlaces);
+        return copyFormatted(str, strSize, buf, n);
+    }
+    return snprintf(str, strSize, "%.*f", numDecimalPlaces, value);
+}
+int formatDouble(char *str, size_t strSize, double value) {
+    static const int PRECISION = 6;
+    bool negative;
+    uint64_t integerPart;
+    uint64_t fraction;
+    int fractionBits;
+    if (splitDouble(value, negative, integerPart, fraction, fractionBits)) {
+        int exponent;
+        if (integerPart > 0) {
+            exponent = -1;
+            for (uint64_t i = integerPart; i; i /= 10) {
+                exponent++;
+            }
+        } else if (fraction > 0) {
+            uint64_t f = fraction;
+            uint64_t mask = (1ULL << fractionBits) - 1;
+            exponent = -1;
+            for (;;) {
+                f *= 10;
+                if ((f >> fractionBits) != 0 || exponent < -4) {
+                    break;
+                }
+                f &= mask;
+                exponent--;
+            }
+        } else {
+            exponent = 0;
+        }
+        if (exponent >= -4 && exponent < PRECISION) {
+            char buf[24 + MAX_FAST_FORMAT_DECIMALS];
+            int n = formatFixedExact(buf, negative, integerPart, fraction, fractionBits, PRECISION - 1 - exponent);
+            const char *integerDigits = negative ? buf + 1 : buf;
+            const char *decimalPoint = strchr(integerDigits, '.');
+            if (exponent < PRECISION - 1 || (decimalPoint ? decimalPoint - integerDigits : n - (integerDigits - buf)) <= PRECISION) {
+                if (decimalPoint) {
+                    while (buf[n - 1] == '0') {
+                        n--;
+                    }
+                    if (buf[n - 1] == '.') {
+                        n--;
+                    }
+                    buf[n] = 0;
+                }
+                return copyFormatted(str, strSize, buf, n);
+            }
+        }
+    }
+    return snprintf(str, strSize, "%g", value);
+}
 void stringAppendFloat(char *str, size_t maxStrLength, float value) {
     auto n = strlen(str);
-    snprintf(str + n, maxStrLength - n, "%g", value);
+    formatDouble(str + n, maxStrLength - n, value);
 }
 void stringAppendFloat(char *str, size_t maxStrLength, float value, int numDecimalPlaces) {
     auto n = strlen(str);
-    snprintf(str + n, maxStrLength - n, "%.*f", numDecimalPlaces, value);
+    formatDoubleFixed(str + n, maxStrLength - n, value, numDecimalPlaces);
 }
 void stringAppendDouble(char *str, size_t maxStrLength, double value) {
     auto n = strlen(str);
-    snprintf(str + n, maxStrLength - n, "%g", value);
+    formatDouble(str + n, maxStrLength - n, value);
 }
 void stringAppendDouble(char *str, size_t maxStrLength, double value, int numDecimalPlaces) {
     auto n = strlen(str);
-    snprintf(str + n, maxStrLength - n, "%.*f", numDecimalPlaces, value);
+    formatDoubleFixed(str + n, maxStrLength - n, value, numDecimalPlaces);
 }
 void stringAppendVoltage(char *str, size_t maxStrLength, float value) {
     auto n = strlen(str);
@@ -1464,6 +1996,14 @@ void getBaseFileName(const char *path, char *baseName, unsigned baseNameSize) {
     }
     baseName[n] = 0;
 }
+uint32_t hashName(const char *name) {
+    uint32_t hash = 2166136261u;
+    for (const uint8_t *p = (const uint8_t *)name; *p; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
 } 
 #if defined(M_PI)
 static const float PI_FLOAT = (float)M_PI;
@@ -2730,9 +3270,9 @@ Value Value::toString(uint32_t id) const {
 #pragma warning(disable : 4474)
 #endif
     if (type == VALUE_TYPE_DOUBLE) {
-        snprintf(tempStr, sizeof(tempStr), "%g", doubleValue);
+        formatDouble(tempStr, sizeof(tempStr), doubleValue);
     } else if (type == VALUE_TYPE_FLOAT) {
-        snprintf(tempStr, sizeof(tempStr), "%g", floatValue);
+        formatDouble(tempStr, sizeof(tempStr), floatValue);
     } else if (type == VALUE_TYPE_INT8) {
         snprintf(tempStr, sizeof(tempStr), "%" PRId8 "", int8Value);
     } else if (type == VALUE_TYPE_UINT8) {
@@ -2787,6 +3327,23 @@ Value Value::makeStringRef(const char *str, int len, uint32_t id) {
     value.refValue = stringRef;
 	return value;
 }
+Value Value::makeStringSlice(const Value &parent, int offset, uint32_t id) {
+    if (offset == 0) {
+        return parent;
+    }
+    auto stringSliceRef = ObjectAllocator<StringSliceRef>::allocate(id);
+	if (stringSliceRef == nullptr) {
+		return Value(0, VALUE_TYPE_NULL);
+	}
+    stringSliceRef->str = (char *)parent.getString() + offset;
+    stringSliceRef->parent = parent;
+    stringSliceRef->refCounter = 1;
+    Value value;
+    value.type = VALUE_TYPE_STRING_REF;
+    value.options = VALUE_OPTIONS_REF;
+    value.refValue = stringSliceRef;
+	return value;
+}
 Value Value::concatenateString(const Value &str1, const Value &str2) {
     auto stringRef = ObjectAllocator<StringRef>::allocate(0xbab14c6a);;
 	if (stringRef == nullptr) {
@@ -3135,6 +3692,9 @@ void registerComponent(ComponentTypes componentType, ExecuteComponentFunctionTyp
 	}
 }
 void executeComponent(FlowState *flowState, unsigned componentIndex) {
+#if EEZ_OPTION_FLOW_PROFILER
+    ProfilerScope profilerScope(flowState, componentIndex, -1);
+#endif
 	auto component = flowState->flow->components[componentIndex];
 	if (component->type >= defs_v3::FIRST_DASHBOARD_ACTION_COMPONENT_TYPE) {
 #if defined(EEZ_DASHBOARD_API)
@@ -3280,7 +3840,7 @@ void executeCallAction(FlowState *flowState, unsigned componentIndex, int flowIn
             }
             auto propValuePtr = actionFlowState->values + actionFlowState->flow->componentInputs.count + i;
             *propValuePtr = value;
-            onValueChanged(propValuePtr);
+            onValueChanged(actionFlowState, propValuePtr);
         }
     }
 	if (canFreeFlowState(actionFlowState)) {
@@ -3701,6 +4261,7 @@ void executeLineChartWidgetComponent(FlowState *flowState, unsigned componentInd
             executionState->numPoints = 0;
             for (uint32_t elementIndex = 0; elementIndex < array->arraySize; elementIndex++) {
                 flowState->values[valueInputIndexInFlow] = array->values[elementIndex];
+                markValueChanged(flowState, &flowState->values[valueInputIndexInFlow]);
                 if (executionState->onInputValue(flowState, componentIndex)) {
                     updated = true;
                 } else {
@@ -4817,7 +5378,7 @@ LVGLUserWidgetExecutionState *createUserWidgetFlowState(FlowState *flowState, un
         Value value = Value::makePropertyRef(flowState, userWidgetWidgetComponentIndex, i, 0x5166d8a4);
         auto propValuePtr = userWidgetFlowState->values + userWidgetFlowState->flow->componentInputs.count + (i - offset);
         *propValuePtr = value;
-        onValueChanged(propValuePtr);
+        onValueChanged(userWidgetFlowState, propValuePtr);
     }
     auto userWidgetWidgetExecutionState = allocateComponentExecutionState<LVGLUserWidgetExecutionState>(flowState, userWidgetWidgetComponentIndex);
     userWidgetWidgetExecutionState->flowState = userWidgetFlowState;
@@ -5601,60 +6162,182 @@ void executeShowPageComponent(FlowState *flowState, unsigned componentIndex) {
 // -----------------------------------------------------------------------------
 #include <string.h>
 #include <stdlib.h>
+#include <math.h>
+#include <algorithm>
 namespace eez {
 namespace flow {
-SortArrayActionComponent *g_sortArrayActionComponent;
-static int elementCompare(const void *a, const void *b) {
-    auto aValue = *(const Value *)a;
-    auto bValue = *(const Value *)b;
-    if (g_sortArrayActionComponent->arrayType != -1) {
-        if (!aValue.isArray()) {
-            return 0;
+#define SORT_KEY_HAS_STRING (1 << 0)
+#define SORT_KEY_HAS_NUMBER (1 << 1)
+#define SORT_KEY_HAS_PREFIX (1 << 2)
+#define SORT_KEY_SHORT      (1 << 3)
+struct SortArrayLevel {
+    int32_t structFieldIndex;
+    uint32_t flags;
+    bool numeric;
+};
+struct SortArrayKey {
+    uint64_t prefix;
+    const char *str;
+    double num;
+    uint32_t flags;
+};
+struct SortArrayContext {
+    SortArrayLevel *levels;
+    uint32_t numLevels;
+    SortArrayKey *keys;
+};
+static void makeStringPrefix(SortArrayKey &key, bool ignoreCase) {
+    uint64_t prefix = 0;
+    int i;
+    for (i = 0; i < 8; i++) {
+        uint8_t c = (uint8_t)key.str[i];
+        if (c == 0) {
+            key.flags |= SORT_KEY_SHORT;
+            break;
         }
-        auto aArray = aValue.getArray();
-        if ((uint32_t)g_sortArrayActionComponent->structFieldIndex >= aArray->arraySize) {
-            return 0;
+        if (c >= 0x80) {
+            return;
         }
-        aValue = aArray->values[g_sortArrayActionComponent->structFieldIndex];
-        if (!bValue.isArray()) {
-            return 0;
+        if (ignoreCase && c >= 'A' && c <= 'Z') {
+            c += 'a' - 'A';
         }
-        auto bArray = bValue.getArray();
-        if ((uint32_t)g_sortArrayActionComponent->structFieldIndex >= bArray->arraySize) {
-            return 0;
+        prefix |= (uint64_t)c << (56 - 8 * i);
+    }
+    key.prefix = prefix;
+    key.flags |= SORT_KEY_HAS_PREFIX;
+}
+static void extractKey(SortArrayActionComponent *component, const SortArrayLevel &level, Value *value, bool convertStrings, SortArrayKey &key) {
+    key.prefix = 0;
+    key.str = nullptr;
+    key.num = 0;
+    key.flags = 0;
+    if (component->arrayType != -1) {
+        if (!value->isArray()) {
+            return;
+        }
+        auto structArray = value->getArray();
+        if ((uint32_t)level.structFieldIndex >= structArray->arraySize) {
+            return;
         }
-        bValue = bArray->values[g_sortArrayActionComponent->structFieldIndex];
+        value = &structArray->values[level.structFieldIndex];
     }
-    int result;
-    if (aValue.isString() && bValue.isString()) {
-        if (g_sortArrayActionComponent->flags & SORT_ARRAY_FLAG_IGNORE_CASE) {
-            result = utf8casecmp(aValue.getString(), bValue.getString());
-        } else {
-            result = utf8cmp(aValue.getString(), bValue.getString());
+    if (value->isString()) {
+        key.str = value->getString();
+        key.flags |= SORT_KEY_HAS_STRING;
+        makeStringPrefix(key, level.flags & SORT_ARRAY_FLAG_IGNORE_CASE);
+        if (!convertStrings) {
+            return;
         }
-    } else {
-        int err;
-        float aDouble = aValue.toDouble(&err);
-        if (err) {
-            return 0;
+    }
+    int err;
+    key.num = value->toDouble(&err);
+    if (!err && !isnan(key.num)) {
+        key.flags |= SORT_KEY_HAS_NUMBER;
+    }
+}
+static int compareStringKeys(const SortArrayKey &a, const SortArrayKey &b, bool ignoreCase) {
+    if ((a.flags & SORT_KEY_HAS_PREFIX) && (b.flags & SORT_KEY_HAS_PREFIX)) {
+        if (a.prefix != b.prefix) {
+            return a.prefix < b.prefix ? -1 : 1;
         }
-        float bDouble = bValue.toDouble(&err);
-        if (err) {
+        if ((a.flags & SORT_KEY_SHORT) || (b.flags & SORT_KEY_SHORT)) {
             return 0;
         }
-        auto diff = aDouble - bDouble;
-        result = diff < 0 ? -1 : diff > 0 ? 1 : 0;
+        return ignoreCase ? utf8casecmp(a.str + 8, b.str + 8) : utf8cmp(a.str + 8, b.str + 8);
+    }
+    return ignoreCase ? utf8casecmp(a.str, b.str) : utf8cmp(a.str, b.str);
+}
+static int compareKeys(const SortArrayKey &a, const SortArrayKey &b, const SortArrayLevel &level) {
+    auto flags = level.flags;
+    int result;
+    if (!level.numeric) {
+        result = compareStringKeys(a, b, flags & SORT_ARRAY_FLAG_IGNORE_CASE);
+    } else {
+        bool aValid = a.flags & SORT_KEY_HAS_NUMBER;
+        bool bValid = b.flags & SORT_KEY_HAS_NUMBER;
+        if (!aValid || !bValid) {
+            return aValid == bValid ? 0 : aValid ? -1 : 1;
+        }
+        result = a.num < b.num ? -1 : a.num > b.num ? 1 : 0;
     }
-    if (!(g_sortArrayActionComponent->flags & SORT_ARRAY_FLAG_ASCENDING)) {
+    if (!(flags & SORT_ARRAY_FLAG_ASCENDING)) {
         result = -result;
     }
     return result;
 }
-void sortArray(SortArrayActionComponent *component, ArrayValue *array) {
-    g_sortArrayActionComponent = component;
-    qsort(&array->values[0], array->arraySize, sizeof(Value), elementCompare);
-}
-void executeSortArrayComponent(FlowState *flowState, unsigned componentIndex) {
+bool sortArray(SortArrayActionComponent *component, ArrayValue *array) {
+    uint32_t arraySize = array->arraySize;
+    if (arraySize < 2) {
+        return true;
+    }
+    SortArrayContext context;
+    context.numLevels = 1;
+    if (component->arrayType != -1 && (component->flags & SORT_ARRAY_FLAG_THEN_BY)) {
+        context.numLevels += component->thenBy.count;
+    }
+    context.levels = (SortArrayLevel *)alloc(context.numLevels * sizeof(SortArrayLevel), 0x2f6e1c8a);
+    context.keys = (SortArrayKey *)alloc((size_t)arraySize * context.numLevels * sizeof(SortArrayKey), 0x7b3d52e1);
+    auto order = (uint32_t *)alloc(arraySize * sizeof(uint32_t), 0x94c0a7f3);
+    auto sortedValues = (Value *)alloc(arraySize * sizeof(Value), 0x5a81e2d6);
+    if (!context.levels || !context.keys || !order || !sortedValues) {
+        free(context.levels);
+        free(context.keys);
+        free(order);
+        free(sortedValues);
+        return false;
+    }
+    context.levels[0].structFieldIndex = component->structFieldIndex;
+    context.levels[0].flags = component->flags;
+    for (uint32_t levelIndex = 1; levelIndex < context.numLevels; levelIndex++) {
+        auto thenBy = component->thenBy[levelIndex - 1];
+        context.levels[levelIndex].structFieldIndex = thenBy->structFieldIndex;
+        context.levels[levelIndex].flags = thenBy->flags;
+    }
+    for (uint32_t levelIndex = 0; levelIndex < context.numLevels; levelIndex++) {
+        auto &level = context.levels[levelIndex];
+        bool convertStrings = false;
+        for (uint32_t i = 0; i < arraySize; i++) {
+            auto &key = context.keys[i * context.numLevels + levelIndex];
+            extractKey(component, level, &array->values[i], false, key);
+            if (!(key.flags & SORT_KEY_HAS_STRING)) {
+                convertStrings = true;
+            }
+        }
+        level.numeric = convertStrings;
+        if (convertStrings) {
+            for (uint32_t i = 0; i < arraySize; i++) {
+                auto &key = context.keys[i * context.numLevels + levelIndex];
+                if (key.flags & SORT_KEY_HAS_STRING) {
+                    extractKey(component, level, &array->values[i], true, key);
+                }
+            }
+        }
+    }
+    for (uint32_t i = 0; i < arraySize; i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order, order + arraySize, [&context](uint32_t a, uint32_t b) {
+        auto aKeys = context.keys + a * context.numLevels;
+        auto bKeys = context.keys + b * context.numLevels;
+        for (uint32_t levelIndex = 0; levelIndex < context.numLevels; levelIndex++) {
+            int result = compareKeys(aKeys[levelIndex], bKeys[levelIndex], context.levels[levelIndex]);
+            if (result != 0) {
+                return result < 0;
+            }
+        }
+        return false;
+    });
+    for (uint32_t i = 0; i < arraySize; i++) {
+        memcpy((void *)&sortedValues[i], (void *)&array->values[order[i]], sizeof(Value));
+    }
+    memcpy((void *)&array->values[0], (void *)sortedValues, arraySize * sizeof(Value));
+    free(context.levels);
+    free(context.keys);
+    free(order);
+    free(sortedValues);
+    return true;
+}
+void executeSortArrayComponent(FlowState *flowState, unsigned componentIndex) {
     auto component = (SortArrayActionComponent *)flowState->flow->components[componentIndex];
     Value srcArrayValue;
     if (!evalProperty(flowState, componentIndex, defs_v3::SORT_ARRAY_ACTION_COMPONENT_PROPERTY_ARRAY, srcArrayValue, FlowError::Property("SortArray", "Array"))) {
@@ -5680,7 +6363,10 @@ void executeSortArrayComponent(FlowState *flowState, unsigned componentIndex) {
             return;
         }
     }
-    sortArray(component, array);
+    if (!sortArray(component, array)) {
+        throwError(flowState, componentIndex, FlowError::Plain("SortArray: out of memory\n"));
+        return;
+    }
 	propagateValue(flowState, componentIndex, component->outputs.count - 1, arrayValue);
 }
 } 
@@ -5791,9 +6477,7 @@ namespace date {
 #define SECONDS_PER_MINUTE 60UL
 #define SECONDS_PER_HOUR (SECONDS_PER_MINUTE * 60)
 #define SECONDS_PER_DAY (SECONDS_PER_HOUR * 24)
-#define LEAP_YEAR(Y)                                                                               \
-    (((1970 + Y) > 0) && !((1970 + Y) % 4) && (((1970 + Y) % 100) || !((1970 + Y) % 400)))
-static const uint8_t monthDays[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+#define MILLISECONDS_PER_DAY (SECONDS_PER_DAY * 1000)
 enum Week { Last, First, Second, Third, Fourth };
 enum DayOfWeek { Sun = 1, Mon, Tue, Wed, Thu, Fri, Sat };
 enum Month { Jan = 1, Feb, Mar, Apr, May, Jun, Jul, Aug, Sep, Oct, Nov, Dec };
@@ -5814,6 +6498,12 @@ static struct {
 Format g_localeFormat = FORMAT_DMY_24;
 int g_timeZone = 0;
 DstRule g_dstRule = DST_RULE_OFF;
+static struct {
+    DstRule dstRule;
+    int year;
+    Date dstStart;
+    Date dstEnd;
+} g_dstCache = { DST_RULE_OFF, 0, 0, 0 };
 static void convertTime24to12(int &hours, bool &am);
 static bool isDst(Date time, DstRule dstRule);
 static uint8_t dayOfWeek(int y, int m, int d);
@@ -5848,70 +6538,45 @@ Date fromString(const char *str) {
     sscanf(str, "%d-%d-%dT%d:%d:%d.%d", &year, &month, &day, &hours, &minutes, &seconds, &milliseconds);
     return makeDate(year, month, day, hours, minutes, seconds, milliseconds);
 }
+static int64_t daysFromCivil(int64_t y, int64_t m, int64_t d) {
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yoe = y - era * 400;
+    int64_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+static void civilFromDays(int64_t z, int &year, int &month, int &day) {
+    z += 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int64_t doe = z - era * 146097;
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int64_t mp = (5 * doy + 2) / 153;
+    day = (int)(doy - (153 * mp + 2) / 5 + 1);
+    month = (int)(mp < 10 ? mp + 3 : mp - 9);
+    year = (int)(yoe + era * 400 + (month <= 2));
+}
+static inline int64_t floorDiv(int64_t a, int64_t b) {
+    return a / b - (a % b < 0);
+}
 Date makeDate(int year, int month, int day, int hours, int minutes, int seconds, int milliseconds) {
-    year -= 1970;
-    Date time = year * 365 * SECONDS_PER_DAY;
-    for (int i = 0; i < year; i++) {
-        if (LEAP_YEAR(i)) {
-            time += SECONDS_PER_DAY; 
-        }
-    }
-    for (int i = 1; i < month; i++) {
-        if ((i == 2) && LEAP_YEAR(year)) {
-            time += SECONDS_PER_DAY * 29;
-        } else {
-            time += SECONDS_PER_DAY * monthDays[i - 1]; 
-        }
-    }
-    time += (day - 1) * SECONDS_PER_DAY;
-    time += hours * SECONDS_PER_HOUR;
-    time += minutes * SECONDS_PER_MINUTE;
-    time += seconds;
-    time *= 1000;
-    time += milliseconds;
-    return time;
+    int64_t monthIndex = month - 1;
+    int64_t years = floorDiv(monthIndex, 12);
+    int64_t days = daysFromCivil(year + years, monthIndex - years * 12 + 1, 1) + day - 1;
+    int64_t time = ((days * 24 + hours) * 60 + minutes) * 60 + seconds;
+    return (Date)(time * 1000 + milliseconds);
 }
 void breakDate(Date time, int &result_year, int &result_month, int &result_day, int &result_hours, int &result_minutes, int &result_seconds, int &result_milliseconds) {
-    uint8_t year;
-    uint8_t month, monthLength;
-    uint32_t days;
-    result_milliseconds = time % 1000;
-    time /= 1000; 
-    result_seconds = time % 60;
-    time /= 60; 
-    result_minutes = time % 60;
-    time /= 60; 
-    result_hours = time % 24;
-    time /= 24; 
-    year = 0;
-    days = 0;
-    while ((unsigned)(days += (LEAP_YEAR(year) ? 366 : 365)) <= time) {
-        year++;
-    }
-    result_year = year + 1970; 
-    days -= LEAP_YEAR(year) ? 366 : 365;
-    time -= days; 
-    days = 0;
-    month = 0;
-    monthLength = 0;
-    for (month = 0; month < 12; ++month) {
-        if (month == 1) { 
-            if (LEAP_YEAR(year)) {
-                monthLength = 29;
-            } else {
-                monthLength = 28;
-            }
-        } else {
-            monthLength = monthDays[month];
-        }
-        if (time >= monthLength) {
-            time -= monthLength;
-        } else {
-            break;
-        }
-    }
-    result_month = month + 1; 
-    result_day = time + 1;    
+    int64_t days = floorDiv((int64_t)time, MILLISECONDS_PER_DAY);
+    int64_t timeOfDay = (int64_t)time - days * (int64_t)MILLISECONDS_PER_DAY;
+    result_milliseconds = (int)(timeOfDay % 1000);
+    timeOfDay /= 1000;
+    result_seconds = (int)(timeOfDay % 60);
+    timeOfDay /= 60;
+    result_minutes = (int)(timeOfDay % 60);
+    result_hours = (int)(timeOfDay / 60);
+    civilFromDays(days, result_year, result_month, result_day);
 }
 int getYear(Date time) {
     int year, month, day, hours, minutes, seconds, milliseconds;
@@ -5979,10 +6644,16 @@ static bool isDst(Date local, DstRule dstRule) {
     if (dstRule == DST_RULE_OFF) {
         return false;
     }
-    int year, month, day, hours, minutes, seconds, milliseconds;
-    breakDate(local, year, month, day, hours, minutes, seconds, milliseconds);
-    Date dstStart = timeChangeRuleToLocal(g_dstRules[dstRule - 1].dstStart, year);
-    Date dstEnd = timeChangeRuleToLocal(g_dstRules[dstRule - 1].dstEnd, year);
+    int year, month, day;
+    civilFromDays(floorDiv((int64_t)local, MILLISECONDS_PER_DAY), year, month, day);
+    if (g_dstCache.dstRule != dstRule || g_dstCache.year != year) {
+        g_dstCache.dstRule = dstRule;
+        g_dstCache.year = year;
+        g_dstCache.dstStart = timeChangeRuleToLocal(g_dstRules[dstRule - 1].dstStart, year);
+        g_dstCache.dstEnd = timeChangeRuleToLocal(g_dstRules[dstRule - 1].dstEnd, year);
+    }
+    Date dstStart = g_dstCache.dstStart;
+    Date dstEnd = g_dstCache.dstEnd;
     return (dstStart < dstEnd && (local >= dstStart && local < dstEnd)) ||
            (dstStart > dstEnd && (local >= dstStart || local < dstEnd));
 }
@@ -6005,9 +6676,9 @@ static Date timeChangeRuleToLocal(TimeChangeRule &r, int year) {
     }
     Date time = makeDate(year, month, 1, r.hours, 0, 0, 0);
     uint8_t dow = dayOfWeek(year, month, 1);
-    time += (7 * (week - 1) + (r.dow - dow + 7) % 7) * SECONDS_PER_DAY;
+    time += (7 * (week - 1) + (r.dow - dow + 7) % 7) * MILLISECONDS_PER_DAY;
     if (r.week == 0) {
-        time -= 7 * SECONDS_PER_DAY; 
+        time -= 7 * MILLISECONDS_PER_DAY; 
     }
     return time;
 }
@@ -6020,10 +6691,25 @@ static Date timeChangeRuleToLocal(TimeChangeRule &r, int year) {
 #include <assert.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdarg.h>
 #include <inttypes.h>
 namespace eez {
 namespace flow {
 #define MAX_ARRAY_SIZE_TRANSFERRED_IN_DEBUGGER 1000
+#if !defined(EEZ_FLOW_DEBUGGER_COALESCED_VALUES_SIZE)
+#if defined(__EMSCRIPTEN__)
+#define EEZ_FLOW_DEBUGGER_COALESCED_VALUES_SIZE 1024
+#else
+#define EEZ_FLOW_DEBUGGER_COALESCED_VALUES_SIZE 64
+#endif
+#endif
+#if !defined(EEZ_FLOW_DEBUGGER_PAGED_VALUES_SIZE)
+#if defined(__EMSCRIPTEN__)
+#define EEZ_FLOW_DEBUGGER_PAGED_VALUES_SIZE 64
+#else
+#define EEZ_FLOW_DEBUGGER_PAGED_VALUES_SIZE 8
+#endif
+#endif
 enum MessagesToDebugger {
     MESSAGE_TO_DEBUGGER_STATE_CHANGED, 
     MESSAGE_TO_DEBUGGER_ADD_TO_QUEUE, 
@@ -6039,7 +6725,15 @@ enum MessagesToDebugger {
     MESSAGE_TO_DEBUGGER_LOG, 
 	MESSAGE_TO_DEBUGGER_PAGE_CHANGED, 
     MESSAGE_TO_DEBUGGER_COMPONENT_EXECUTION_STATE_CHANGED, 
-    MESSAGE_TO_DEBUGGER_COMPONENT_ASYNC_STATE_CHANGED 
+    MESSAGE_TO_DEBUGGER_COMPONENT_ASYNC_STATE_CHANGED, 
+    MESSAGE_TO_DEBUGGER_VALUES_CHANGED, 
+    MESSAGE_TO_DEBUGGER_PROTOCOL_CHANGED, 
+    MESSAGE_TO_DEBUGGER_QUEUE_STATS, 
+    MESSAGE_TO_DEBUGGER_QUEUE_RESET, 
+    MESSAGE_TO_DEBUGGER_ARRAY_PAGE, 
+    MESSAGE_TO_DEBUGGER_BLOB_PAGE, 
+    MESSAGE_TO_DEBUGGER_PROFILER_ENTRY, 
+    MESSAGE_TO_DEBUGGER_PROFILER_DATA_END 
 };
 enum MessagesFromDebugger {
     MESSAGE_FROM_DEBUGGER_RESUME, 
@@ -6049,7 +6743,14 @@ enum MessagesFromDebugger {
     MESSAGE_FROM_DEBUGGER_REMOVE_BREAKPOINT, 
     MESSAGE_FROM_DEBUGGER_ENABLE_BREAKPOINT, 
     MESSAGE_FROM_DEBUGGER_DISABLE_BREAKPOINT, 
-    MESSAGE_FROM_DEBUGGER_MODE 
+    MESSAGE_FROM_DEBUGGER_MODE, 
+    MESSAGE_FROM_DEBUGGER_PROTOCOL, 
+    MESSAGE_FROM_DEBUGGER_COALESCE, 
+    MESSAGE_FROM_DEBUGGER_PAGED_VALUES, 
+    MESSAGE_FROM_DEBUGGER_REQUEST_ARRAY_PAGE, 
+    MESSAGE_FROM_DEBUGGER_REQUEST_BLOB_PAGE, 
+    MESSAGE_FROM_DEBUGGER_PROFILER, 
+    MESSAGE_FROM_DEBUGGER_REQUEST_PROFILER_DATA 
 };
 enum LogItemType {
 	LOG_ITEM_TYPE_FATAL,
@@ -6065,9 +6766,53 @@ enum DebuggerState {
     DEBUGGER_STATE_SINGLE_STEP,
     DEBUGGER_STATE_STOPPED,
 };
+enum DebuggerProtocol {
+    DEBUGGER_PROTOCOL_TEXT,
+    DEBUGGER_PROTOCOL_BINARY
+};
+enum BinaryValueTag {
+    BINARY_VALUE_TAG_UNDEFINED,
+    BINARY_VALUE_TAG_NULL,
+    BINARY_VALUE_TAG_FALSE,
+    BINARY_VALUE_TAG_TRUE,
+    BINARY_VALUE_TAG_INT,
+    BINARY_VALUE_TAG_UINT,
+    BINARY_VALUE_TAG_FLOAT,
+    BINARY_VALUE_TAG_DOUBLE,
+    BINARY_VALUE_TAG_STRING,
+    BINARY_VALUE_TAG_ARRAY,
+    BINARY_VALUE_TAG_BLOB,
+    BINARY_VALUE_TAG_STREAM,
+    BINARY_VALUE_TAG_JSON,
+    BINARY_VALUE_TAG_DATE,
+    BINARY_VALUE_TAG_POINTER,
+    BINARY_VALUE_TAG_WIDGET,
+    BINARY_VALUE_TAG_EVENT,
+    BINARY_VALUE_TAG_UNKNOWN,
+    BINARY_VALUE_TAG_ARRAY_HANDLE,
+    BINARY_VALUE_TAG_BLOB_HANDLE
+};
 bool g_debuggerIsConnected;
 static uint32_t g_messageSubsciptionFilter = 0xFFFFFFFF;
 static DebuggerState g_debuggerState;
+static DebuggerProtocol g_debuggerProtocol = DEBUGGER_PROTOCOL_TEXT;
+static const unsigned COALESCED_VALUES_SIZE = EEZ_FLOW_DEBUGGER_COALESCED_VALUES_SIZE;
+static const Value * const COALESCED_VALUE_REMOVED = (const Value *)1;
+static struct {
+    const Value *pValue;
+    FlowState *flowState;
+} g_coalescedValues[COALESCED_VALUES_SIZE];
+static unsigned g_numCoalescedValues;
+static unsigned g_numCoalescedValuesRemoved;
+static uint32_t g_coalesceMaxUpdateRate;
+static uint32_t g_lastCoalescedFlushTime;
+static uint32_t g_numCoalescedAddsToQueue;
+static uint32_t g_numCoalescedRemovesFromQueue;
+static bool g_queueOutOfSync;
+static const unsigned PAGED_VALUES_SIZE = EEZ_FLOW_DEBUGGER_PAGED_VALUES_SIZE;
+static Value g_pagedValues[PAGED_VALUES_SIZE];
+static unsigned g_nextPagedValueIndex;
+static uint32_t g_debuggerPageSize;
 static bool g_skipNextBreakpoint;
 static char g_inputFromDebugger[64];
 static unsigned g_inputFromDebuggerPosition;
@@ -6075,6 +6820,23 @@ int g_debuggerMode = DEBUGGER_MODE_RUN;
 void setDebuggerMessageSubsciptionFilter(uint32_t filter) {
     g_messageSubsciptionFilter = filter;
 }
+#if defined(__EMSCRIPTEN__)
+char outputBuffer[1024 * 1024];
+#else
+char outputBuffer[64];
+#endif
+int outputBufferPosition = 0;
+#define WRITE_TO_OUTPUT_BUFFER(ch) \
+	outputBuffer[outputBufferPosition++] = ch; \
+	if (outputBufferPosition == sizeof(outputBuffer)) { \
+		writeDebuggerBufferHook(outputBuffer, outputBufferPosition); \
+		outputBufferPosition = 0; \
+	}
+#define FLUSH_OUTPUT_BUFFER() \
+	if (outputBufferPosition > 0) { \
+		writeDebuggerBufferHook(outputBuffer, outputBufferPosition); \
+		outputBufferPosition = 0; \
+	}
 static bool isSubscribedTo(MessagesToDebugger messageType) {
     if (g_debuggerIsConnected && (g_messageSubsciptionFilter & (1 << messageType)) != 0) {
         startToDebuggerMessageHook();
@@ -6082,33 +6844,468 @@ static bool isSubscribedTo(MessagesToDebugger messageType) {
     }
     return false;
 }
+static void writeValue(const Value &value);
+static void writeString(const char *str);
+static void sendValueChanged(const Value *pValue);
+static void flushCoalescedMessages();
+static void resetCoalescing();
+static void writeValueAddr(const void *pValue);
+static bool isPagedArray(const ArrayValue *arrayValue);
+static uint32_t registerPagedValue(const Value &value);
+static void resetPagedValues();
+static void sendArrayPage(const void *addr, uint32_t offset, uint32_t count);
+static void sendBlobPage(const void *addr, uint32_t offset, uint32_t count);
+static void sendProfilerData();
+static void writeLogMessage(const char *str, size_t len);
+static inline uint64_t zigzagEncode(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+struct BinarySizeCounter {
+    uint32_t size = 0;
+    void varint(uint64_t value) {
+        size++;
+        while (value >= 0x80) {
+            value >>= 7;
+            size++;
+        }
+    }
+    void bytes(const void *data, size_t length) {
+        EEZ_UNUSED(data);
+        size += length;
+    }
+};
+struct BinaryOutputWriter {
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            WRITE_TO_OUTPUT_BUFFER((char)(value | 0x80));
+            value >>= 7;
+        }
+        WRITE_TO_OUTPUT_BUFFER((char)value);
+    }
+    void bytes(const void *data, size_t length) {
+        for (size_t i = 0; i < length; i++) {
+            WRITE_TO_OUTPUT_BUFFER(((const char *)data)[i]);
+        }
+    }
+};
+template <typename Writer>
+static void writeBinaryValue(Writer &writer, const Value &value) {
+	switch (value.getType()) {
+	case VALUE_TYPE_UNDEFINED:
+        writer.varint(BINARY_VALUE_TAG_UNDEFINED);
+		break;
+	case VALUE_TYPE_NULL:
+        writer.varint(BINARY_VALUE_TAG_NULL);
+		break;
+	case VALUE_TYPE_BOOLEAN:
+        writer.varint(value.getBoolean() ? BINARY_VALUE_TAG_TRUE : BINARY_VALUE_TAG_FALSE);
+		break;
+	case VALUE_TYPE_INT8:
+        writer.varint(BINARY_VALUE_TAG_INT);
+        writer.varint(zigzagEncode(value.int8Value));
+		break;
+	case VALUE_TYPE_UINT8:
+        writer.varint(BINARY_VALUE_TAG_UINT);
+        writer.varint(value.uint8Value);
+		break;
+	case VALUE_TYPE_INT16:
+        writer.varint(BINARY_VALUE_TAG_INT);
+        writer.varint(zigzagEncode(value.int16Value));
+		break;
+	case VALUE_TYPE_UINT16:
+        writer.varint(BINARY_VALUE_TAG_UINT);
+        writer.varint(value.uint16Value);
+		break;
+	case VALUE_TYPE_INT32:
+        writer.varint(BINARY_VALUE_TAG_INT);
+        writer.varint(zigzagEncode(value.int32Value));
+		break;
+	case VALUE_TYPE_UINT32:
+        writer.varint(BINARY_VALUE_TAG_UINT);
+        writer.varint(value.uint32Value);
+		break;
+	case VALUE_TYPE_INT64:
+        writer.varint(BINARY_VALUE_TAG_INT);
+        writer.varint(zigzagEncode(value.int64Value));
+		break;
+	case VALUE_TYPE_UINT64:
+        writer.varint(BINARY_VALUE_TAG_UINT);
+        writer.varint(value.uint64Value);
+		break;
+	case VALUE_TYPE_DOUBLE:
+        writer.varint(BINARY_VALUE_TAG_DOUBLE);
+        writer.bytes(&value.doubleValue, sizeof(double));
+		break;
+	case VALUE_TYPE_FLOAT:
+        writer.varint(BINARY_VALUE_TAG_FLOAT);
+        writer.bytes(&value.floatValue, sizeof(float));
+		break;
+	case VALUE_TYPE_STRING:
+    case VALUE_TYPE_STRING_ASSET:
+	case VALUE_TYPE_STRING_REF:
+        {
+            auto str = value.getString();
+            auto len = strlen(str);
+            writer.varint(BINARY_VALUE_TAG_STRING);
+            writer.varint(len);
+            writer.bytes(str, len);
+        }
+		break;
+	case VALUE_TYPE_ARRAY:
+    case VALUE_TYPE_ARRAY_ASSET:
+	case VALUE_TYPE_ARRAY_REF:
+        {
+            auto arrayValue = value.getArray();
+            if (isPagedArray(arrayValue)) {
+                writer.varint(BINARY_VALUE_TAG_ARRAY_HANDLE);
+                writer.varint((uintptr_t)arrayValue);
+                writer.varint(arrayValue->arraySize);
+                writer.varint(arrayValue->arrayType);
+                writer.varint(registerPagedValue(value));
+                break;
+            }
+            auto transferredSize = arrayValue->arraySize > MAX_ARRAY_SIZE_TRANSFERRED_IN_DEBUGGER ? MAX_ARRAY_SIZE_TRANSFERRED_IN_DEBUGGER : arrayValue->arraySize;
+            writer.varint(BINARY_VALUE_TAG_ARRAY);
+            writer.varint((uintptr_t)arrayValue);
+            writer.varint(arrayValue->arraySize);
+            writer.varint(arrayValue->arrayType);
+            writer.varint(transferredSize);
+            for (uint32_t i = 0; i < transferredSize; i++) {
+                writer.varint((uintptr_t)&arrayValue->values[i]);
+            }
+        }
+		break;
+	case VALUE_TYPE_BLOB_REF:
+        if (g_debuggerPageSize > 0) {
+            writer.varint(BINARY_VALUE_TAG_BLOB_HANDLE);
+            writer.varint(((BlobRef *)value.refValue)->len);
+            writer.varint((uintptr_t)value.refValue);
+            writer.varint(registerPagedValue(value));
+            break;
+        }
+        writer.varint(BINARY_VALUE_TAG_BLOB);
+        writer.varint(((BlobRef *)value.refValue)->len);
+		break;
+	case VALUE_TYPE_STREAM:
+        writer.varint(BINARY_VALUE_TAG_STREAM);
+        writer.varint(zigzagEncode(value.int32Value));
+		break;
+	case VALUE_TYPE_JSON:
+        writer.varint(BINARY_VALUE_TAG_JSON);
+        writer.varint(zigzagEncode(value.int32Value));
+		break;
+	case VALUE_TYPE_DATE:
+        writer.varint(BINARY_VALUE_TAG_DATE);
+        writer.bytes(&value.doubleValue, sizeof(double));
+		break;
+    case VALUE_TYPE_POINTER:
+        writer.varint(BINARY_VALUE_TAG_POINTER);
+        writer.varint((uintptr_t)value.getVoidPointer());
+		break;
+	case VALUE_TYPE_WIDGET:
+        writer.varint(BINARY_VALUE_TAG_WIDGET);
+        writer.varint((uintptr_t)value.getVoidPointer());
+		break;
+	case VALUE_TYPE_EVENT:
+        writer.varint(BINARY_VALUE_TAG_EVENT);
+        writer.varint((uintptr_t)value.getVoidPointer());
+		break;
+	default:
+        writer.varint(BINARY_VALUE_TAG_UNKNOWN);
+		break;
+	}
+}
+static void writeArrayElements(const Value &value) {
+    auto valueType = value.getType();
+    if (valueType == VALUE_TYPE_ARRAY || valueType == VALUE_TYPE_ARRAY_ASSET || valueType == VALUE_TYPE_ARRAY_REF) {
+        auto arrayValue = value.getArray();
+        if (isPagedArray(arrayValue)) {
+            return;
+        }
+        auto transferredSize = arrayValue->arraySize > MAX_ARRAY_SIZE_TRANSFERRED_IN_DEBUGGER ? MAX_ARRAY_SIZE_TRANSFERRED_IN_DEBUGGER : arrayValue->arraySize;
+        for (uint32_t i = 0; i < transferredSize; i++) {
+            sendValueChanged(&arrayValue->values[i]);
+        }
+    }
+}
+class ToDebuggerMessage {
+public:
+    ToDebuggerMessage(MessagesToDebugger messageType) : m_buffer(m_inlineBuffer), m_capacity(sizeof(m_inlineBuffer)), m_length(0) {
+        if (g_debuggerProtocol == DEBUGGER_PROTOCOL_BINARY) {
+            appendVarint(messageType);
+        } else {
+            appendText("%d", (int)messageType);
+        }
+    }
+    ~ToDebuggerMessage() {
+        if (m_buffer != m_inlineBuffer) {
+            eez::free(m_buffer);
+        }
+    }
+    ToDebuggerMessage(const ToDebuggerMessage &) = delete;
+    ToDebuggerMessage &operator=(const ToDebuggerMessage &) = delete;
+    ToDebuggerMessage &writeInt(int32_t value) {
+        if (g_debuggerProtocol == DEBUGGER_PROTOCOL_BINARY) {
+            appendVarint(zigzagEncode(value));
+        } else {
+            appendText("\t%d", (int)value);
+        }
+        return *this;
+    }
+    ToDebuggerMessage &writeUnsigned(uint32_t value) {
+        if (g_debuggerProtocol == DEBUGGER_PROTOCOL_BINARY) {
+            appendVarint(value);
+        } else {
+            appendText("\t%u", (unsigned int)value);
+        }
+        return *this;
+    }
+    ToDebuggerMessage &writeAddr(const void *ptr) {
+        if (g_debuggerProtocol == DEBUGGER_PROTOCOL_BINARY) {
+            appendVarint((uintptr_t)ptr);
+        } else {
+            appendText("\t%p", ptr);
+        }
+        return *this;
+    }
+    ToDebuggerMessage &writeAddrs(const Value **pValues, unsigned count) {
+        if (g_debuggerProtocol == DEBUGGER_PROTOCOL_BINARY) {
+            appendVarint(count);
+            for (unsigned i = 0; i < count; i++) {
+                appendVarint((uintptr_t)pValues[i]);
+            }
+        } else {
+            appendText("\t");
+            for (unsigned i = 0; i < count; i++) {
+                appendText(i > 0 ? ",%p" : "%p", pValues[i]);
+            }
+        }
+        return *this;
+    }
+    ToDebuggerMessage &writeDouble(double value) {
+        if (g_debuggerProtocol == DEBUGGER_PROTOCOL_BINARY) {
+            if (reserve(sizeof(double))) {
+                memcpy(m_buffer + m_length, &value, sizeof(double));
+                m_length += sizeof(double);
+            }
+        } else {
+            char text[32];
+            formatDouble(text, sizeof(text), value);
+            appendText("\t%s", text);
+        }
+        return *this;
+    }
+    void send() {
+        if (g_debuggerProtocol == DEBUGGER_PROTOCOL_BINARY) {
+            writeRecordHeader(0);
+            FLUSH_OUTPUT_BUFFER();
+        } else {
+            appendText("\n");
+            writeDebuggerBufferHook(m_buffer, m_length);
+        }
+    }
+    void send(const Value &value) {
+        if (g_debuggerProtocol == DEBUGGER_PROTOCOL_BINARY) {
+            BinarySizeCounter counter;
+            writeBinaryValue(counter, value);
+            writeRecordHeader(counter.size);
+            BinaryOutputWriter writer;
+            writeBinaryValue(writer, value);
+            FLUSH_OUTPUT_BUFFER();
+            writeArrayElements(value);
+        } else {
+            appendText("\t");
+            writeDebuggerBufferHook(m_buffer, m_length);
+            writeValue(value);
+        }
+    }
+    void sendString(const char *str) {
+        if (g_debuggerProtocol == DEBUGGER_PROTOCOL_BINARY) {
+            sendBinaryString(nullptr, 0, str, strlen(str));
+        } else {
+            appendText("\t");
+            writeDebuggerBufferHook(m_buffer, m_length);
+            writeString(str);
+        }
+    }
+    void sendAddrList(const Value *values, uint32_t count) {
+        if (g_debuggerProtocol == DEBUGGER_PROTOCOL_BINARY) {
+            BinarySizeCounter counter;
+            counter.varint(count);
+            for (uint32_t i = 0; i < count; i++) {
+                counter.varint((uintptr_t)&values[i]);
+            }
+            writeRecordHeader(counter.size);
+            BinaryOutputWriter writer;
+            writer.varint(count);
+            for (uint32_t i = 0; i < count; i++) {
+                writer.varint((uintptr_t)&values[i]);
+            }
+            FLUSH_OUTPUT_BUFFER();
+        } else {
+            appendText("\t");
+            writeDebuggerBufferHook(m_buffer, m_length);
+            for (uint32_t i = 0; i < count; i++) {
+                if (i > 0) {
+                    WRITE_TO_OUTPUT_BUFFER(',');
+                }
+                writeValueAddr(&values[i]);
+            }
+            WRITE_TO_OUTPUT_BUFFER('\n');
+            FLUSH_OUTPUT_BUFFER();
+        }
+    }
+    void sendBytes(const uint8_t *data, uint32_t length) {
+        if (g_debuggerProtocol == DEBUGGER_PROTOCOL_BINARY) {
+            BinarySizeCounter counter;
+            counter.varint(length);
+            writeRecordHeader(counter.size + length);
+            BinaryOutputWriter writer;
+            writer.varint(length);
+            writer.bytes(data, length);
+            FLUSH_OUTPUT_BUFFER();
+        } else {
+            appendText("\t");
+            writeDebuggerBufferHook(m_buffer, m_length);
+            for (uint32_t i = 0; i < length; i++) {
+                WRITE_TO_OUTPUT_BUFFER(toHexDigit(data[i] / 16));
+                WRITE_TO_OUTPUT_BUFFER(toHexDigit(data[i] % 16));
+            }
+            WRITE_TO_OUTPUT_BUFFER('\n');
+            FLUSH_OUTPUT_BUFFER();
+        }
+    }
+    void sendLogMessage(const char *prefix, const char *message, size_t messageLength) {
+        if (g_debuggerProtocol == DEBUGGER_PROTOCOL_BINARY) {
+            sendBinaryString(prefix, strlen(prefix), message, messageLength);
+        } else {
+            appendText("\t%s", prefix);
+            writeDebuggerBufferHook(m_buffer, m_length);
+            writeLogMessage(message, messageLength);
+        }
+    }
+private:
+    char m_inlineBuffer[384];
+    char *m_buffer;
+    size_t m_capacity;
+    size_t m_length;
+    bool reserve(size_t size) {
+        if (m_length + size <= m_capacity) {
+            return true;
+        }
+        auto capacity = 2 * m_capacity;
+        while (capacity < m_length + size) {
+            capacity *= 2;
+        }
+        auto buffer = (char *)eez::alloc(capacity, 0x3c9e7a15);
+        if (!buffer) {
+            return false;
+        }
+        memcpy(buffer, m_buffer, m_length);
+        if (m_buffer != m_inlineBuffer) {
+            eez::free(m_buffer);
+        }
+        m_buffer = buffer;
+        m_capacity = capacity;
+        return true;
+    }
+    void appendText(const char *format, ...) {
+        va_list args;
+        va_start(args, format);
+        auto n = vsnprintf(m_buffer + m_length, m_capacity - m_length, format, args);
+        va_end(args);
+        if (n <= 0) {
+            return;
+        }
+        if (m_length + n >= m_capacity) {
+            if (!reserve(n + 1)) {
+                m_length = m_capacity - 1;
+                return;
+            }
+            va_start(args, format);
+            vsnprintf(m_buffer + m_length, m_capacity - m_length, format, args);
+            va_end(args);
+        }
+        m_length += n;
+    }
+    void appendVarint(uint64_t value) {
+        if (!reserve(10)) {
+            return;
+        }
+        while (value >= 0x80) {
+            m_buffer[m_length++] = (char)(value | 0x80);
+            value >>= 7;
+        }
+        m_buffer[m_length++] = (char)value;
+    }
+    void writeRecordHeader(uint32_t payloadLength) {
+        BinaryOutputWriter writer;
+        writer.varint(m_length + payloadLength);
+        writer.bytes(m_buffer, m_length);
+    }
+    void sendBinaryString(const char *prefix, size_t prefixLength, const char *str, size_t strLength) {
+        BinarySizeCounter counter;
+        counter.varint(prefixLength + strLength);
+        writeRecordHeader(counter.size + prefixLength + strLength);
+        BinaryOutputWriter writer;
+        writer.varint(prefixLength + strLength);
+        writer.bytes(prefix, prefixLength);
+        writer.bytes(str, strLength);
+        FLUSH_OUTPUT_BUFFER();
+    }
+};
 static void setDebuggerState(DebuggerState newState) {
 	if (newState != g_debuggerState) {
+        auto oldState = g_debuggerState;
 		g_debuggerState = newState;
+        if (oldState == DEBUGGER_STATE_RESUMED) {
+            flushCoalescedMessages();
+        }
 		if (isSubscribedTo(MESSAGE_TO_DEBUGGER_STATE_CHANGED)) {
-			char buffer[256];
-			snprintf(buffer, sizeof(buffer), "%d\t%d\n",
-				MESSAGE_TO_DEBUGGER_STATE_CHANGED,
-				g_debuggerState
-			);
-			writeDebuggerBufferHook(buffer, strlen(buffer));
+            ToDebuggerMessage(MESSAGE_TO_DEBUGGER_STATE_CHANGED)
+                .writeInt(g_debuggerState)
+                .send();
 		}
 	}
 }
+static void setDebuggerProtocol(DebuggerProtocol protocol) {
+    if (protocol != DEBUGGER_PROTOCOL_TEXT && protocol != DEBUGGER_PROTOCOL_BINARY) {
+        ErrorTrace("Unknown debugger protocol\n");
+        protocol = DEBUGGER_PROTOCOL_TEXT;
+    }
+    if (g_debuggerIsConnected) {
+        startToDebuggerMessageHook();
+        ToDebuggerMessage(MESSAGE_TO_DEBUGGER_PROTOCOL_CHANGED)
+            .writeInt(protocol)
+            .send();
+    }
+    g_debuggerProtocol = protocol;
+}
 void onDebuggerClientConnected() {
     g_debuggerIsConnected = true;
+    g_debuggerProtocol = DEBUGGER_PROTOCOL_TEXT;
+    resetCoalescing();
+    resetPagedValues();
 	g_skipNextBreakpoint = false;
 	g_inputFromDebuggerPosition = 0;
     setDebuggerState(DEBUGGER_STATE_PAUSED);
 }
 void onDebuggerClientDisconnected() {
     g_debuggerIsConnected = false;
+    g_debuggerProtocol = DEBUGGER_PROTOCOL_TEXT;
+    resetCoalescing();
+    resetPagedValues();
     setDebuggerState(DEBUGGER_STATE_RESUMED);
 }
 void processDebuggerInput(char *buffer, uint32_t length) {
 	for (uint32_t i = 0; i < length; i++) {
 		if (buffer[i] == '\n') {
-			int messageFromDebugger = g_inputFromDebugger[0] - '0';
+            g_inputFromDebugger[g_inputFromDebuggerPosition < sizeof(g_inputFromDebugger) ? g_inputFromDebuggerPosition : sizeof(g_inputFromDebugger) - 1] = 0;
+            char *params;
+			int messageFromDebugger = (int)strtol(g_inputFromDebugger, &params, 10);
+            if (*params == '\t') {
+                params++;
+            }
 			if (messageFromDebugger == MESSAGE_FROM_DEBUGGER_RESUME) {
 				setDebuggerState(DEBUGGER_STATE_RESUMED);
 			} else if (messageFromDebugger == MESSAGE_FROM_DEBUGGER_PAUSE) {
@@ -6120,7 +7317,7 @@ void processDebuggerInput(char *buffer, uint32_t length) {
 				messageFromDebugger <= MESSAGE_FROM_DEBUGGER_DISABLE_BREAKPOINT
 			) {
 				char *p;
-				auto flowIndex = (uint32_t)strtol(g_inputFromDebugger + 2, &p, 10);
+				auto flowIndex = (uint32_t)strtol(params, &p, 10);
 				auto componentIndex = (uint32_t)strtol(p + 1, nullptr, 10);
 				auto assets = g_firstFlowState->assets;
 				auto flowDefinition = static_cast<FlowDefinition *>(assets->flowDefinition);
@@ -6137,10 +7334,39 @@ void processDebuggerInput(char *buffer, uint32_t length) {
 					ErrorTrace("Invalid breakpoint flow index\n");
 				}
 			} else if (messageFromDebugger == MESSAGE_FROM_DEBUGGER_MODE) {
-                g_debuggerMode = strtol(g_inputFromDebugger + 2, nullptr, 10);
+                g_debuggerMode = strtol(params, nullptr, 10);
 #if EEZ_OPTION_GUI
                 gui::refreshScreen();
 #endif
+            } else if (messageFromDebugger == MESSAGE_FROM_DEBUGGER_PROTOCOL) {
+                setDebuggerProtocol((DebuggerProtocol)strtol(params, nullptr, 10));
+            } else if (messageFromDebugger == MESSAGE_FROM_DEBUGGER_COALESCE) {
+                flushCoalescedMessages();
+                g_coalesceMaxUpdateRate = (uint32_t)strtol(params, nullptr, 10);
+            } else if (messageFromDebugger == MESSAGE_FROM_DEBUGGER_PAGED_VALUES) {
+                g_debuggerPageSize = (uint32_t)strtol(params, nullptr, 10);
+            } else if (
+                messageFromDebugger == MESSAGE_FROM_DEBUGGER_REQUEST_ARRAY_PAGE ||
+                messageFromDebugger == MESSAGE_FROM_DEBUGGER_REQUEST_BLOB_PAGE
+            ) {
+                char *p;
+                auto addr = (const void *)(uintptr_t)strtoull(params, &p, 16);
+                auto offset = (uint32_t)strtol(p + 1, &p, 10);
+                auto count = (uint32_t)strtol(p + 1, nullptr, 10);
+                if (messageFromDebugger == MESSAGE_FROM_DEBUGGER_REQUEST_ARRAY_PAGE) {
+                    sendArrayPage(addr, offset, count);
+                } else {
+                    sendBlobPage(addr, offset, count);
+                }
+            } else if (messageFromDebugger == MESSAGE_FROM_DEBUGGER_PROFILER) {
+#if EEZ_OPTION_FLOW_PROFILER
+                char *p;
+                auto mode = (ProfilerMode)strtol(params, &p, 10);
+                auto samplingPeriod = *p ? (uint32_t)strtol(p + 1, nullptr, 10) : 0;
+                setProfilerMode(mode, samplingPeriod);
+#endif
+            } else if (messageFromDebugger == MESSAGE_FROM_DEBUGGER_REQUEST_PROFILER_DATA) {
+                sendProfilerData();
             }
 			g_inputFromDebuggerPosition = 0;
 		} else {
@@ -6179,23 +7405,6 @@ bool canExecuteStep(FlowState *&flowState, unsigned &componentIndex) {
     }
     return true;
 }
-#if defined(__EMSCRIPTEN__)
-char outputBuffer[1024 * 1024];
-#else
-char outputBuffer[64];
-#endif
-int outputBufferPosition = 0;
-#define WRITE_TO_OUTPUT_BUFFER(ch) \
-	outputBuffer[outputBufferPosition++] = ch; \
-	if (outputBufferPosition == sizeof(outputBuffer)) { \
-		writeDebuggerBufferHook(outputBuffer, outputBufferPosition); \
-		outputBufferPosition = 0; \
-	}
-#define FLUSH_OUTPUT_BUFFER() \
-	if (outputBufferPosition > 0) { \
-		writeDebuggerBufferHook(outputBuffer, outputBufferPosition); \
-		outputBufferPosition = 0; \
-	}
 static void writeValueAddr(const void *pValue) {
 	char tmpStr[32];
 	snprintf(tmpStr, sizeof(tmpStr), "%p", pValue);
@@ -6231,17 +7440,288 @@ static void writeString(const char *str) {
             }
         }
     }
-	WRITE_TO_OUTPUT_BUFFER('"');
-	WRITE_TO_OUTPUT_BUFFER('\n');
-	FLUSH_OUTPUT_BUFFER();
+	WRITE_TO_OUTPUT_BUFFER('"');
+	WRITE_TO_OUTPUT_BUFFER('\n');
+	FLUSH_OUTPUT_BUFFER();
+}
+static void writeArrayType(uint32_t arrayType) {
+	char tmpStr[32];
+	snprintf(tmpStr, sizeof(tmpStr), "%x", (int)arrayType);
+	auto len = strlen(tmpStr);
+	for (size_t i = 0; i < len; i++) {
+		WRITE_TO_OUTPUT_BUFFER(tmpStr[i]);
+	}
+}
+static bool isCoalescing() {
+    return g_coalesceMaxUpdateRate > 0 && g_debuggerState == DEBUGGER_STATE_RESUMED;
+}
+static void coalesceValueChange(FlowState *flowState, const Value *pValue) {
+    if (g_numCoalescedValues >= COALESCED_VALUES_SIZE * 3 / 4) {
+        flushCoalescedMessages();
+    }
+    auto i = (unsigned)(((uintptr_t)pValue >> 3) % COALESCED_VALUES_SIZE);
+    int removedIndex = -1;
+    for (unsigned n = 0; n < COALESCED_VALUES_SIZE && g_coalescedValues[i].pValue; n++) {
+        if (g_coalescedValues[i].pValue == pValue && g_coalescedValues[i].flowState == flowState) {
+            return;
+        }
+        if (g_coalescedValues[i].pValue == COALESCED_VALUE_REMOVED && removedIndex == -1) {
+            removedIndex = (int)i;
+        }
+        i = (i + 1) % COALESCED_VALUES_SIZE;
+    }
+    if (removedIndex != -1) {
+        i = (unsigned)removedIndex;
+        g_numCoalescedValuesRemoved--;
+    }
+    g_coalescedValues[i].pValue = pValue;
+    g_coalescedValues[i].flowState = flowState;
+    g_numCoalescedValues++;
+}
+static bool isGlobalVariableValue(const Value *pValue) {
+    return g_globalVariables && pValue >= g_globalVariables->values && pValue < g_globalVariables->values + g_globalVariables->count;
+}
+static bool isFlowStateValue(FlowState *flowState, const Value *pValue) {
+    return flowState && pValue >= flowState->values && pValue < flowState->values + flowState->flow->componentInputs.count + flowState->flow->localVariables.count;
+}
+static void sendAddToQueue(FlowState *flowState, int sourceComponentIndex, int sourceOutputIndex, unsigned targetComponentIndex, int targetInputIndex) {
+    uint32_t free;
+    uint32_t alloc;
+    getAllocInfo(free, alloc);
+    ToDebuggerMessage(MESSAGE_TO_DEBUGGER_ADD_TO_QUEUE)
+        .writeInt(flowState->flowStateIndex)
+        .writeInt(sourceComponentIndex)
+        .writeInt(sourceOutputIndex)
+        .writeInt(targetComponentIndex)
+        .writeInt(targetInputIndex)
+        .writeUnsigned(free)
+        .writeUnsigned(ALLOC_BUFFER_SIZE)
+        .send();
+}
+static void syncQueue() {
+    g_queueOutOfSync = false;
+    if (isSubscribedTo(MESSAGE_TO_DEBUGGER_QUEUE_RESET)) {
+        ToDebuggerMessage(MESSAGE_TO_DEBUGGER_QUEUE_RESET).send();
+        FlowState *flowState;
+        unsigned componentIndex;
+        bool continuousTask;
+        for (unsigned taskIndex = 0; getTaskFromQueue(taskIndex, flowState, componentIndex, continuousTask); taskIndex++) {
+            if (flowState && !continuousTask) {
+                sendAddToQueue(flowState, -1, -1, componentIndex, -1);
+            }
+        }
+    }
+}
+static void flushCoalescedMessages() {
+    if (g_numCoalescedValues > 0 || g_numCoalescedValuesRemoved > 0) {
+        for (unsigned i = 0; i < COALESCED_VALUES_SIZE; i++) {
+            auto pValue = g_coalescedValues[i].pValue;
+            if (pValue && pValue != COALESCED_VALUE_REMOVED) {
+                sendValueChanged(pValue);
+            }
+            g_coalescedValues[i].pValue = nullptr;
+            g_coalescedValues[i].flowState = nullptr;
+        }
+        g_numCoalescedValues = 0;
+        g_numCoalescedValuesRemoved = 0;
+    }
+    if (g_numCoalescedAddsToQueue > 0 || g_numCoalescedRemovesFromQueue > 0) {
+        if (isSubscribedTo(MESSAGE_TO_DEBUGGER_QUEUE_STATS)) {
+            uint32_t free;
+            uint32_t alloc;
+            getAllocInfo(free, alloc);
+            ToDebuggerMessage(MESSAGE_TO_DEBUGGER_QUEUE_STATS)
+                .writeUnsigned(g_numCoalescedAddsToQueue)
+                .writeUnsigned(g_numCoalescedRemovesFromQueue)
+                .writeUnsigned(free)
+                .writeUnsigned(ALLOC_BUFFER_SIZE)
+                .send();
+        }
+        g_numCoalescedAddsToQueue = 0;
+        g_numCoalescedRemovesFromQueue = 0;
+    }
+    if (g_queueOutOfSync && g_debuggerState != DEBUGGER_STATE_RESUMED) {
+        syncQueue();
+    }
+    g_lastCoalescedFlushTime = millis();
+}
+static void resetCoalescing() {
+    for (unsigned i = 0; i < COALESCED_VALUES_SIZE; i++) {
+        g_coalescedValues[i].pValue = nullptr;
+        g_coalescedValues[i].flowState = nullptr;
+    }
+    g_numCoalescedValues = 0;
+    g_numCoalescedValuesRemoved = 0;
+    g_coalesceMaxUpdateRate = 0;
+    g_numCoalescedAddsToQueue = 0;
+    g_numCoalescedRemovesFromQueue = 0;
+    g_queueOutOfSync = false;
+}
+static bool isPagedArray(const ArrayValue *arrayValue) {
+    return g_debuggerPageSize > 0 && arrayValue->arraySize > g_debuggerPageSize;
+}
+static const void *getPagedValueAddr(const Value &value) {
+    auto valueType = value.getType();
+    if (valueType == VALUE_TYPE_ARRAY || valueType == VALUE_TYPE_ARRAY_ASSET || valueType == VALUE_TYPE_ARRAY_REF) {
+        return value.getArray();
+    }
+    if (valueType == VALUE_TYPE_BLOB_REF) {
+        return value.refValue;
+    }
+    return nullptr;
+}
+static uint32_t hashBytes(uint32_t hash, const void *data, size_t length) {
+    auto bytes = (const uint8_t *)data;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+static uint32_t hashValueContent(uint32_t hash, const Value &value) {
+    auto valueType = value.getType();
+    hash = hashBytes(hash, &valueType, sizeof(valueType));
+    if (valueType == VALUE_TYPE_STRING || valueType == VALUE_TYPE_STRING_ASSET || valueType == VALUE_TYPE_STRING_REF) {
+        auto str = value.getString();
+        return hashBytes(hash, str, strlen(str));
+    }
+    if (valueType == VALUE_TYPE_BLOB_REF) {
+        auto blobRef = (BlobRef *)value.refValue;
+        hash = hashBytes(hash, &blobRef->len, sizeof(blobRef->len));
+        return hashBytes(hash, blobRef->blob, blobRef->len);
+    }
+    if (valueType == VALUE_TYPE_ARRAY || valueType == VALUE_TYPE_ARRAY_ASSET || valueType == VALUE_TYPE_ARRAY_REF) {
+        auto arrayValue = value.getArray();
+        hash = hashBytes(hash, &arrayValue->arraySize, sizeof(arrayValue->arraySize));
+        for (uint32_t i = 0; i < arrayValue->arraySize; i++) {
+            hash = hashValueContent(hash, arrayValue->values[i]);
+        }
+        return hash;
+    }
+    return hashBytes(hash, &value.uint64Value, sizeof(value.uint64Value));
+}
+static uint32_t hashPagedValue(const Value &value) {
+    return hashValueContent(2166136261u, value);
+}
+static bool isPagedValueReleased(const Value &value) {
+    auto valueType = value.getType();
+    return (valueType == VALUE_TYPE_ARRAY_REF || valueType == VALUE_TYPE_BLOB_REF) && value.refValue->refCounter == 1;
+}
+static uint32_t registerPagedValue(const Value &value) {
+    auto addr = getPagedValueAddr(value);
+    unsigned i;
+    for (i = 0; i < PAGED_VALUES_SIZE; i++) {
+        if (getPagedValueAddr(g_pagedValues[i]) == addr) {
+            break;
+        }
+    }
+    if (i == PAGED_VALUES_SIZE) {
+        for (i = 0; i < PAGED_VALUES_SIZE; i++) {
+            if (isPagedValueReleased(g_pagedValues[i])) {
+                g_pagedValues[i] = Value();
+            }
+        }
+        for (i = 0; i < PAGED_VALUES_SIZE; i++) {
+            if (g_pagedValues[i].getType() == VALUE_TYPE_UNDEFINED) {
+                break;
+            }
+        }
+        if (i == PAGED_VALUES_SIZE) {
+            i = g_nextPagedValueIndex;
+            g_nextPagedValueIndex = (g_nextPagedValueIndex + 1) % PAGED_VALUES_SIZE;
+        }
+        g_pagedValues[i] = value;
+    }
+    return hashPagedValue(value);
+}
+static const Value *findPagedValue(const void *addr) {
+    if (addr) {
+        for (unsigned i = 0; i < PAGED_VALUES_SIZE; i++) {
+            if (getPagedValueAddr(g_pagedValues[i]) == addr) {
+                return &g_pagedValues[i];
+            }
+        }
+    }
+    return nullptr;
+}
+static void resetPagedValues() {
+    for (unsigned i = 0; i < PAGED_VALUES_SIZE; i++) {
+        g_pagedValues[i] = Value();
+    }
+    g_nextPagedValueIndex = 0;
+    g_debuggerPageSize = 0;
+}
+static void sendArrayPage(const void *addr, uint32_t offset, uint32_t count) {
+    auto pValue = findPagedValue(addr);
+    if (!pValue || pValue->getType() == VALUE_TYPE_BLOB_REF) {
+        ErrorTrace("Invalid debugger array page request\n");
+        return;
+    }
+    auto arrayValue = pValue->getArray();
+    if (offset > arrayValue->arraySize) {
+        offset = arrayValue->arraySize;
+    }
+    if (count > arrayValue->arraySize - offset) {
+        count = arrayValue->arraySize - offset;
+    }
+    if (count > MAX_ARRAY_SIZE_TRANSFERRED_IN_DEBUGGER) {
+        count = MAX_ARRAY_SIZE_TRANSFERRED_IN_DEBUGGER;
+    }
+    if (isSubscribedTo(MESSAGE_TO_DEBUGGER_ARRAY_PAGE)) {
+        ToDebuggerMessage(MESSAGE_TO_DEBUGGER_ARRAY_PAGE)
+            .writeAddr(arrayValue)
+            .writeUnsigned(offset)
+            .sendAddrList(arrayValue->values + offset, count);
+        for (uint32_t i = 0; i < count; i++) {
+            sendValueChanged(&arrayValue->values[offset + i]);
+        }
+    }
 }
-static void writeArrayType(uint32_t arrayType) {
-	char tmpStr[32];
-	snprintf(tmpStr, sizeof(tmpStr), "%x", (int)arrayType);
-	auto len = strlen(tmpStr);
-	for (size_t i = 0; i < len; i++) {
-		WRITE_TO_OUTPUT_BUFFER(tmpStr[i]);
-	}
+static void sendBlobPage(const void *addr, uint32_t offset, uint32_t count) {
+    auto pValue = findPagedValue(addr);
+    if (!pValue || pValue->getType() != VALUE_TYPE_BLOB_REF) {
+        ErrorTrace("Invalid debugger blob page request\n");
+        return;
+    }
+    auto blobRef = (BlobRef *)pValue->refValue;
+    if (offset > blobRef->len) {
+        offset = blobRef->len;
+    }
+    if (count > blobRef->len - offset) {
+        count = blobRef->len - offset;
+    }
+    if (isSubscribedTo(MESSAGE_TO_DEBUGGER_BLOB_PAGE)) {
+        ToDebuggerMessage(MESSAGE_TO_DEBUGGER_BLOB_PAGE)
+            .writeAddr(blobRef)
+            .writeUnsigned(offset)
+            .sendBytes(blobRef->blob + offset, count);
+    }
+}
+static void sendProfilerData() {
+    if (!isSubscribedTo(MESSAGE_TO_DEBUGGER_PROFILER_DATA_END)) {
+        return;
+    }
+    uint32_t numEntries = 0;
+    uint32_t numDroppedEntries = 0;
+#if EEZ_OPTION_FLOW_PROFILER
+    auto entries = getProfilerEntries(numEntries, numDroppedEntries);
+    if (isSubscribedTo(MESSAGE_TO_DEBUGGER_PROFILER_ENTRY)) {
+        for (uint32_t i = 0; i < numEntries; i++) {
+            ToDebuggerMessage(MESSAGE_TO_DEBUGGER_PROFILER_ENTRY)
+                .writeInt(entries[i].flowIndex)
+                .writeInt(entries[i].componentIndex)
+                .writeInt(entries[i].propertyIndex)
+                .writeUnsigned(entries[i].count)
+                .writeUnsigned(entries[i].sampledCount)
+                .writeDouble((double)entries[i].sampledTime)
+                .writeUnsigned(entries[i].sampledAllocs)
+                .send();
+        }
+    }
+#endif
+    ToDebuggerMessage(MESSAGE_TO_DEBUGGER_PROFILER_DATA_END)
+        .writeUnsigned(numEntries)
+        .writeUnsigned(numDroppedEntries)
+        .send();
 }
 static void writeArray(const ArrayValue *arrayValue) {
 	WRITE_TO_OUTPUT_BUFFER('{');
@@ -6259,7 +7739,7 @@ static void writeArray(const ArrayValue *arrayValue) {
 	WRITE_TO_OUTPUT_BUFFER('\n');
 	FLUSH_OUTPUT_BUFFER();
     for (uint32_t i = 0; i < transferredSize; i++) {
-        onValueChanged(&arrayValue->values[i]);
+        sendValueChanged(&arrayValue->values[i]);
     }
 }
 static void writeHex(char *dst, uint8_t *src, size_t srcLength) {
@@ -6332,9 +7812,18 @@ static void writeValue(const Value &value) {
 	case VALUE_TYPE_ARRAY:
     case VALUE_TYPE_ARRAY_ASSET:
 	case VALUE_TYPE_ARRAY_REF:
+        if (isPagedArray(value.getArray())) {
+            auto arrayValue = value.getArray();
+            snprintf(tempStr, sizeof(tempStr) - 1, "[%p,%x,%x,%x]", (void *)arrayValue, (unsigned int)arrayValue->arraySize, (unsigned int)arrayValue->arrayType, (unsigned int)registerPagedValue(value));
+            break;
+        }
 		writeArray(value.getArray());
 		return;
 	case VALUE_TYPE_BLOB_REF:
+        if (g_debuggerPageSize > 0) {
+		    snprintf(tempStr, sizeof(tempStr) - 1, "@%d,%p,%x", (int)((BlobRef *)value.refValue)->len, (void *)value.refValue, (unsigned int)registerPagedValue(value));
+            break;
+        }
 		snprintf(tempStr, sizeof(tempStr) - 1, "@%d", (int)((BlobRef *)value.refValue)->len);
 		break;
 	case VALUE_TYPE_STREAM:
@@ -6372,26 +7861,18 @@ void onStarted(Assets *assets) {
         if (g_globalVariables) {
             for (uint32_t i = 0; i < g_globalVariables->count; i++) {
                 auto pValue = g_globalVariables->values + i;
-                char buffer[256];
-                snprintf(buffer, sizeof(buffer), "%d\t%d\t%p\t",
-                    MESSAGE_TO_DEBUGGER_GLOBAL_VARIABLE_INIT,
-                    (int)i,
-                    (const void *)pValue
-                );
-                writeDebuggerBufferHook(buffer, strlen(buffer));
-                writeValue(*pValue);
+                ToDebuggerMessage(MESSAGE_TO_DEBUGGER_GLOBAL_VARIABLE_INIT)
+                    .writeInt(i)
+                    .writeAddr(pValue)
+                    .send(*pValue);
             }
         } else {
             for (uint32_t i = 0; i < flowDefinition->globalVariables.count; i++) {
                 auto pValue = flowDefinition->globalVariables[i];
-                char buffer[256];
-                snprintf(buffer, sizeof(buffer), "%d\t%d\t%p\t",
-                    MESSAGE_TO_DEBUGGER_GLOBAL_VARIABLE_INIT,
-                    (int)i,
-                    (const void *)pValue
-                );
-                writeDebuggerBufferHook(buffer, strlen(buffer));
-                writeValue(*pValue);
+                ToDebuggerMessage(MESSAGE_TO_DEBUGGER_GLOBAL_VARIABLE_INIT)
+                    .writeInt(i)
+                    .writeAddr(pValue)
+                    .send(*pValue);
             }
         }
     }
@@ -6401,117 +7882,136 @@ void onStopped() {
 }
 void onAddToQueue(FlowState *flowState, int sourceComponentIndex, int sourceOutputIndex, unsigned targetComponentIndex, int targetInputIndex) {
     if (isSubscribedTo(MESSAGE_TO_DEBUGGER_ADD_TO_QUEUE)) {
-        uint32_t free;
-        uint32_t alloc;
-        getAllocInfo(free, alloc);
-        char buffer[256];
-		snprintf(buffer, sizeof(buffer), "%d\t%d\t%d\t%d\t%d\t%d\t%u\t%u\n",
-			MESSAGE_TO_DEBUGGER_ADD_TO_QUEUE,
-			(int)flowState->flowStateIndex,
-			sourceComponentIndex,
-			sourceOutputIndex,
-			targetComponentIndex,
-			targetInputIndex,
-            (unsigned int)free,
-            (unsigned int)ALLOC_BUFFER_SIZE
-		);
-        writeDebuggerBufferHook(buffer, strlen(buffer));
+        if (isCoalescing()) {
+            g_numCoalescedAddsToQueue++;
+            g_queueOutOfSync = true;
+            return;
+        }
+        sendAddToQueue(flowState, sourceComponentIndex, sourceOutputIndex, targetComponentIndex, targetInputIndex);
     }
 }
 void onRemoveFromQueue() {
     if (isSubscribedTo(MESSAGE_TO_DEBUGGER_REMOVE_FROM_QUEUE)) {
-        char buffer[256];
-		snprintf(buffer, sizeof(buffer), "%d\n",
-			MESSAGE_TO_DEBUGGER_REMOVE_FROM_QUEUE
-		);
-        writeDebuggerBufferHook(buffer, strlen(buffer));
+        if (isCoalescing()) {
+            g_numCoalescedRemovesFromQueue++;
+            g_queueOutOfSync = true;
+            return;
+        }
+        ToDebuggerMessage(MESSAGE_TO_DEBUGGER_REMOVE_FROM_QUEUE).send();
     }
 }
-void onValueChanged(const Value *pValue) {
+static void sendValueChanged(const Value *pValue) {
     if (isSubscribedTo(MESSAGE_TO_DEBUGGER_VALUE_CHANGED)) {
-        char buffer[256];
-		snprintf(buffer, sizeof(buffer), "%d\t%p\t",
-			MESSAGE_TO_DEBUGGER_VALUE_CHANGED,
-            (const void *)pValue
-		);
-        writeDebuggerBufferHook(buffer, strlen(buffer));
-		writeValue(pValue->getValue());
+        ToDebuggerMessage(MESSAGE_TO_DEBUGGER_VALUE_CHANGED)
+            .writeAddr(pValue)
+            .send(pValue->getValue());
+    }
+}
+void onValueChanged(const Value *pValue) {
+    onValueChanged(nullptr, pValue);
+}
+void onValueChanged(FlowState *flowState, const Value *pValue) {
+    onValuesChanged(flowState, &pValue, 1);
+}
+void onValuesChanged(FlowState *flowState, const Value **pValues, unsigned count) {
+    for (unsigned i = 0; i < count; i++) {
+        markValueChanged(flowState, pValues[i]);
+    }
+    if (!isSubscribedTo(MESSAGE_TO_DEBUGGER_VALUE_CHANGED)) {
+        return;
+    }
+    if (isCoalescing()) {
+        for (unsigned i = 0; i < count; i++) {
+            if (isGlobalVariableValue(pValues[i])) {
+                coalesceValueChange(nullptr, pValues[i]);
+            } else if (isFlowStateValue(flowState, pValues[i])) {
+                coalesceValueChange(flowState, pValues[i]);
+            } else {
+                sendValueChanged(pValues[i]);
+            }
+        }
+        return;
+    }
+    if (count == 1) {
+        sendValueChanged(pValues[0]);
+        return;
     }
+    ToDebuggerMessage(MESSAGE_TO_DEBUGGER_VALUES_CHANGED)
+        .writeAddrs(pValues, count)
+        .send(pValues[0]->getValue());
 }
 void onFlowStateCreated(FlowState *flowState) {
     if (isSubscribedTo(MESSAGE_TO_DEBUGGER_FLOW_STATE_CREATED)) {
-        char buffer[256];
-		snprintf(buffer, sizeof(buffer), "%d\t%d\t%d\t%d\t%d\n",
-			MESSAGE_TO_DEBUGGER_FLOW_STATE_CREATED,
-			(int)flowState->flowStateIndex,
-			(int)flowState->flowIndex,
-			(int)(flowState->parentFlowState ? flowState->parentFlowState->flowStateIndex : -1),
-			(int)flowState->parentComponentIndex
-		);
-        writeDebuggerBufferHook(buffer, strlen(buffer));
+        ToDebuggerMessage(MESSAGE_TO_DEBUGGER_FLOW_STATE_CREATED)
+            .writeInt(flowState->flowStateIndex)
+            .writeInt(flowState->flowIndex)
+            .writeInt(flowState->parentFlowState ? flowState->parentFlowState->flowStateIndex : -1)
+            .writeInt(flowState->parentComponentIndex)
+            .send();
     }
     if (isSubscribedTo(MESSAGE_TO_DEBUGGER_LOCAL_VARIABLE_INIT)) {
 		auto flow = flowState->flow;
 		for (uint32_t i = 0; i < flow->localVariables.count; i++) {
 			auto pValue = &flowState->values[flow->componentInputs.count + i];
-            char buffer[256];
-            snprintf(buffer, sizeof(buffer), "%d\t%d\t%d\t%p\t",
-                MESSAGE_TO_DEBUGGER_LOCAL_VARIABLE_INIT,
-				(int)flowState->flowStateIndex,
-				(int)i,
-                (const void *)pValue
-            );
-            writeDebuggerBufferHook(buffer, strlen(buffer));
-			writeValue(*pValue);
+            ToDebuggerMessage(MESSAGE_TO_DEBUGGER_LOCAL_VARIABLE_INIT)
+                .writeInt(flowState->flowStateIndex)
+                .writeInt(i)
+                .writeAddr(pValue)
+                .send(*pValue);
         }
     }
     if (isSubscribedTo(MESSAGE_TO_DEBUGGER_COMPONENT_INPUT_INIT)) {
 		auto flow = flowState->flow;
 		for (uint32_t i = 0; i < flow->componentInputs.count; i++) {
 				auto pValue = &flowState->values[i];
-				char buffer[256];
-				snprintf(buffer, sizeof(buffer), "%d\t%d\t%d\t%p\t",
-					MESSAGE_TO_DEBUGGER_COMPONENT_INPUT_INIT,
-					(int)flowState->flowStateIndex,
-					(int)i,
-					(const void *)pValue
-				);
-				writeDebuggerBufferHook(buffer, strlen(buffer));
-				writeValue(*pValue);
+                ToDebuggerMessage(MESSAGE_TO_DEBUGGER_COMPONENT_INPUT_INIT)
+                    .writeInt(flowState->flowStateIndex)
+                    .writeInt(i)
+                    .writeAddr(pValue)
+                    .send(*pValue);
         }
 	}
 }
 void onFlowStateDestroyed(FlowState *flowState) {
+    if (g_numCoalescedValues > 0) {
+        for (unsigned i = 0; i < COALESCED_VALUES_SIZE; i++) {
+            if (g_coalescedValues[i].pValue && g_coalescedValues[i].flowState == flowState) {
+                g_coalescedValues[i].pValue = COALESCED_VALUE_REMOVED;
+                g_coalescedValues[i].flowState = nullptr;
+                g_numCoalescedValues--;
+                g_numCoalescedValuesRemoved++;
+            }
+        }
+    }
 	if (isSubscribedTo(MESSAGE_TO_DEBUGGER_FLOW_STATE_DESTROYED)) {
-		char buffer[256];
-		snprintf(buffer, sizeof(buffer), "%d\t%d\n",
-			MESSAGE_TO_DEBUGGER_FLOW_STATE_DESTROYED,
-			(int)flowState->flowStateIndex
-		);
-		writeDebuggerBufferHook(buffer, strlen(buffer));
+        ToDebuggerMessage(MESSAGE_TO_DEBUGGER_FLOW_STATE_DESTROYED)
+            .writeInt(flowState->flowStateIndex)
+            .send();
 	}
 }
+void onTickFinished() {
+    if (g_numCoalescedValues == 0 && g_numCoalescedAddsToQueue == 0 && g_numCoalescedRemovesFromQueue == 0) {
+        return;
+    }
+    if (isCoalescing() && millis() - g_lastCoalescedFlushTime < 1000 / g_coalesceMaxUpdateRate) {
+        return;
+    }
+    flushCoalescedMessages();
+}
 void onFlowStateTimelineChanged(FlowState *flowState) {
 	if (isSubscribedTo(MESSAGE_TO_DEBUGGER_FLOW_STATE_TIMELINE_CHANGED)) {
-		char buffer[256];
-		snprintf(buffer, sizeof(buffer), "%d\t%d\t%g\n",
-			MESSAGE_TO_DEBUGGER_FLOW_STATE_TIMELINE_CHANGED,
-			(int)flowState->flowStateIndex,
-            flowState->timelinePosition
-		);
-		writeDebuggerBufferHook(buffer, strlen(buffer));
+        ToDebuggerMessage(MESSAGE_TO_DEBUGGER_FLOW_STATE_TIMELINE_CHANGED)
+            .writeInt(flowState->flowStateIndex)
+            .writeDouble(flowState->timelinePosition)
+            .send();
 	}
 }
 void onFlowError(FlowState *flowState, int componentIndex, const char *errorMessage) {
 	if (isSubscribedTo(MESSAGE_TO_DEBUGGER_FLOW_STATE_ERROR)) {
-		char buffer[256];
-		snprintf(buffer, sizeof(buffer), "%d\t%d\t%d\t",
-			MESSAGE_TO_DEBUGGER_FLOW_STATE_ERROR,
-			(int)flowState->flowStateIndex,
-			componentIndex
-		);
-		writeDebuggerBufferHook(buffer, strlen(buffer));
-		writeString(errorMessage);
+        ToDebuggerMessage(MESSAGE_TO_DEBUGGER_FLOW_STATE_ERROR)
+            .writeInt(flowState->flowStateIndex)
+            .writeInt(componentIndex)
+            .sendString(errorMessage);
 	}
     if (onFlowErrorHook) {
         onFlowErrorHook(flowState, componentIndex, errorMessage);
@@ -6519,42 +8019,21 @@ void onFlowError(FlowState *flowState, int componentIndex, const char *errorMess
 }
 void onComponentExecutionStateChanged(FlowState *flowState, int componentIndex) {
 	if (isSubscribedTo(MESSAGE_TO_DEBUGGER_COMPONENT_EXECUTION_STATE_CHANGED)) {
-		char buffer[256];
-		snprintf(buffer, sizeof(buffer), "%d\t%d\t%d\t%p\n",
-			MESSAGE_TO_DEBUGGER_COMPONENT_EXECUTION_STATE_CHANGED,
-			(int)flowState->flowStateIndex,
-			componentIndex,
-            (void *)flowState->componenentExecutionStates[componentIndex]
-		);
-        writeDebuggerBufferHook(buffer, strlen(buffer));
+        ToDebuggerMessage(MESSAGE_TO_DEBUGGER_COMPONENT_EXECUTION_STATE_CHANGED)
+            .writeInt(flowState->flowStateIndex)
+            .writeInt(componentIndex)
+            .writeAddr(flowState->componenentExecutionStates[componentIndex])
+            .send();
 	}
 }
 void onComponentAsyncStateChanged(FlowState *flowState, int componentIndex) {
 	if (isSubscribedTo(MESSAGE_TO_DEBUGGER_COMPONENT_ASYNC_STATE_CHANGED)) {
-		char buffer[256];
-		snprintf(buffer, sizeof(buffer), "%d\t%d\t%d\t%d\n",
-			MESSAGE_TO_DEBUGGER_COMPONENT_ASYNC_STATE_CHANGED,
-			(int)flowState->flowStateIndex,
-			componentIndex,
-            flowState->componenentAsyncStates[componentIndex] ? 1 : 0
-		);
-        writeDebuggerBufferHook(buffer, strlen(buffer));
-	}
-}
-static void writeLogMessage(const char *str) {
-	for (const char *p = str; *p; p++) {
-		if (*p == '\t') {
-			WRITE_TO_OUTPUT_BUFFER('\\');
-			WRITE_TO_OUTPUT_BUFFER('t');
-		} if (*p == '\n') {
-			WRITE_TO_OUTPUT_BUFFER('\\');
-			WRITE_TO_OUTPUT_BUFFER('n');
-		} else {
-			WRITE_TO_OUTPUT_BUFFER(*p);
-		}
+        ToDebuggerMessage(MESSAGE_TO_DEBUGGER_COMPONENT_ASYNC_STATE_CHANGED)
+            .writeInt(flowState->flowStateIndex)
+            .writeInt(componentIndex)
+            .writeInt(flowState->componenentAsyncStates[componentIndex] ? 1 : 0)
+            .send();
 	}
-	WRITE_TO_OUTPUT_BUFFER('\n');
-	FLUSH_OUTPUT_BUFFER();
 }
 static void writeLogMessage(const char *str, size_t len) {
 	for (size_t i = 0; i < len; i++) {
@@ -6576,54 +8055,38 @@ void logInfo(FlowState *flowState, unsigned componentIndex, const char *message)
     LV_LOG_USER("EEZ-FLOW: %s", message);
 #endif
 	if (isSubscribedTo(MESSAGE_TO_DEBUGGER_LOG)) {
-		char buffer[256];
-		snprintf(buffer, sizeof(buffer), "%d\t%d\t%d\t%d\t",
-			MESSAGE_TO_DEBUGGER_LOG,
-            LOG_ITEM_TYPE_INFO,
-            (int)flowState->flowStateIndex,
-			componentIndex
-		);
-		writeDebuggerBufferHook(buffer, strlen(buffer));
-		writeLogMessage(message);
+        ToDebuggerMessage(MESSAGE_TO_DEBUGGER_LOG)
+            .writeInt(LOG_ITEM_TYPE_INFO)
+            .writeInt(flowState->flowStateIndex)
+            .writeInt(componentIndex)
+            .sendLogMessage("", message, strlen(message));
     }
 }
 void logScpiCommand(FlowState *flowState, unsigned componentIndex, const char *cmd) {
 	if (isSubscribedTo(MESSAGE_TO_DEBUGGER_LOG)) {
-		char buffer[256];
-		snprintf(buffer, sizeof(buffer), "%d\t%d\t%d\t%d\tSCPI COMMAND: ",
-			MESSAGE_TO_DEBUGGER_LOG,
-            LOG_ITEM_TYPE_SCPI,
-            (int)flowState->flowStateIndex,
-			componentIndex
-		);
-		writeDebuggerBufferHook(buffer, strlen(buffer));
-		writeLogMessage(cmd);
+        ToDebuggerMessage(MESSAGE_TO_DEBUGGER_LOG)
+            .writeInt(LOG_ITEM_TYPE_SCPI)
+            .writeInt(flowState->flowStateIndex)
+            .writeInt(componentIndex)
+            .sendLogMessage("SCPI COMMAND: ", cmd, strlen(cmd));
     }
 }
 void logScpiQuery(FlowState *flowState, unsigned componentIndex, const char *query) {
 	if (isSubscribedTo(MESSAGE_TO_DEBUGGER_LOG)) {
-		char buffer[256];
-		snprintf(buffer, sizeof(buffer), "%d\t%d\t%d\t%d\tSCPI QUERY: ",
-			MESSAGE_TO_DEBUGGER_LOG,
-            LOG_ITEM_TYPE_SCPI,
-            (int)flowState->flowStateIndex,
-			componentIndex
-		);
-		writeDebuggerBufferHook(buffer, strlen(buffer));
-		writeLogMessage(query);
+        ToDebuggerMessage(MESSAGE_TO_DEBUGGER_LOG)
+            .writeInt(LOG_ITEM_TYPE_SCPI)
+            .writeInt(flowState->flowStateIndex)
+            .writeInt(componentIndex)
+            .sendLogMessage("SCPI QUERY: ", query, strlen(query));
     }
 }
 void logScpiQueryResult(FlowState *flowState, unsigned componentIndex, const char *resultText, size_t resultTextLen) {
 	if (isSubscribedTo(MESSAGE_TO_DEBUGGER_LOG)) {
-		char buffer[256];
-		snprintf(buffer, sizeof(buffer) - 1, "%d\t%d\t%d\t%d\tSCPI QUERY RESULT: ",
-			MESSAGE_TO_DEBUGGER_LOG,
-            LOG_ITEM_TYPE_SCPI,
-            (int)flowState->flowStateIndex,
-			componentIndex
-		);
-		writeDebuggerBufferHook(buffer, strlen(buffer));
-		writeLogMessage(resultText, resultTextLen);
+        ToDebuggerMessage(MESSAGE_TO_DEBUGGER_LOG)
+            .writeInt(LOG_ITEM_TYPE_SCPI)
+            .writeInt(flowState->flowStateIndex)
+            .writeInt(componentIndex)
+            .sendLogMessage("SCPI QUERY RESULT: ", resultText, resultTextLen);
     }
 }
 #if EEZ_OPTION_GUI
@@ -6661,12 +8124,9 @@ void onPageChanged(int previousPageId, int activePageId, bool activePageIsFromSt
         }
     }
 	if (isSubscribedTo(MESSAGE_TO_DEBUGGER_PAGE_CHANGED)) {
-        char buffer[256];
-        snprintf(buffer, sizeof(buffer), "%d\t%d\n",
-            MESSAGE_TO_DEBUGGER_PAGE_CHANGED,
-            activePageId
-        );
-        writeDebuggerBufferHook(buffer, strlen(buffer));
+        ToDebuggerMessage(MESSAGE_TO_DEBUGGER_PAGE_CHANGED)
+            .writeInt(activePageId)
+            .send();
     }
 }
 #else
@@ -6694,12 +8154,9 @@ void onPageChanged(int previousPageId, int activePageId, bool activePageIsFromSt
         }
     }
 	if (isSubscribedTo(MESSAGE_TO_DEBUGGER_PAGE_CHANGED)) {
-        char buffer[256];
-        snprintf(buffer, sizeof(buffer), "%d\t%d\n",
-            MESSAGE_TO_DEBUGGER_PAGE_CHANGED,
-            activePageId
-        );
-        writeDebuggerBufferHook(buffer, strlen(buffer));
+        ToDebuggerMessage(MESSAGE_TO_DEBUGGER_PAGE_CHANGED)
+            .writeInt(activePageId)
+            .send();
     }
 }
 #endif 
@@ -6930,6 +8387,9 @@ bool evalProperty(FlowState *flowState, int componentIndex, int propertyIndex, V
         throwError(flowState, componentIndex, flowError);
         return false;
     }
+#if EEZ_OPTION_FLOW_PROFILER
+    ProfilerScope profilerScope(flowState, componentIndex, propertyIndex);
+#endif
 #if EEZ_OPTION_GUI
     return evalExpression(flowState, componentIndex, component->properties[propertyIndex]->evalInstructions, result, errorMessage, numInstructionBytes, iterators, operation);
 #else
@@ -6952,8 +8412,54 @@ bool evalAssignableProperty(FlowState *flowState, int componentIndex, int proper
         throwError(flowState, componentIndex, flowError);
         return false;
     }
+#if EEZ_OPTION_FLOW_PROFILER
+    ProfilerScope profilerScope(flowState, componentIndex, propertyIndex);
+#endif
     return evalAssignableExpression(flowState, componentIndex, component->properties[propertyIndex]->evalInstructions, result, errorMessage, numInstructionBytes, iterators);
 }
+bool getPropertyDependencies(FlowState *flowState, int componentIndex, int propertyIndex, PropertyDependencies &dependencies) {
+    dependencies.flowValues = false;
+    dependencies.numGlobalVariables = 0;
+    if (componentIndex < 0 || componentIndex >= (int)flowState->flow->components.count) {
+        return false;
+    }
+    auto component = flowState->flow->components[componentIndex];
+    if (propertyIndex < 0 || propertyIndex >= (int)component->properties.count) {
+        return false;
+    }
+    auto flowDefinition = flowState->flowDefinition;
+    const uint8_t *instructions = component->properties[propertyIndex]->evalInstructions;
+    for (int i = 0; ; i += 2) {
+        uint16_t instruction = instructions[i] + (instructions[i + 1] << 8);
+        auto instructionType = instruction & EXPR_EVAL_INSTRUCTION_TYPE_MASK;
+        auto instructionArg = instruction & EXPR_EVAL_INSTRUCTION_PARAM_MASK;
+        if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_INPUT || instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_LOCAL_VAR) {
+            dependencies.flowValues = true;
+        } else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_GLOBAL_VAR) {
+            if ((uint32_t)instructionArg >= flowDefinition->globalVariables.count) {
+                return false;
+            }
+            uint32_t j = 0;
+            while (j < dependencies.numGlobalVariables && dependencies.globalVariables[j] != (uint32_t)instructionArg) {
+                j++;
+            }
+            if (j == dependencies.numGlobalVariables) {
+                if (j == MAX_PROPERTY_GLOBAL_VARIABLE_DEPENDENCIES) {
+                    return false;
+                }
+                dependencies.globalVariables[dependencies.numGlobalVariables++] = instructionArg;
+            }
+        } else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_OUTPUT) {
+            return false;
+        } else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_OPERATION) {
+            if (!isPureOperation(instructionArg)) {
+                return false;
+            }
+        } else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_END) {
+            return true;
+        }
+    }
+}
 #if EEZ_OPTION_GUI
 int16_t getNativeVariableId(const WidgetCursor &widgetCursor) {
 	if (widgetCursor.flowState) {
@@ -7082,6 +8588,7 @@ void tick() {
             }
         }
 	}
+    onTickFinished();
 	finishToDebuggerMessageHook();
     for (FlowState *flowState = g_firstFlowState; flowState; flowState = flowState->nextSibling) {
         if (flowState->deleteOnNextTick) {
@@ -7193,8 +8700,10 @@ void setGlobalVariable(Assets *assets, uint32_t globalVariableIndex, const Value
     if (globalVariableIndex < assets->flowDefinition->globalVariables.count) {
         if (g_globalVariables) {
             g_globalVariables->values[globalVariableIndex] = value;
+            markValueChanged(nullptr, &g_globalVariables->values[globalVariableIndex]);
         } else {
             *assets->flowDefinition->globalVariables[globalVariableIndex] = value;
+            markValueChanged(nullptr, assets->flowDefinition->globalVariables[globalVariableIndex]);
         }
     }
 }
@@ -7618,45 +9127,45 @@ static lv_group_t *getLvglGroupFromIndex(int32_t index) {
     }
     return 0;
 }
+static eez::NameIndex g_screenNameIndex;
+static eez::NameIndex g_objectNameIndex;
+static eez::NameIndex g_groupNameIndex;
+static eez::NameIndex g_styleNameIndex;
+static eez::NameIndex g_imageNameIndex;
 static int32_t getLvglScreenByName(const char *name) {
-    for (size_t i = 0; i < g_numScreens; i++) {
-        if (strcmp(g_screenNames[i], name) == 0) {
-            return i + 1;
-        }
-    }
-    return -1;
+    int32_t screenIndex = g_screenNameIndex.find(g_screenNames, (uint32_t)g_numScreens, name, [](uint32_t i) {
+        return g_screenNames[i];
+    });
+    return screenIndex != -1 ? screenIndex + 1 : -1;
 }
 static int32_t getLvglObjectByName(const char *name) {
-    for (size_t i = 0; i < g_numObjects; i++) {
-        if (strcmp(g_objectNames[i], name) == 0) {
-            return i;
-        }
-    }
-    return -1;
+    return g_objectNameIndex.find(g_objectNames, (uint32_t)g_numObjects, name, [](uint32_t i) {
+        return g_objectNames[i];
+    });
 }
 static int32_t getLvglGroupByName(const char *name) {
-    for (size_t i = 0; i < g_numGroups; i++) {
-        if (strcmp(g_groupNames[i], name) == 0) {
-            return i;
-        }
-    }
-    return -1;
+    return g_groupNameIndex.find(g_groupNames, (uint32_t)g_numGroups, name, [](uint32_t i) {
+        return g_groupNames[i];
+    });
 }
 static int32_t getLvglStyleByName(const char *name) {
-    for (size_t i = 0; i < g_numStyles; i++) {
-        if (strcmp(g_styleNames[i], name) == 0) {
-            return i;
-        }
-    }
-    return -1;
+    return g_styleNameIndex.find(g_styleNames, (uint32_t)g_numStyles, name, [](uint32_t i) {
+        return g_styleNames[i];
+    });
+}
+static int32_t getLvglImageIndexByName(const char *name) {
+    return g_imageNameIndex.find(g_images, (uint32_t)g_numImages, name, [](uint32_t i) {
+        return g_images[i].name;
+    });
 }
 static const void *getLvglImageByName(const char *name) {
-    for (size_t i = 0; i < g_numImages; i++) {
-        if (strcmp(g_images[i].name, name) == 0) {
-            return g_images[i].img_dsc;
-        }
-    }
-    return 0;
+    int32_t imageIndex = getLvglImageIndexByName(name);
+    return imageIndex != -1 ? g_images[imageIndex].img_dsc : 0;
+}
+namespace eez {
+int getBitmapIdByName(const char *bitmapName) {
+    return getLvglImageIndexByName(bitmapName) + 1;
+}
 }
 uint8_t g_lastLVGLEventUserDataBuffer[64];
 uint8_t g_lastLVGLEventParamBuffer[64];
@@ -8823,6 +10332,7 @@ static void do_OPERATION_TYPE_FLOW_TRANSLATE(EvalStack &stack) {
     int languageIndex = g_selectedLanguage;
     auto &languages = stack.flowState->assets->languages;
     if (languageIndex >= 0 && languageIndex < (int)languages.count) {
+        loadLazyLanguage(stack.flowState->assets, languageIndex);
         auto &translations = languages[languageIndex]->translations;
         if (textResourceIndex >= 0 && textResourceIndex < (int)translations.count) {
             stack.push(translations[textResourceIndex]);
@@ -8897,7 +10407,7 @@ static void do_OPERATION_TYPE_FLOW_TO_INTEGER(EvalStack &stack) {
     stack.push(Value(value, VALUE_TYPE_INT32));
 }
 static void do_OPERATION_TYPE_FLOW_GET_BITMAP_INDEX(EvalStack &stack) {
-#if EEZ_OPTION_GUI
+#if EEZ_OPTION_GUI || defined(EEZ_FOR_LVGL)
     auto a = stack.pop().getValue();
     if (a.isError()) {
         stack.push(a);
@@ -9490,6 +11000,10 @@ static void do_OPERATION_TYPE_STRING_SUBSTRING(EvalStack &stack) {
         end = strLen;
     }
     if (start < end) {
+        if (end == strLen && strValue.getType() == VALUE_TYPE_STRING_REF) {
+            stack.push(Value::makeStringSlice(strValue, start, 0x6d1e4b27));
+            return;
+        }
         Value resultValue = Value::makeStringRef(str + start, end - start, 0x203b08a2);
         stack.push(resultValue);
         return;
@@ -9764,26 +11278,48 @@ static void do_OPERATION_TYPE_STRING_SPLIT(EvalStack &stack) {
         return;
     }
     auto strLen = strlen(str);
-    char *strCopy = (char *)eez::alloc(strLen + 1, 0xea9d0bc0);
-    stringCopy(strCopy, strLen + 1, str);
-    size_t arraySize = 0;
-    char *token = strtok(strCopy, delim);
-    while (token != NULL) {
+    auto delimLen = strlen(delim);
+    if (delimLen == 0) {
+        size_t arraySize = 0;
+        for (const char *p = str; *p; p += utf8codepointcalcsize(p)) {
+            arraySize++;
+        }
+        auto arrayValue = Value::makeArrayRef(arraySize, VALUE_TYPE_STRING, 0x3c9f21d8);
+        auto array = arrayValue.getArray();
+        int i = 0;
+        for (const char *p = str; *p; p += utf8codepointcalcsize(p)) {
+            array->values[i++] = Value::makeStringRef(p, utf8codepointcalcsize(p), 0x45209ec0);
+        }
+        stack.push(arrayValue);
+        return;
+    }
+    const char *firstDelim = strstr(str, delim);
+    if (!firstDelim) {
+        auto arrayValue = Value::makeArrayRef(1, VALUE_TYPE_STRING, 0xe82675d4);
+        arrayValue.getArray()->values[0] = strValue;
+        stack.push(arrayValue);
+        return;
+    }
+    auto bufferValue = Value::makeStringRef(str, strLen, 0xea9d0bc0);
+    if (bufferValue.getType() == VALUE_TYPE_NULL) {
+        stack.push(Value::makeError());
+        return;
+    }
+    char *buffer = ((StringRef *)bufferValue.refValue)->str;
+    size_t arraySize = 1;
+    for (char *p = buffer + (firstDelim - str); p; p = strstr(p + delimLen, delim)) {
+        *p = 0;
         arraySize++;
-        token = strtok(NULL, delim);
     }
-    eez::free(strCopy);
-    strCopy = (char *)eez::alloc(strLen + 1, 0xea9d0bc1);
-    stringCopy(strCopy, strLen + 1, str);
     auto arrayValue = Value::makeArrayRef(arraySize, VALUE_TYPE_STRING, 0xe82675d4);
     auto array = arrayValue.getArray();
-    int i = 0;
-    token = strtok(strCopy, delim);
-    while (token != NULL) {
-        array->values[i++] = Value::makeStringRef(token, -1, 0x45209ec0);
-        token = strtok(NULL, delim);
+    size_t offset = 0;
+    for (size_t i = 0; i < arraySize; i++) {
+        array->values[i] = Value::makeStringSlice(bufferValue, (int)offset, 0x45209ec1);
+        if (i + 1 < arraySize) {
+            offset += strlen(buffer + offset) + delimLen;
+        }
     }
-    eez::free(strCopy);
     stack.push(arrayValue);
 }
 static void do_OPERATION_TYPE_STRING_FROM_CODE_POINT(EvalStack &stack) {
@@ -10354,6 +11890,79 @@ EvalOperation g_evalOperations[] = {
     do_OPERATION_TYPE_BLOB_TO_STRING,
     do_OPERATION_TYPE_FLOW_THEMES,
 };
+static EvalOperation g_pureOperations[] = {
+    do_OPERATION_TYPE_ADD,
+    do_OPERATION_TYPE_SUB,
+    do_OPERATION_TYPE_MUL,
+    do_OPERATION_TYPE_DIV,
+    do_OPERATION_TYPE_MOD,
+    do_OPERATION_TYPE_LEFT_SHIFT,
+    do_OPERATION_TYPE_RIGHT_SHIFT,
+    do_OPERATION_TYPE_BINARY_AND,
+    do_OPERATION_TYPE_BINARY_OR,
+    do_OPERATION_TYPE_BINARY_XOR,
+    do_OPERATION_TYPE_EQUAL,
+    do_OPERATION_TYPE_NOT_EQUAL,
+    do_OPERATION_TYPE_LESS,
+    do_OPERATION_TYPE_GREATER,
+    do_OPERATION_TYPE_LESS_OR_EQUAL,
+    do_OPERATION_TYPE_GREATER_OR_EQUAL,
+    do_OPERATION_TYPE_LOGICAL_AND,
+    do_OPERATION_TYPE_LOGICAL_OR,
+    do_OPERATION_TYPE_UNARY_PLUS,
+    do_OPERATION_TYPE_UNARY_MINUS,
+    do_OPERATION_TYPE_BINARY_ONE_COMPLEMENT,
+    do_OPERATION_TYPE_NOT,
+    do_OPERATION_TYPE_CONDITIONAL,
+    do_OPERATION_TYPE_FLOW_PARSE_INTEGER,
+    do_OPERATION_TYPE_FLOW_PARSE_FLOAT,
+    do_OPERATION_TYPE_FLOW_PARSE_DOUBLE,
+    do_OPERATION_TYPE_FLOW_TO_INTEGER,
+    do_OPERATION_TYPE_MATH_SIN,
+    do_OPERATION_TYPE_MATH_COS,
+    do_OPERATION_TYPE_MATH_LOG,
+    do_OPERATION_TYPE_MATH_LOG10,
+    do_OPERATION_TYPE_MATH_ABS,
+    do_OPERATION_TYPE_MATH_FLOOR,
+    do_OPERATION_TYPE_MATH_CEIL,
+    do_OPERATION_TYPE_MATH_ROUND,
+    do_OPERATION_TYPE_MATH_MIN,
+    do_OPERATION_TYPE_MATH_MAX,
+    do_OPERATION_TYPE_MATH_POW,
+    do_OPERATION_TYPE_STRING_LENGTH,
+    do_OPERATION_TYPE_STRING_SUBSTRING,
+    do_OPERATION_TYPE_STRING_FIND,
+    do_OPERATION_TYPE_STRING_PAD_START,
+    do_OPERATION_TYPE_STRING_SPLIT,
+    do_OPERATION_TYPE_STRING_FROM_CODE_POINT,
+    do_OPERATION_TYPE_STRING_CODE_POINT_AT,
+    do_OPERATION_TYPE_STRING_FORMAT,
+    do_OPERATION_TYPE_STRING_FORMAT_PREFIX,
+    do_OPERATION_TYPE_ARRAY_LENGTH,
+    do_OPERATION_TYPE_ARRAY_SLICE,
+    do_OPERATION_TYPE_DATE_GET_YEAR,
+    do_OPERATION_TYPE_DATE_GET_MONTH,
+    do_OPERATION_TYPE_DATE_GET_DAY,
+    do_OPERATION_TYPE_DATE_GET_HOURS,
+    do_OPERATION_TYPE_DATE_GET_MINUTES,
+    do_OPERATION_TYPE_DATE_GET_SECONDS,
+    do_OPERATION_TYPE_DATE_GET_MILLISECONDS,
+    do_OPERATION_TYPE_DATE_MAKE,
+    do_OPERATION_TYPE_JSON_GET,
+    do_OPERATION_TYPE_BLOB_TO_STRING,
+};
+bool isPureOperation(uint16_t operationIndex) {
+    if (operationIndex >= sizeof(g_evalOperations) / sizeof(EvalOperation)) {
+        return false;
+    }
+    auto operation = g_evalOperations[operationIndex];
+    for (size_t i = 0; i < sizeof(g_pureOperations) / sizeof(EvalOperation); i++) {
+        if (g_pureOperations[i] == operation) {
+            return true;
+        }
+    }
+    return false;
+}
 } 
 } 
 // -----------------------------------------------------------------------------
@@ -10369,7 +11978,11 @@ using namespace eez::gui;
 namespace eez {
 namespace flow {
 GlobalVariables *g_globalVariables = nullptr;
+static uint32_t *g_globalVariableVersions = nullptr;
+static uint32_t g_valuesVersion = 0;
+static uint32_t g_nestedValuesVersion = 0;
 static const unsigned NO_COMPONENT_INDEX = 0xFFFFFFFF;
+static const unsigned PROPAGATE_VALUE_BATCH_SIZE = 32;
 static bool g_enableThrowError = true;
 inline bool isInputEmpty(const Value& inputValue) {
     return inputValue.type == VALUE_TYPE_UNDEFINED && inputValue.int32Value > 0;
@@ -10390,10 +12003,42 @@ void initGlobalVariables(Assets *assets) {
         (numVars > 0 ? numVars - 1 : 0) * sizeof(Value),
         0xcc34ca8e
     );
+    g_globalVariables->count = numVars;
     for (uint32_t i = 0; i < numVars; i++) {
 		new (g_globalVariables->values + i) Value();
         g_globalVariables->values[i] = flowDefinition->globalVariables[i]->clone();
 	}
+    g_globalVariableVersions = (uint32_t *)alloc((numVars > 0 ? numVars : 1) * sizeof(uint32_t), 0x8f1e5a27);
+    g_valuesVersion++;
+    g_nestedValuesVersion = g_valuesVersion;
+    for (uint32_t i = 0; i < numVars; i++) {
+        g_globalVariableVersions[i] = g_valuesVersion;
+    }
+}
+void markValueChanged(FlowState *flowState, const Value *pValue) {
+    g_valuesVersion++;
+    if (g_globalVariables && pValue >= g_globalVariables->values && pValue < g_globalVariables->values + g_globalVariables->count) {
+        if (g_globalVariableVersions) {
+            g_globalVariableVersions[pValue - g_globalVariables->values] = g_valuesVersion;
+        }
+        return;
+    }
+    if (flowState && pValue >= flowState->values && pValue < flowState->values + flowState->flow->componentInputs.count + flowState->flow->localVariables.count) {
+        return;
+    }
+    g_nestedValuesVersion = g_valuesVersion;
+}
+uint32_t getValuesVersion() {
+    return g_valuesVersion;
+}
+uint32_t getNestedValuesVersion() {
+    return g_nestedValuesVersion;
+}
+uint32_t getGlobalVariableVersion(uint32_t globalVariableIndex) {
+    if (g_globalVariableVersions && globalVariableIndex < g_globalVariables->count) {
+        return g_globalVariableVersions[globalVariableIndex];
+    }
+    return g_valuesVersion;
 }
 static bool isComponentReadyToRun(FlowState *flowState, unsigned componentIndex) {
 	auto component = flowState->flow->components[componentIndex];
@@ -10644,7 +12289,7 @@ void resetSequenceInputs(FlowState *flowState) {
                     auto pValue = &flowState->values[inputIndex];
                     if (!isInputEmpty(*pValue)) {
                         *pValue = getEmptyInputValue();
-                        onValueChanged(pValue);
+                        onValueChanged(flowState, pValue);
                     }
                 }
             }
@@ -10660,15 +12305,38 @@ void propagateValue(FlowState *flowState, unsigned componentIndex, unsigned outp
     resetSequenceInputs(flowState);
 	auto component = flowState->flow->components[componentIndex];
 	auto componentOutput = component->outputs[outputIndex];
+    auto &connections = componentOutput->connections;
     auto value2 = value.getValue();
-	for (unsigned connectionIndex = 0; connectionIndex < componentOutput->connections.count; connectionIndex++) {
-		auto connection = componentOutput->connections[connectionIndex];
+    if (connections.count == 1) {
+		auto connection = connections[0];
 		auto pValue = &flowState->values[connection->targetInputIndex];
 		if (*pValue != value2) {
 			*pValue = value2;
-				onValueChanged(pValue);
+			onValueChanged(flowState, pValue);
 		}
 		pingComponent(flowState, connection->targetComponentIndex, componentIndex, outputIndex, connection->targetInputIndex);
+        return;
+    }
+    const Value *changedValues[PROPAGATE_VALUE_BATCH_SIZE];
+    unsigned numChangedValues = 0;
+	for (unsigned connectionIndex = 0; connectionIndex < connections.count; connectionIndex++) {
+		auto connection = connections[connectionIndex];
+		auto pValue = &flowState->values[connection->targetInputIndex];
+		if (*pValue != value2) {
+			*pValue = value2;
+            changedValues[numChangedValues++] = pValue;
+            if (numChangedValues == PROPAGATE_VALUE_BATCH_SIZE) {
+                onValuesChanged(flowState, changedValues, numChangedValues);
+                numChangedValues = 0;
+            }
+		}
+	}
+    if (numChangedValues > 0) {
+        onValuesChanged(flowState, changedValues, numChangedValues);
+    }
+	for (unsigned connectionIndex = 0; connectionIndex < connections.count; connectionIndex++) {
+		auto connection = connections[connectionIndex];
+		pingComponent(flowState, connection->targetComponentIndex, componentIndex, outputIndex, connection->targetInputIndex);
 	}
 }
 void propagateValue(FlowState *flowState, unsigned componentIndex, unsigned outputIndex) {
@@ -10741,6 +12409,7 @@ void assignValue(FlowState *flowState, int componentIndex, Value &dstValue, cons
                     throwError(flowState, componentIndex, FlowError::Plain(errorMessage));
                 } else {
                     blobRef->blob[arrayElementValue->elementIndex] = elementValue;
+                    markValueChanged(flowState, &arrayElementValue->arrayValue);
                 }
                 return;
             } else {
@@ -10785,20 +12454,20 @@ void assignValue(FlowState *flowState, int componentIndex, Value &dstValue, cons
 		                propagateValue(propertyRef->flowState, propertyRef->componentIndex, dstValue.getUInt16(), srcValue);
                     } else {
 	                    assignValue(flowState, componentIndex, dstValue, srcValue);
-                        onValueChanged(pDstValue);
+                        onValueChanged(flowState, pDstValue);
                     }
                 }
                 return;
             }
             if (pDstValue->type == VALUE_TYPE_VALUE_PTR) {
-                onValueChanged(pDstValue);
+                onValueChanged(flowState, pDstValue);
                 pDstValue = pDstValue->pValueValue;
             } else {
                 break;
             }
         }
         if (assignValue(*pDstValue, srcValue, dstValueType)) {
-            onValueChanged(pDstValue);
+            onValueChanged(flowState, pDstValue);
         } else {
             char errorMessage[100];
             snprintf(errorMessage, sizeof(errorMessage), "Can not assign %s to %s\n",
@@ -10810,7 +12479,7 @@ void assignValue(FlowState *flowState, int componentIndex, Value &dstValue, cons
 }
 void clearInputValue(FlowState *flowState, int inputIndex) {
     flowState->values[inputIndex] = Value();
-    onValueChanged(flowState->values + inputIndex);
+    onValueChanged(flowState, flowState->values + inputIndex);
 }
 void startAsyncExecution(FlowState *flowState, int componentIndex) {
     if (!flowState->componenentAsyncStates[componentIndex]) {
@@ -11035,6 +12704,155 @@ void enableThrowError(bool enable) {
 } 
 } 
 // -----------------------------------------------------------------------------
+// flow/profiler.cpp
+// -----------------------------------------------------------------------------
+#if EEZ_OPTION_FLOW_PROFILER
+namespace eez {
+namespace flow {
+#if !defined(EEZ_FLOW_PROFILER_MAX_ENTRIES)
+#if defined(__EMSCRIPTEN__)
+#define EEZ_FLOW_PROFILER_MAX_ENTRIES 4096
+#else
+#define EEZ_FLOW_PROFILER_MAX_ENTRIES 128
+#endif
+#endif
+static const uint32_t PROFILER_MAX_ENTRIES = EEZ_FLOW_PROFILER_MAX_ENTRIES;
+static const uint32_t PROFILER_INDEX_SIZE = 2 * EEZ_FLOW_PROFILER_MAX_ENTRIES;
+static const uint32_t PROFILER_DEFAULT_SAMPLING_PERIOD = 16;
+ProfilerMode g_profilerMode = PROFILER_MODE_OFF;
+static uint32_t g_profilerSamplingPeriod = PROFILER_DEFAULT_SAMPLING_PERIOD;
+static ProfilerEntry g_profilerEntries[PROFILER_MAX_ENTRIES];
+static int32_t g_profilerIndex[PROFILER_INDEX_SIZE];
+static uint32_t g_numProfilerEntries;
+static uint32_t g_numDroppedProfilerEntries;
+void setProfilerMode(ProfilerMode mode, uint32_t samplingPeriod) {
+    if (mode != PROFILER_MODE_OFF && g_profilerMode == PROFILER_MODE_OFF) {
+        resetProfiler();
+    }
+    g_profilerSamplingPeriod = samplingPeriod > 0 ? samplingPeriod : PROFILER_DEFAULT_SAMPLING_PERIOD;
+    g_profilerMode = mode;
+}
+uint32_t getProfilerSamplingPeriod() {
+    return g_profilerSamplingPeriod;
+}
+void resetProfiler() {
+    for (uint32_t i = 0; i < PROFILER_INDEX_SIZE; i++) {
+        g_profilerIndex[i] = -1;
+    }
+    g_numProfilerEntries = 0;
+    g_numDroppedProfilerEntries = 0;
+}
+const ProfilerEntry *getProfilerEntries(uint32_t &numEntries, uint32_t &numDroppedEntries) {
+    numEntries = g_numProfilerEntries;
+    numDroppedEntries = g_numDroppedProfilerEntries;
+    return g_profilerEntries;
+}
+static ProfilerEntry *findProfilerEntry(FlowState *flowState, int componentIndex, int propertyIndex) {
+    auto flowIndex = flowState->flowIndex;
+    uint32_t hash = ((uint32_t)flowIndex * 2654435761u) ^ ((uint32_t)componentIndex * 40503u) ^ (uint32_t)(propertyIndex + 1);
+    auto i = hash % PROFILER_INDEX_SIZE;
+    while (g_profilerIndex[i] != -1) {
+        auto entry = &g_profilerEntries[g_profilerIndex[i]];
+        if (entry->flowIndex == flowIndex && entry->componentIndex == componentIndex && entry->propertyIndex == propertyIndex) {
+            return entry;
+        }
+        i = (i + 1) % PROFILER_INDEX_SIZE;
+    }
+    if (g_numProfilerEntries == PROFILER_MAX_ENTRIES) {
+        g_numDroppedProfilerEntries++;
+        return nullptr;
+    }
+    g_profilerIndex[i] = g_numProfilerEntries;
+    auto entry = &g_profilerEntries[g_numProfilerEntries++];
+    entry->flowIndex = flowIndex;
+    entry->componentIndex = componentIndex;
+    entry->propertyIndex = propertyIndex;
+    entry->componentType = flowState->flow->components[componentIndex]->type;
+    entry->count = 0;
+    entry->sampledCount = 0;
+    entry->sampledTime = 0;
+    entry->sampledAllocs = 0;
+    return entry;
+}
+static ProfilerScope *g_currentProfilerScope;
+void ProfilerScope::begin(FlowState *flowState, int componentIndex, int propertyIndex) {
+    auto entry = findProfilerEntry(flowState, componentIndex, propertyIndex);
+    bool sampled = false;
+    if (entry) {
+        if (g_profilerMode == PROFILER_MODE_SAMPLING) {
+            sampled = entry->count++ % g_profilerSamplingPeriod == 0;
+        } else {
+            entry->count++;
+            sampled = true;
+        }
+    }
+    if (!sampled && !g_currentProfilerScope) {
+        return;
+    }
+    m_entry = sampled ? entry : nullptr;
+    m_parent = g_currentProfilerScope;
+    m_active = true;
+    m_childTime = 0;
+    m_childAllocs = 0;
+    g_currentProfilerScope = this;
+    m_startNumAllocs = g_numAllocs;
+    m_startTime = micros();
+}
+void ProfilerScope::end() {
+    auto time = micros() - m_startTime;
+    auto numAllocs = g_numAllocs - m_startNumAllocs;
+    g_currentProfilerScope = m_parent;
+    if (m_parent) {
+        m_parent->m_childTime += time;
+        m_parent->m_childAllocs += numAllocs;
+    }
+    if (m_entry) {
+        m_entry->sampledCount++;
+        m_entry->sampledTime += time - m_childTime;
+        m_entry->sampledAllocs += numAllocs - m_childAllocs;
+    }
+}
+static void writeProfilerBinaryField(void (*writeHook)(const char *buffer, uint32_t length), const void *data, uint32_t length) {
+    writeHook((const char *)data, length);
+}
+void writeProfilerData(ProfilerDataFormat format, void (*writeHook)(const char *buffer, uint32_t length)) {
+    if (format == PROFILER_DATA_FORMAT_BINARY) {
+        uint8_t header[8] = { 'E', 'Z', 'P', 'F', 1, (uint8_t)g_profilerMode, 0, 0 };
+        writeProfilerBinaryField(writeHook, header, sizeof(header));
+        writeProfilerBinaryField(writeHook, &g_profilerSamplingPeriod, sizeof(uint32_t));
+        writeProfilerBinaryField(writeHook, &g_numProfilerEntries, sizeof(uint32_t));
+        writeProfilerBinaryField(writeHook, &g_numDroppedProfilerEntries, sizeof(uint32_t));
+        for (uint32_t i = 0; i < g_numProfilerEntries; i++) {
+            auto &entry = g_profilerEntries[i];
+            writeProfilerBinaryField(writeHook, &entry.flowIndex, sizeof(int32_t));
+            writeProfilerBinaryField(writeHook, &entry.componentIndex, sizeof(int32_t));
+            writeProfilerBinaryField(writeHook, &entry.propertyIndex, sizeof(int32_t));
+            writeProfilerBinaryField(writeHook, &entry.componentType, sizeof(uint16_t));
+            writeProfilerBinaryField(writeHook, &entry.count, sizeof(uint32_t));
+            writeProfilerBinaryField(writeHook, &entry.sampledCount, sizeof(uint32_t));
+            writeProfilerBinaryField(writeHook, &entry.sampledTime, sizeof(uint64_t));
+            writeProfilerBinaryField(writeHook, &entry.sampledAllocs, sizeof(uint32_t));
+        }
+    } else {
+        char buffer[256];
+        snprintf(buffer, sizeof(buffer), "{\"mode\":%d,\"samplingPeriod\":%u,\"droppedEntries\":%u,\"entries\":[",
+            (int)g_profilerMode, (unsigned int)g_profilerSamplingPeriod, (unsigned int)g_numDroppedProfilerEntries);
+        writeHook(buffer, strlen(buffer));
+        for (uint32_t i = 0; i < g_numProfilerEntries; i++) {
+            auto &entry = g_profilerEntries[i];
+            snprintf(buffer, sizeof(buffer), "%s{\"flow\":%d,\"component\":%d,\"property\":%d,\"type\":%u,\"count\":%u,\"sampledCount\":%u,\"sampledTime\":%.0f,\"sampledAllocs\":%u}",
+                i > 0 ? "," : "",
+                (int)entry.flowIndex, (int)entry.componentIndex, (int)entry.propertyIndex, (unsigned int)entry.componentType,
+                (unsigned int)entry.count, (unsigned int)entry.sampledCount, (double)entry.sampledTime, (unsigned int)entry.sampledAllocs);
+            writeHook(buffer, strlen(buffer));
+        }
+        writeHook("]}", 2);
+    }
+}
+} 
+} 
+#endif
+// -----------------------------------------------------------------------------
 // flow/queue.cpp
 // -----------------------------------------------------------------------------
 namespace eez {
@@ -11096,6 +12914,16 @@ bool addToQueue(FlowState *flowState, unsigned componentIndex, int sourceCompone
     incRefCounterForFlowState(flowState);
 	return true;
 }
+bool getTaskFromQueue(unsigned taskIndex, FlowState *&flowState, unsigned &componentIndex, bool &continuousTask) {
+	if (taskIndex >= getQueueSize()) {
+		return false;
+	}
+    auto it = (g_queueHead + taskIndex) % QUEUE_SIZE;
+	flowState = g_queue[it].flowState;
+	componentIndex = g_queue[it].componentIndex;
+    continuousTask = g_queue[it].continuousTask;
+	return true;
+}
 bool peekNextTaskFromQueue(FlowState *&flowState, unsigned &componentIndex, bool &continuousTask) {
 	if (g_queueHead == g_queueTail && !g_queueIsFull) {
 		return false;
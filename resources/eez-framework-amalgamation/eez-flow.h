@@ -217,6 +217,7 @@ template<class T> struct ObjectAllocator {
 void dumpAlloc(scpi_t *context);
 #endif
 void getAllocInfo(uint32_t &free, uint32_t &alloc);
+extern uint32_t g_numAllocs;
 } 
 // -----------------------------------------------------------------------------
 // flow/flow_defs_v3.h
@@ -1265,6 +1266,7 @@ struct Value {
     bool toBool(int *err = nullptr) const;
 	Value toString(uint32_t id) const;
 	static Value makeStringRef(const char *str, int len, uint32_t id);
+	static Value makeStringSlice(const Value &parent, int offset, uint32_t id);
 	static Value concatenateString(const Value &str1, const Value &str2);
     static Value makeArrayRef(int arraySize, int arrayType, uint32_t id);
     static Value makeArrayElementRef(Value arrayValue, int elementIndex, uint32_t id);
@@ -1318,6 +1320,12 @@ struct StringRef : public Ref {
     }
 	char *str;
 };
+struct StringSliceRef : public StringRef {
+    ~StringSliceRef() {
+        str = nullptr;
+    }
+    Value parent;
+};
 struct ArrayValue {
 	uint32_t arraySize;
     uint32_t arrayType;
@@ -1561,9 +1569,18 @@ void executeActionFunction(int actionId);
 // core/assets.h
 // -----------------------------------------------------------------------------
 #include <stdint.h>
+#if !defined(EEZ_OPTION_ASSETS_MMAP)
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+#define EEZ_OPTION_ASSETS_MMAP 1
+#else
+#define EEZ_OPTION_ASSETS_MMAP 0
+#endif
+#endif
 namespace eez {
 static const uint32_t HEADER_TAG = 0x5A45457E; 
 static const uint32_t HEADER_TAG_COMPRESSED = 0x7A65657E; 
+static const uint32_t HEADER_TAG_CHUNKED = 0x637A657E; 
+static const uint32_t HEADER_TAG_ALIGNED = 0x4145457E; 
 static const uint8_t PROJECT_VERSION_V2 = 2;
 static const uint8_t PROJECT_VERSION_V3 = 3;
 static const uint8_t ASSETS_TYPE_FIRMWARE = 1;
@@ -1579,6 +1596,23 @@ struct Header {
     uint8_t reserved;
 	uint32_t decompressedSize;
 };
+static const uint16_t ASSETS_BLOCK_KIND_EAGER = 0;
+static const uint16_t ASSETS_BLOCK_KIND_BITMAP = 1;
+static const uint16_t ASSETS_BLOCK_KIND_FONT = 2;
+static const uint16_t ASSETS_BLOCK_KIND_LANGUAGE = 3;
+struct AssetsBlock {
+    uint32_t decompressedOffset;
+    uint32_t decompressedSize;
+    uint32_t compressedOffset;
+    uint32_t compressedSize;
+    uint16_t kind;
+    uint16_t reserved;
+    uint32_t assetIndex;
+};
+struct ChunkedHeader : public Header {
+    uint32_t numBlocks;
+    AssetsBlock blocks[1];
+};
 extern bool g_isMainAssetsLoaded;
 struct Assets;
 extern Assets *g_mainAssets;
@@ -1891,6 +1925,11 @@ struct Assets {
 };
 bool decompressAssetsData(const uint8_t *assetsData, uint32_t assetsDataSize, Assets *decompressedAssets, uint32_t maxDecompressedAssetsSize, int *err);
 void loadMainAssets(const uint8_t *assets, uint32_t assetsSize);
+void loadLazyLanguage(Assets *assets, uint32_t languageIndex);
+#if EEZ_OPTION_ASSETS_MMAP
+bool loadMainAssetsFromFile(const char *filePath, int *err);
+void unloadMainAssets();
+#endif
 bool loadExternalAssets(const char *filePath, int *err);
 void unloadExternalAssets();
 #if EEZ_OPTION_GUI
@@ -1900,6 +1939,8 @@ const gui::Style *getStyle(int styleID);
 const gui::FontData *getFontData(int fontID);
 const gui::Bitmap *getBitmap(int bitmapID);
 const int getBitmapIdByName(const char *bitmapName);
+#elif defined(EEZ_FOR_LVGL)
+int getBitmapIdByName(const char *bitmapName);
 #endif
 int getThemesCount();
 const char *getThemeName(int i);
@@ -1907,6 +1948,8 @@ uint32_t getThemeColorsCount(int themeIndex);
 const uint16_t *getThemeColors(int themeIndex);
 const uint16_t *getColors();
 int getExternalAssetsMainPageId();
+int getVariableIdByName(const char *variableName);
+int getActionIdByName(const char *actionName);
 #if EEZ_OPTION_GUI
 const char *getActionName(const gui::WidgetCursor &widgetCursor, int16_t actionId);
 int16_t getDataIdFromName(const gui::WidgetCursor &widgetCursor, const char *name);
@@ -2014,6 +2057,7 @@ enum TestResult {
 	TEST_WARNING
 };
 uint32_t millis();
+uint32_t micros();
 extern bool g_shutdown;
 void shutdown();
 } 
@@ -2136,6 +2180,7 @@ inline utf8_int8_t *utf8catcodepoint(utf8_int8_t *str, utf8_int32_t chr, size_t
 // -----------------------------------------------------------------------------
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #define clear_bit(reg, bitmask) *reg &= ~bitmask
 #define set_bit(reg, bitmask) *reg |= bitmask
 #define util_swap(type, i, j)                                                                      \
@@ -2169,6 +2214,8 @@ void stringAppendInt(char *str, size_t maxStrLength, int value);
 void stringAppendUInt32(char *str, size_t maxStrLength, uint32_t value);
 void stringAppendInt64(char *str, size_t maxStrLength, int64_t value);
 void stringAppendUInt64(char *str, size_t maxStrLength, uint64_t value);
+int formatDouble(char *str, size_t strSize, double value);
+int formatDoubleFixed(char *str, size_t strSize, double value, int numDecimalPlaces);
 void stringAppendFloat(char *str, size_t maxStrLength, float value);
 void stringAppendFloat(char *str, size_t maxStrLength, float value, int numDecimalPlaces);
 void stringAppendDouble(char *str, size_t maxStrLength, double value);
@@ -2221,6 +2268,7 @@ bool endsWithNoCase(const char *str, const char *suffix);
 void formatBytes(uint64_t bytes, char *text, int count);
 void getFileName(const char *path, char *fileName, unsigned fileNameSize);
 void getBaseFileName(const char *path, char *baseName, unsigned baseNameSize);
+uint32_t hashName(const char *name);
 typedef float (*EasingFuncType)(float x);
 extern EasingFuncType g_easingFuncs[];
 class Interval {
@@ -2269,6 +2317,81 @@ private:
     uint64_t m_numSamples{0};
     Total m_total{0};
 };
+class NameIndex {
+public:
+    template<typename GetName>
+    int32_t find(const void *source, uint32_t count, const char *name, GetName getName) {
+        if (m_source != source || m_count != count) {
+            build(source, count, getName);
+        }
+        if (!m_slots) {
+            for (uint32_t i = 0; i < count; i++) {
+                if (strcmp(getName(i), name) == 0) {
+                    return (int32_t)i;
+                }
+            }
+            return -1;
+        }
+        uint32_t hash = hashName(name);
+        uint32_t mask = m_numSlots - 1;
+        for (uint32_t slot = hash & mask; m_slots[slot].index != 0; slot = (slot + 1) & mask) {
+            if (m_slots[slot].hash == hash) {
+                uint32_t i = m_slots[slot].index - 1;
+                if (strcmp(getName(i), name) == 0) {
+                    return (int32_t)i;
+                }
+            }
+        }
+        return -1;
+    }
+    void reset() {
+        if (m_slots) {
+            eez::free(m_slots);
+            m_slots = nullptr;
+        }
+        m_source = nullptr;
+        m_count = 0;
+        m_numSlots = 0;
+    }
+private:
+    struct Slot {
+        uint32_t hash;
+        uint32_t index;
+    };
+    const void *m_source = nullptr;
+    uint32_t m_count = 0;
+    uint32_t m_numSlots = 0;
+    Slot *m_slots = nullptr;
+    template<typename GetName>
+    void build(const void *source, uint32_t count, GetName getName) {
+        reset();
+        m_source = source;
+        m_count = count;
+        if (count < 8) {
+            return;
+        }
+        uint32_t numSlots = 16;
+        while (numSlots < 2 * count) {
+            numSlots <<= 1;
+        }
+        m_slots = (Slot *)eez::alloc(numSlots * sizeof(Slot), 0x4e1d8a73);
+        if (!m_slots) {
+            return;
+        }
+        memset(m_slots, 0, numSlots * sizeof(Slot));
+        m_numSlots = numSlots;
+        uint32_t mask = numSlots - 1;
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t hash = hashName(getName(i));
+            uint32_t slot = hash & mask;
+            while (m_slots[slot].index != 0) {
+                slot = (slot + 1) & mask;
+            }
+            m_slots[slot].hash = hash;
+            m_slots[slot].index = i + 1;
+        }
+    }
+};
 } 
 #ifdef EEZ_PLATFORM_SIMULATOR_WIN32
 char *strnstr(const char *s1, const char *s2, size_t n);
@@ -2366,6 +2489,7 @@ void setValue(uint16_t dataId, const WidgetCursor &widgetCursor, const Value& va
 #endif
 void assignValue(FlowState *flowState, int componentIndex, Value &dstValue, const Value &srcValue);
 void clearInputValue(FlowState *flowState, int inputIndex);
+void markValueChanged(FlowState *flowState, const Value *pValue);
 void startAsyncExecution(FlowState *flowState, int componentIndex);
 void endAsyncExecution(FlowState *flowState, int componentIndex);
 void executeCallAction(FlowState *flowState, unsigned componentIndex, int flowIndex, const Value& value);
@@ -2528,8 +2652,11 @@ void onStopped();
 void onAddToQueue(FlowState *flowState, int sourceComponentIndex, int sourceOutputIndex, unsigned targetComponentIndex, int targetInputIndex);
 void onRemoveFromQueue();
 void onValueChanged(const Value *pValue);
+void onValueChanged(FlowState *flowState, const Value *pValue);
+void onValuesChanged(FlowState *flowState, const Value **pValues, unsigned count);
 void onFlowStateCreated(FlowState *flowState);
 void onFlowStateDestroyed(FlowState *flowState);
+void onTickFinished();
 void onFlowStateTimelineChanged(FlowState *flowState);
 void onFlowError(FlowState *flowState, int componentIndex, const char *errorMessage);
 void onComponentExecutionStateChanged(FlowState *flowState, int componentIndex);
@@ -2599,6 +2726,13 @@ bool evalProperty(FlowState *flowState, int componentIndex, int propertyIndex, V
 bool evalProperty(FlowState *flowState, int componentIndex, int propertyIndex, Value &result, const FlowError &errorMessage, int *numInstructionBytes = nullptr, const int32_t *iterators = nullptr);
 #endif
 bool evalAssignableProperty(FlowState *flowState, int componentIndex, int propertyIndex, Value &result, const FlowError &errorMessage, int *numInstructionBytes = nullptr, const int32_t *iterators = nullptr);
+static const uint32_t MAX_PROPERTY_GLOBAL_VARIABLE_DEPENDENCIES = 8;
+struct PropertyDependencies {
+    bool flowValues;
+    uint32_t numGlobalVariables;
+    uint32_t globalVariables[MAX_PROPERTY_GLOBAL_VARIABLE_DEPENDENCIES];
+};
+bool getPropertyDependencies(FlowState *flowState, int componentIndex, int propertyIndex, PropertyDependencies &dependencies);
 } 
 } 
 // -----------------------------------------------------------------------------
@@ -2629,6 +2763,9 @@ Value getGlobalVariable(uint32_t globalVariableIndex);
 Value getGlobalVariable(Assets *assets, uint32_t globalVariableIndex);
 void setGlobalVariable(uint32_t globalVariableIndex, const Value &value);
 void setGlobalVariable(Assets *assets, uint32_t globalVariableIndex, const Value &value);
+uint32_t getValuesVersion();
+uint32_t getNestedValuesVersion();
+uint32_t getGlobalVariableVersion(uint32_t globalVariableIndex);
 Value getUserProperty(unsigned propertyIndex);
 void setUserProperty(unsigned propertyIndex, const Value &value);
 struct AsyncAction {
@@ -2694,6 +2831,7 @@ namespace eez {
 namespace flow {
 typedef void (*EvalOperation)(EvalStack &);
 extern EvalOperation g_evalOperations[];
+bool isPureOperation(uint16_t operationIndex);
 Value op_add(const Value& a1, const Value& b1);
 Value op_sub(const Value& a1, const Value& b1);
 Value op_mul(const Value& a1, const Value& b1);
@@ -2713,6 +2851,70 @@ Value op_great_eq(const Value& a1, const Value& b1);
 } 
 } 
 // -----------------------------------------------------------------------------
+// flow/profiler.h
+// -----------------------------------------------------------------------------
+#if !defined(EEZ_OPTION_FLOW_PROFILER)
+#if defined(__EMSCRIPTEN__)
+#define EEZ_OPTION_FLOW_PROFILER 1
+#else
+#define EEZ_OPTION_FLOW_PROFILER 0
+#endif
+#endif
+#if EEZ_OPTION_FLOW_PROFILER
+namespace eez {
+namespace flow {
+enum ProfilerMode {
+    PROFILER_MODE_OFF,
+    PROFILER_MODE_SAMPLING,
+    PROFILER_MODE_EXACT
+};
+enum ProfilerDataFormat {
+    PROFILER_DATA_FORMAT_BINARY,
+    PROFILER_DATA_FORMAT_JSON
+};
+struct ProfilerEntry {
+    int32_t flowIndex;
+    int32_t componentIndex;
+    int32_t propertyIndex;
+    uint16_t componentType;
+    uint32_t count;
+    uint32_t sampledCount;
+    uint64_t sampledTime;
+    uint32_t sampledAllocs;
+};
+extern ProfilerMode g_profilerMode;
+void setProfilerMode(ProfilerMode mode, uint32_t samplingPeriod);
+uint32_t getProfilerSamplingPeriod();
+void resetProfiler();
+const ProfilerEntry *getProfilerEntries(uint32_t &numEntries, uint32_t &numDroppedEntries);
+void writeProfilerData(ProfilerDataFormat format, void (*writeHook)(const char *buffer, uint32_t length));
+class ProfilerScope {
+public:
+    ProfilerScope(FlowState *flowState, int componentIndex, int propertyIndex) : m_entry(nullptr), m_active(false) {
+        if (g_profilerMode != PROFILER_MODE_OFF) {
+            begin(flowState, componentIndex, propertyIndex);
+        }
+    }
+    ~ProfilerScope() {
+        if (m_active) {
+            end();
+        }
+    }
+private:
+    ProfilerEntry *m_entry;
+    ProfilerScope *m_parent;
+    bool m_active;
+    uint32_t m_startTime;
+    uint32_t m_startNumAllocs;
+    uint32_t m_childTime;
+    uint32_t m_childAllocs;
+    void begin(FlowState *flowState, int componentIndex, int propertyIndex);
+    void end();
+};
+} 
+} 
+#endif
+// -----------------------------------------------------------------------------
 // flow/queue.h
 // -----------------------------------------------------------------------------
 namespace eez {
@@ -2724,6 +2926,7 @@ extern unsigned g_numNonContinuousTaskInQueue;
 bool addToQueue(FlowState *flowState, unsigned componentIndex,
     int sourceComponentIndex, int sourceOutputIndex, int targetInputIndex,
     bool continuousTask);
+bool getTaskFromQueue(unsigned taskIndex, FlowState *&flowState, unsigned &componentIndex, bool &continuousTask);
 bool peekNextTaskFromQueue(FlowState *&flowState, unsigned &componentIndex, bool &continuousTask);
 void removeNextTaskFromQueue();
 bool isInQueue(FlowState *flowState, unsigned componentIndex);
@@ -2947,12 +3150,18 @@ namespace eez {
 namespace flow {
 #define SORT_ARRAY_FLAG_ASCENDING   (1 << 0)
 #define SORT_ARRAY_FLAG_IGNORE_CASE (1 << 1)
+#define SORT_ARRAY_FLAG_THEN_BY     (1 << 2)
+struct SortArrayThenBy {
+    int32_t structFieldIndex;
+    uint32_t flags;
+};
 struct SortArrayActionComponent : public Component {
     int32_t arrayType;
     int32_t structFieldIndex;
     uint32_t flags;
+    ListOfAssetsPtr<SortArrayThenBy> thenBy;
 };
-void sortArray(SortArrayActionComponent *component, ArrayValue *array);
+bool sortArray(SortArrayActionComponent *component, ArrayValue *array);
 } 
 } 
 // -----------------------------------------------------------------------------
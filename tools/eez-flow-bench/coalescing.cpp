@@ -0,0 +1,121 @@
+// Measures how many value changed messages the debugger gets while the flow
+// is running, with and without coalescing. Every tick a number of global
+// variables is changed, as a busy flow would do, and onTickFinished is called
+// at the end of the tick, which flushes the coalesced changes at most
+// MAX_UPDATES_PER_SECOND times per second.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <chrono>
+
+#include "eez-flow.h"
+
+using namespace eez;
+using namespace eez::flow;
+
+extern "C" void create_screens() {}
+native_var_t native_vars[] = { { NATIVE_VAR_TYPE_NONE, 0, 0 } };
+
+static const uint32_t NUM_GLOBAL_VARIABLES = 200;
+static const uint32_t MAX_UPDATES_PER_SECOND = 30;
+
+static uint64_t g_bytes;
+static uint64_t g_messages;
+
+static void startToDebuggerMessage() {
+}
+
+// text protocol, every message ends with '\n'
+static void writeDebuggerBuffer(const char *buffer, uint32_t length) {
+    g_bytes += length;
+    for (uint32_t i = 0; i < length; i++) {
+        if (buffer[i] == '\n') {
+            g_messages++;
+        }
+    }
+}
+
+// must be the same as MESSAGE_FROM_DEBUGGER_COALESCE in eez-flow.cpp
+static void setCoalesce(uint32_t maxUpdatesPerSecond) {
+    char message[16];
+    snprintf(message, sizeof(message), "9\t%u\n", (unsigned)maxUpdatesPerSecond);
+    processDebuggerInput(message, strlen(message));
+}
+
+static void resume() {
+    char message[] = "0\n";
+    processDebuggerInput(message, strlen(message));
+}
+
+static void run(const char *name, uint32_t maxUpdatesPerSecond, uint32_t numTicks, uint32_t changesPerTick, uint32_t numVariables) {
+    setCoalesce(maxUpdatesPerSecond);
+
+    g_bytes = 0;
+    g_messages = 0;
+    srand(1);
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t tick = 0; tick < numTicks; tick++) {
+        for (uint32_t i = 0; i < changesPerTick; i++) {
+            auto pValue = g_globalVariables->values + rand() % numVariables;
+            *pValue = Value((int)(tick * changesPerTick + i), VALUE_TYPE_INT32);
+            onValueChanged(pValue);
+        }
+        lv_tick_inc(1);
+        onTickFinished();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    uint64_t numChanges = (uint64_t)numTicks * changesPerTick;
+
+    printf("%-12s %4u variables %10.1f ns/change %9llu messages %8.1f KB\n",
+        name,
+        (unsigned)numVariables,
+        seconds * 1e9 / numChanges,
+        (unsigned long long)g_messages,
+        g_bytes / 1024.0
+    );
+}
+
+int main(int argc, char **argv) {
+    uint32_t numTicks = argc > 1 ? (uint32_t)atoi(argv[1]) : 10000;
+    uint32_t changesPerTick = 100;
+
+    lv_init();
+
+    startToDebuggerMessageHook = startToDebuggerMessage;
+    writeDebuggerBufferHook = writeDebuggerBuffer;
+
+    g_globalVariables = (GlobalVariables *)::malloc(sizeof(GlobalVariables) + (NUM_GLOBAL_VARIABLES - 1) * sizeof(Value));
+    g_globalVariables->count = NUM_GLOBAL_VARIABLES;
+    for (uint32_t i = 0; i < NUM_GLOBAL_VARIABLES; i++) {
+        new (g_globalVariables->values + i) Value();
+    }
+
+    onDebuggerClientConnected();
+    resume();
+
+    printf("%u ticks of 1 ms, %u changes per tick\n", (unsigned)numTicks, (unsigned)changesPerTick);
+
+    // 10 variables: the same few values change many times between flushes,
+    // 200 variables: the table holds more than 3/4 of its size and is flushed
+    // before the update period ends
+    static const uint32_t numVariables[] = { 10, 200 };
+    for (auto n : numVariables) {
+        run("immediate", 0, numTicks, changesPerTick, n);
+        run("coalesced", MAX_UPDATES_PER_SECOND, numTicks, changesPerTick, n);
+    }
+
+    onDebuggerClientDisconnected();
+
+    for (uint32_t i = 0; i < NUM_GLOBAL_VARIABLES; i++) {
+        g_globalVariables->values[i].~Value();
+    }
+    ::free(g_globalVariables);
+    g_globalVariables = nullptr;
+
+    return 0;
+}
@@ -0,0 +1,215 @@
+// Measures date::makeDate and date::breakDate, which convert between a
+// timestamp and year, month, day, ... fields, on dates from 1970 to 2100,
+// against the previous implementation which walked from 1970 one year and
+// one month at a time. Both implementations must give the same results.
+// utcToLocal with the Europe DST rule is measured too.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+#include "eez-flow.h"
+
+using namespace eez::flow::date;
+
+extern "C" void create_screens() {}
+native_var_t native_vars[] = { { NATIVE_VAR_TYPE_NONE, 0, 0 } };
+
+////////////////////////////////////////////////////////////////////////////////
+
+// previous implementation, from eez-framework before the closed form
+// conversions
+
+#define SECONDS_PER_MINUTE 60UL
+#define SECONDS_PER_HOUR (SECONDS_PER_MINUTE * 60)
+#define SECONDS_PER_DAY (SECONDS_PER_HOUR * 24)
+
+#define LEAP_YEAR(Y)                                                                               \
+    (((1970 + Y) > 0) && !((1970 + Y) % 4) && (((1970 + Y) % 100) || !((1970 + Y) % 400)))
+
+static const uint8_t monthDays[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+static Date previousMakeDate(int year, int month, int day, int hours, int minutes, int seconds, int milliseconds) {
+    year -= 1970;
+    Date time = year * 365 * SECONDS_PER_DAY;
+    for (int i = 0; i < year; i++) {
+        if (LEAP_YEAR(i)) {
+            time += SECONDS_PER_DAY;
+        }
+    }
+    for (int i = 1; i < month; i++) {
+        if ((i == 2) && LEAP_YEAR(year)) {
+            time += SECONDS_PER_DAY * 29;
+        } else {
+            time += SECONDS_PER_DAY * monthDays[i - 1];
+        }
+    }
+    time += (day - 1) * SECONDS_PER_DAY;
+    time += hours * SECONDS_PER_HOUR;
+    time += minutes * SECONDS_PER_MINUTE;
+    time += seconds;
+    time *= 1000;
+    time += milliseconds;
+    return time;
+}
+
+static void previousBreakDate(Date time, int &result_year, int &result_month, int &result_day, int &result_hours, int &result_minutes, int &result_seconds, int &result_milliseconds) {
+    uint8_t year;
+    uint8_t month, monthLength;
+    uint32_t days;
+    result_milliseconds = time % 1000;
+    time /= 1000;
+    result_seconds = time % 60;
+    time /= 60;
+    result_minutes = time % 60;
+    time /= 60;
+    result_hours = time % 24;
+    time /= 24;
+    year = 0;
+    days = 0;
+    while ((unsigned)(days += (LEAP_YEAR(year) ? 366 : 365)) <= time) {
+        year++;
+    }
+    result_year = year + 1970;
+    days -= LEAP_YEAR(year) ? 366 : 365;
+    time -= days;
+    days = 0;
+    month = 0;
+    monthLength = 0;
+    for (month = 0; month < 12; ++month) {
+        if (month == 1) {
+            if (LEAP_YEAR(year)) {
+                monthLength = 29;
+            } else {
+                monthLength = 28;
+            }
+        } else {
+            monthLength = monthDays[month];
+        }
+        if (time >= monthLength) {
+            time -= monthLength;
+        } else {
+            break;
+        }
+    }
+    result_month = month + 1;
+    result_day = time + 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct DateFields {
+    int year, month, day, hours, minutes, seconds, milliseconds;
+};
+
+static const uint32_t NUM_DATES = 65536;
+
+static DateFields g_fields[NUM_DATES];
+static Date g_times[NUM_DATES];
+
+static int daysInMonth(int year, int month) {
+    if (month == 2) {
+        return (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)) ? 29 : 28;
+    }
+    return monthDays[month - 1];
+}
+
+static void initDates() {
+    srand(1);
+    for (uint32_t i = 0; i < NUM_DATES; i++) {
+        auto &fields = g_fields[i];
+        fields.year = 1970 + rand() % 131;
+        fields.month = 1 + rand() % 12;
+        fields.day = 1 + rand() % daysInMonth(fields.year, fields.month);
+        fields.hours = rand() % 24;
+        fields.minutes = rand() % 60;
+        fields.seconds = rand() % 60;
+        fields.milliseconds = rand() % 1000;
+        g_times[i] = makeDate(fields.year, fields.month, fields.day, fields.hours, fields.minutes, fields.seconds, fields.milliseconds);
+    }
+}
+
+static bool check() {
+    for (uint32_t i = 0; i < NUM_DATES; i++) {
+        auto &fields = g_fields[i];
+        if (previousMakeDate(fields.year, fields.month, fields.day, fields.hours, fields.minutes, fields.seconds, fields.milliseconds) != g_times[i]) {
+            fprintf(stderr, "makeDate differs for %04d-%02d-%02d\n", fields.year, fields.month, fields.day);
+            return false;
+        }
+
+        DateFields result;
+        breakDate(g_times[i], result.year, result.month, result.day, result.hours, result.minutes, result.seconds, result.milliseconds);
+        DateFields previousResult;
+        previousBreakDate(g_times[i], previousResult.year, previousResult.month, previousResult.day, previousResult.hours, previousResult.minutes, previousResult.seconds, previousResult.milliseconds);
+        if (
+            result.year != fields.year || result.month != fields.month || result.day != fields.day ||
+            result.hours != fields.hours || result.minutes != fields.minutes || result.seconds != fields.seconds || result.milliseconds != fields.milliseconds ||
+            previousResult.year != result.year || previousResult.month != result.month || previousResult.day != result.day
+        ) {
+            fprintf(stderr, "breakDate differs for %04d-%02d-%02d\n", fields.year, fields.month, fields.day);
+            return false;
+        }
+    }
+    return true;
+}
+
+typedef Date (*MakeDateFunction)(int year, int month, int day, int hours, int minutes, int seconds, int milliseconds);
+typedef void (*BreakDateFunction)(Date time, int &year, int &month, int &day, int &hours, int &minutes, int &seconds, int &milliseconds);
+
+// returns ns per conversion, the sum is printed so that the loop is not
+// optimized away
+static double measureMakeDate(MakeDateFunction makeDateFunction, uint32_t numConversions, uint64_t &sum) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < numConversions; i++) {
+        auto &fields = g_fields[i % NUM_DATES];
+        sum += makeDateFunction(fields.year, fields.month, fields.day, fields.hours, fields.minutes, fields.seconds, fields.milliseconds);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / numConversions;
+}
+
+static double measureBreakDate(BreakDateFunction breakDateFunction, uint32_t numConversions, uint64_t &sum) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < numConversions; i++) {
+        DateFields result;
+        breakDateFunction(g_times[i % NUM_DATES], result.year, result.month, result.day, result.hours, result.minutes, result.seconds, result.milliseconds);
+        sum += result.year + result.month + result.day;
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / numConversions;
+}
+
+static double measureUtcToLocal(uint32_t numConversions, uint64_t &sum) {
+    // consecutive conversions are mostly in the same year, as when the
+    // current time is shown
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < numConversions; i++) {
+        sum += utcToLocal(g_times[0] + (Date)i * 1000);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / numConversions;
+}
+
+int main(int argc, char **argv) {
+    uint32_t numConversions = argc > 1 ? (uint32_t)atoi(argv[1]) : 10000000;
+
+    initDates();
+    if (!check()) {
+        return 1;
+    }
+
+    uint64_t sum = 0;
+
+    printf("%u conversions, dates from 1970 to 2100\n", (unsigned)numConversions);
+    printf("%-12s %12s %12s\n", "", "current", "previous");
+    printf("%-12s %9.1f ns %9.1f ns\n", "makeDate", measureMakeDate(makeDate, numConversions, sum), measureMakeDate(previousMakeDate, numConversions, sum));
+    printf("%-12s %9.1f ns %9.1f ns\n", "breakDate", measureBreakDate(breakDate, numConversions, sum), measureBreakDate(previousBreakDate, numConversions, sum));
+
+    g_timeZone = 100;
+    g_dstRule = DST_RULE_EUROPE;
+    printf("%-12s %9.1f ns %12s\n", "utcToLocal", measureUtcToLocal(numConversions, sum), "-");
+
+    printf("(%llu)\n", (unsigned long long)sum);
+
+    return 0;
+}
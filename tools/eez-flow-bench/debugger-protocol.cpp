@@ -0,0 +1,99 @@
+// Compares throughput of the text and binary debugger protocols by sending
+// value changed messages for a few typical values to a byte counting sink.
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+#include "eez-flow.h"
+
+using namespace eez;
+using namespace eez::flow;
+
+extern "C" void create_screens() {}
+native_var_t native_vars[] = { { NATIVE_VAR_TYPE_NONE, 0, 0 } };
+
+static uint64_t g_bytes;
+
+static void startToDebuggerMessage() {
+}
+
+static void writeDebuggerBuffer(const char *buffer, uint32_t length) {
+    (void)buffer;
+    g_bytes += length;
+}
+
+// must be the same as MESSAGE_FROM_DEBUGGER_PROTOCOL and DebuggerProtocol
+// in eez-flow.cpp
+static void setProtocol(int protocol) {
+    char message[16];
+    snprintf(message, sizeof(message), "8\t%d\n", protocol);
+    processDebuggerInput(message, strlen(message));
+}
+
+static void run(const char *protocolName, int protocol, const char *valueName, const Value &value, uint32_t iterations) {
+    setProtocol(protocol);
+
+    g_bytes = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        onValueChanged(&value);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    printf("%-8s %-14s %10.0f msg/s %8.1f MB/s %6.1f bytes/msg\n",
+        protocolName,
+        valueName,
+        iterations / seconds,
+        g_bytes / seconds / (1024 * 1024),
+        (double)g_bytes / iterations
+    );
+}
+
+int main(int argc, char **argv) {
+    uint32_t iterations = argc > 1 ? (uint32_t)atoi(argv[1]) : 1000000;
+
+    lv_init();
+
+    startToDebuggerMessageHook = startToDebuggerMessage;
+    writeDebuggerBufferHook = writeDebuggerBuffer;
+
+    onDebuggerClientConnected();
+
+    static const char LONG_STRING[] =
+        "The quick brown fox jumps over the lazy dog.\t"
+        "The quick brown fox jumps over the lazy dog.\n"
+        "The quick brown fox jumps over the lazy dog.";
+
+    struct {
+        const char *name;
+        Value value;
+    } values[] = {
+        { "boolean", Value(1, VALUE_TYPE_BOOLEAN) },
+        { "integer", Value(123456, VALUE_TYPE_INT32) },
+        { "double", Value(3.14159265358979, VALUE_TYPE_DOUBLE) },
+        { "short string", Value("Hello, world!", VALUE_TYPE_STRING) },
+        { "long string", Value(LONG_STRING, VALUE_TYPE_STRING) },
+    };
+
+    static const struct {
+        const char *name;
+        int protocol;
+    } protocols[] = {
+        { "text", 0 },
+        { "binary", 1 },
+    };
+
+    for (auto &value : values) {
+        for (auto &protocol : protocols) {
+            run(protocol.name, protocol.protocol, value.name, value.value, iterations);
+        }
+    }
+
+    onDebuggerClientDisconnected();
+
+    return 0;
+}
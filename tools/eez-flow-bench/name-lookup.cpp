@@ -0,0 +1,102 @@
+// Measures name to id lookups through eez::NameIndex, the hash index used by
+// getBitmapIdByName and the LVGL image, screen, object, group and style name
+// lookups, against the linear strcmp scan used before. Image names share a
+// long common prefix, as the names generated for LVGL images do.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+#include "eez-flow.h"
+
+using namespace eez;
+
+extern "C" void create_screens() {}
+native_var_t native_vars[] = { { NATIVE_VAR_TYPE_NONE, 0, 0 } };
+
+static const uint32_t NUM_LOOKUPS = 1000000;
+
+static int32_t linearFind(const ext_img_desc_t *images, uint32_t numImages, const char *name) {
+    for (uint32_t i = 0; i < numImages; i++) {
+        if (strcmp(images[i].name, name) == 0) {
+            return (int32_t)i;
+        }
+    }
+    return -1;
+}
+
+static bool run(uint32_t numImages) {
+    auto images = (ext_img_desc_t *)::malloc(numImages * sizeof(ext_img_desc_t));
+    auto names = (char (*)[32])::malloc(numImages * sizeof(char[32]));
+    for (uint32_t i = 0; i < numImages; i++) {
+        snprintf(names[i], sizeof(names[i]), "img_ui_button_%05u", (unsigned)i);
+        images[i].name = names[i];
+        images[i].img_dsc = nullptr;
+    }
+
+    // every 8th lookup is for a name which doesn't exist
+    static const uint32_t NUM_QUERIES = 4096;
+    char queries[NUM_QUERIES][32];
+    srand(1);
+    for (uint32_t i = 0; i < NUM_QUERIES; i++) {
+        snprintf(queries[i], sizeof(queries[i]), "img_ui_button_%05u", (unsigned)(rand() % numImages + (i % 8 == 0 ? numImages : 0)));
+    }
+
+    auto getName = [images](uint32_t i) {
+        return images[i].name;
+    };
+
+    NameIndex nameIndex;
+
+    // the index is built on the first lookup
+    auto start = std::chrono::steady_clock::now();
+    nameIndex.find(images, numImages, queries[0], getName);
+    auto end = std::chrono::steady_clock::now();
+    double buildTime = std::chrono::duration<double, std::micro>(end - start).count();
+
+    int64_t linearSum = 0;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < NUM_LOOKUPS; i++) {
+        linearSum += linearFind(images, numImages, queries[i % NUM_QUERIES]);
+    }
+    end = std::chrono::steady_clock::now();
+    double linearTime = std::chrono::duration<double, std::nano>(end - start).count() / NUM_LOOKUPS;
+
+    int64_t indexSum = 0;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < NUM_LOOKUPS; i++) {
+        indexSum += nameIndex.find(images, numImages, queries[i % NUM_QUERIES], getName);
+    }
+    end = std::chrono::steady_clock::now();
+    double indexTime = std::chrono::duration<double, std::nano>(end - start).count() / NUM_LOOKUPS;
+
+    printf("%6u names %10.1f ns %10.1f ns %10.1f us\n", (unsigned)numImages, linearTime, indexTime, buildTime);
+
+    nameIndex.reset();
+    ::free(names);
+    ::free(images);
+
+    if (indexSum != linearSum) {
+        fprintf(stderr, "%u names: the index found different names than the linear scan\n", (unsigned)numImages);
+        return false;
+    }
+
+    return true;
+}
+
+int main() {
+    lv_init();
+
+    printf("%u lookups, 1 in 8 for a missing name\n", (unsigned)NUM_LOOKUPS);
+    printf("%12s %13s %13s %13s\n", "", "linear scan", "NameIndex", "index build");
+
+    bool ok = true;
+
+    static const uint32_t numImages[] = { 4, 16, 100, 500, 2000 };
+    for (auto n : numImages) {
+        ok = run(n) && ok;
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,182 @@
+// Measures the update task bookkeeping of the LVGL runtime when a screen is
+// created and deleted while other screens stay alive: adding the tasks of
+// the widgets and removing them again when the widgets are deleted. The
+// dependency groups are updated incrementally, their full rebuild (done on
+// the next tick by earlier runtime versions) is measured for comparison.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+#include "eez-flow.h"
+
+// from wasm/lvgl-runtime/common/src/flow.h
+enum UpdateTaskType {
+    UPDATE_TASK_TYPE_CHECKED_STATE,
+    UPDATE_TASK_TYPE_DISABLED_STATE,
+    UPDATE_TASK_TYPE_HIDDEN_FLAG,
+    UPDATE_TASK_TYPE_CLICKABLE_FLAG,
+    UPDATE_TASK_TYPE_TICK_PROPERTY
+};
+
+#include "../../wasm/lvgl-runtime/common/src/update-tasks.h"
+
+static const int NUM_GLOBAL_VARIABLES = 50;
+static const int NUM_SCREENS = 20;
+static const int NUM_WIDGETS_PER_SCREEN = 100;
+
+// widgets are only used as keys, so no LVGL objects are created
+static char widgets[(NUM_SCREENS + 1) * NUM_WIDGETS_PER_SCREEN];
+
+static lv_obj_t *getWidget(int screenIndex, int widgetIndex) {
+    return (lv_obj_t *)&widgets[screenIndex * NUM_WIDGETS_PER_SCREEN + widgetIndex];
+}
+
+// one or two tasks per widget: 60% depend on global variables, 25% on
+// inputs or locals and 15% have unknown dependencies
+static void createScreen(int screenIndex) {
+    for (int widgetIndex = 0; widgetIndex < NUM_WIDGETS_PER_SCREEN; widgetIndex++) {
+        int numTasks = 1 + widgetIndex % 2;
+        for (int taskIndex = 0; taskIndex < numTasks; taskIndex++) {
+            UpdateTask updateTask = {};
+            updateTask.updateTaskType = taskIndex == 0 ? UPDATE_TASK_TYPE_HIDDEN_FLAG : UPDATE_TASK_TYPE_DISABLED_STATE;
+            updateTask.obj = getWidget(screenIndex, widgetIndex);
+            int kind = rand() % 100;
+            if (kind < 15) {
+                updateTask.polled = true;
+            } else {
+                updateTask.dependencies.flowValues = kind < 40;
+                if (kind >= 25) {
+                    updateTask.dependencies.numGlobalVariables = 1 + rand() % 2;
+                    updateTask.dependencies.globalVariables[0] = rand() % NUM_GLOBAL_VARIABLES;
+                    updateTask.dependencies.globalVariables[1] = (updateTask.dependencies.globalVariables[0] + 1) % NUM_GLOBAL_VARIABLES;
+                }
+            }
+            updateTask.dirty = true;
+            insertUpdateTask(updateTask);
+        }
+    }
+}
+
+static void deleteScreen(int screenIndex, bool reverseOrder) {
+    for (int i = 0; i < NUM_WIDGETS_PER_SCREEN; i++) {
+        int widgetIndex = reverseOrder ? NUM_WIDGETS_PER_SCREEN - 1 - i : i;
+        deleteObjectUpdateTasks(getWidget(screenIndex, widgetIndex));
+    }
+}
+
+static std::map<uint32_t, std::vector<size_t>> rebuiltGlobalVariableUpdateTasks;
+static std::vector<size_t> rebuiltFlowValuesUpdateTasks;
+static std::vector<size_t> rebuiltPolledUpdateTasks;
+
+// what earlier runtime versions did on the next tick after a change
+static void rebuildUpdateTaskGroups() {
+    rebuiltGlobalVariableUpdateTasks.clear();
+    rebuiltFlowValuesUpdateTasks.clear();
+    rebuiltPolledUpdateTasks.clear();
+
+    for (size_t i = 0; i < updateTasks.size(); i++) {
+        UpdateTask &updateTask = updateTasks[i];
+        if (updateTask.polled) {
+            rebuiltPolledUpdateTasks.push_back(i);
+            continue;
+        }
+        if (updateTask.dependencies.flowValues) {
+            rebuiltFlowValuesUpdateTasks.push_back(i);
+        }
+        for (uint32_t j = 0; j < updateTask.dependencies.numGlobalVariables; j++) {
+            rebuiltGlobalVariableUpdateTasks[updateTask.dependencies.globalVariables[j]].push_back(i);
+        }
+    }
+}
+
+static bool isSameGroup(std::vector<size_t> group, std::vector<size_t> rebuiltGroup) {
+    std::sort(group.begin(), group.end());
+    return group == rebuiltGroup;
+}
+
+static bool checkUpdateTaskGroups() {
+    rebuildUpdateTaskGroups();
+
+    if (!isSameGroup(polledUpdateTasks, rebuiltPolledUpdateTasks) || !isSameGroup(flowValuesUpdateTasks, rebuiltFlowValuesUpdateTasks)) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < NUM_GLOBAL_VARIABLES; i++) {
+        auto it = globalVariableUpdateTasks.find(i);
+        auto rebuiltIt = rebuiltGlobalVariableUpdateTasks.find(i);
+        std::vector<size_t> empty;
+        if (!isSameGroup(it != globalVariableUpdateTasks.end() ? it->second : empty, rebuiltIt != rebuiltGlobalVariableUpdateTasks.end() ? rebuiltIt->second : empty)) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < updateTasks.size(); i++) {
+        auto &taskIndexes = objectUpdateTasks[updateTasks[i].obj];
+        if (std::find(taskIndexes.begin(), taskIndexes.end(), i) == taskIndexes.end()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// returns us per create + delete of the churned screen
+static double churn(uint32_t iterations, bool reverseOrder) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        createScreen(NUM_SCREENS);
+        deleteScreen(NUM_SCREENS, reverseOrder);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+// returns us per rebuild of the groups
+static double rebuild(uint32_t iterations) {
+    createScreen(NUM_SCREENS);
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        rebuildUpdateTaskGroups();
+    }
+    auto end = std::chrono::steady_clock::now();
+    deleteScreen(NUM_SCREENS, true);
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+int main(int argc, char **argv) {
+    uint32_t iterations = argc > 1 ? (uint32_t)atoi(argv[1]) : 10000;
+
+    srand(1);
+
+    for (int screenIndex = 0; screenIndex < NUM_SCREENS; screenIndex++) {
+        createScreen(screenIndex);
+    }
+
+    // deleting a background screen moves tasks of the churned screen
+    createScreen(NUM_SCREENS);
+    deleteScreen(NUM_SCREENS / 2, false);
+    if (!checkUpdateTaskGroups()) {
+        fprintf(stderr, "update task groups are not consistent\n");
+        return 1;
+    }
+    deleteScreen(NUM_SCREENS, true);
+    createScreen(NUM_SCREENS / 2);
+    size_t numBackgroundTasks = updateTasks.size();
+
+    double reverseTime = churn(iterations, true);
+    double forwardTime = churn(iterations, false);
+    double rebuildTime = rebuild(iterations);
+
+    if (updateTasks.size() != numBackgroundTasks || !checkUpdateTaskGroups()) {
+        fprintf(stderr, "update task groups are not consistent\n");
+        return 1;
+    }
+
+    printf("%d screens with %d widgets, %d update tasks, %d iterations\n", NUM_SCREENS, NUM_WIDGETS_PER_SCREEN, (int)numBackgroundTasks, (int)iterations);
+    printf("%-40s %8.2f us\n", "create + delete screen, reverse order", reverseTime);
+    printf("%-40s %8.2f us\n", "create + delete screen, creation order", forwardTime);
+    printf("%-40s %8.2f us\n", "full rebuild of the groups", rebuildTime);
+
+    return 0;
+}
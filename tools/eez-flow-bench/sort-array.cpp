@@ -0,0 +1,352 @@
+// Measures the SortArray action on 100k rows: integer, double and string
+// arrays, a structure array sorted by a string field and then by an integer
+// field, and a field which mixes numeric strings, numbers and values that
+// can't be converted. The previous implementation (qsort with a comparator
+// which extracts and converts the keys on every comparison) is measured for
+// comparison. Every result is checked to be sorted, and rows with equal keys
+// to be in their original order.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+
+#include "eez-flow.h"
+
+using namespace eez;
+using namespace eez::flow;
+
+extern "C" void create_screens() {}
+native_var_t native_vars[] = { { NATIVE_VAR_TYPE_NONE, 0, 0 } };
+
+// structure type of the rows, only used as a tag
+static const int ROW_TYPE = 1000;
+
+static const uint32_t ROW_FIELD_KEY = 0;
+static const uint32_t ROW_FIELD_THEN_BY = 1;
+static const uint32_t ROW_FIELD_INDEX = 2;
+static const uint32_t ROW_NUM_FIELDS = 3;
+
+// SortArrayActionComponent as it is stored in the assets, with one
+// "Then by" entry
+struct SortArrayComponentAsset {
+    SortArrayActionComponent component;
+    int32_t thenByItems[1];
+    SortArrayThenBy thenBy[1];
+};
+
+static void initComponent(SortArrayComponentAsset &asset, int32_t arrayType, uint32_t flags, uint32_t thenByFlags) {
+    memset((void *)&asset, 0, sizeof(asset));
+
+    asset.component.arrayType = arrayType;
+    asset.component.structFieldIndex = ROW_FIELD_KEY;
+    asset.component.flags = flags;
+
+    if (flags & SORT_ARRAY_FLAG_THEN_BY) {
+        asset.thenBy[0].structFieldIndex = ROW_FIELD_THEN_BY;
+        asset.thenBy[0].flags = thenByFlags;
+
+        // ListOfAssetsPtr is a count followed by an offset relative to itself
+        auto thenByList = (int32_t *)&asset.component.thenBy;
+        asset.component.thenBy.count = 1;
+        thenByList[1] = (int32_t)((uint8_t *)asset.thenByItems - (uint8_t *)&thenByList[1]);
+        asset.thenByItems[0] = (int32_t)((uint8_t *)asset.thenBy - (uint8_t *)asset.thenByItems);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// previous implementation, from eez-framework before the keys were extracted
+static SortArrayActionComponent *g_previousComponent;
+
+static int previousElementCompare(const void *a, const void *b) {
+    auto aValue = *(const Value *)a;
+    auto bValue = *(const Value *)b;
+    if (g_previousComponent->arrayType != -1) {
+        if (!aValue.isArray()) {
+            return 0;
+        }
+        auto aArray = aValue.getArray();
+        if ((uint32_t)g_previousComponent->structFieldIndex >= aArray->arraySize) {
+            return 0;
+        }
+        aValue = aArray->values[g_previousComponent->structFieldIndex];
+        if (!bValue.isArray()) {
+            return 0;
+        }
+        auto bArray = bValue.getArray();
+        if ((uint32_t)g_previousComponent->structFieldIndex >= bArray->arraySize) {
+            return 0;
+        }
+        bValue = bArray->values[g_previousComponent->structFieldIndex];
+    }
+    int result;
+    if (aValue.isString() && bValue.isString()) {
+        if (g_previousComponent->flags & SORT_ARRAY_FLAG_IGNORE_CASE) {
+            result = utf8casecmp(aValue.getString(), bValue.getString());
+        } else {
+            result = utf8cmp(aValue.getString(), bValue.getString());
+        }
+    } else {
+        int err;
+        float aDouble = aValue.toDouble(&err);
+        if (err) {
+            return 0;
+        }
+        float bDouble = bValue.toDouble(&err);
+        if (err) {
+            return 0;
+        }
+        auto diff = aDouble - bDouble;
+        result = diff < 0 ? -1 : diff > 0 ? 1 : 0;
+    }
+    if (!(g_previousComponent->flags & SORT_ARRAY_FLAG_ASCENDING)) {
+        result = -result;
+    }
+    return result;
+}
+
+static bool previousSortArray(SortArrayActionComponent *component, ArrayValue *array) {
+    g_previousComponent = component;
+    qsort(&array->values[0], array->arraySize, sizeof(Value), previousElementCompare);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t g_random = 1;
+
+static uint32_t nextRandom(uint32_t n) {
+    g_random = g_random * 1103515245 + 12345;
+    return (g_random >> 8) % n;
+}
+
+static Value makeWord(uint32_t maxLength) {
+    char word[32];
+    uint32_t length = 1 + nextRandom(maxLength);
+    for (uint32_t i = 0; i < length; i++) {
+        word[i] = (nextRandom(2) ? 'a' : 'A') + nextRandom(26);
+    }
+    word[length] = 0;
+    return Value::makeStringRef(word, length, 0);
+}
+
+static Value makeIntegerArray(uint32_t numRows) {
+    auto arrayValue = Value::makeArrayRef(numRows, defs_v3::ARRAY_TYPE_INTEGER, 0);
+    for (uint32_t i = 0; i < numRows; i++) {
+        arrayValue.getArray()->values[i] = Value((int)nextRandom(1000000), VALUE_TYPE_INT32);
+    }
+    return arrayValue;
+}
+
+static Value makeDoubleArray(uint32_t numRows) {
+    auto arrayValue = Value::makeArrayRef(numRows, defs_v3::ARRAY_TYPE_DOUBLE, 0);
+    for (uint32_t i = 0; i < numRows; i++) {
+        arrayValue.getArray()->values[i] = Value(nextRandom(1000000) / 7.0, VALUE_TYPE_DOUBLE);
+    }
+    return arrayValue;
+}
+
+static Value makeStringArray(uint32_t numRows) {
+    auto arrayValue = Value::makeArrayRef(numRows, defs_v3::ARRAY_TYPE_STRING, 0);
+    for (uint32_t i = 0; i < numRows; i++) {
+        arrayValue.getArray()->values[i] = makeWord(16);
+    }
+    return arrayValue;
+}
+
+static Value makeRow(const Value &key, const Value &thenBy, uint32_t index) {
+    auto rowValue = Value::makeArrayRef(ROW_NUM_FIELDS, ROW_TYPE, 0);
+    auto row = rowValue.getArray();
+    row->values[ROW_FIELD_KEY] = key;
+    row->values[ROW_FIELD_THEN_BY] = thenBy;
+    row->values[ROW_FIELD_INDEX] = Value((int)index, VALUE_TYPE_INT32);
+    return rowValue;
+}
+
+// few distinct keys, so most rows are ordered by the "Then by" field and
+// many have equal keys on both levels
+static Value makeStructArray(uint32_t numRows) {
+    auto arrayValue = Value::makeArrayRef(numRows, ROW_TYPE, 0);
+    for (uint32_t i = 0; i < numRows; i++) {
+        char group[16];
+        snprintf(group, sizeof(group), "Group %u", (unsigned)nextRandom(100));
+        arrayValue.getArray()->values[i] = makeRow(Value::makeStringRef(group, -1, 0), Value((int)nextRandom(100), VALUE_TYPE_INT32), i);
+    }
+    return arrayValue;
+}
+
+// numeric strings, numbers and strings which are not numbers in one field,
+// e.g. "10", 9.5 and "9" which compare differently as strings
+static Value makeMixedArray(uint32_t numRows) {
+    auto arrayValue = Value::makeArrayRef(numRows, ROW_TYPE, 0);
+    for (uint32_t i = 0; i < numRows; i++) {
+        Value key;
+        switch (nextRandom(4)) {
+        case 0: {
+            char str[16];
+            snprintf(str, sizeof(str), "%u", (unsigned)nextRandom(1000));
+            key = Value::makeStringRef(str, -1, 0);
+            break;
+        }
+        case 1:
+            key = Value((int)nextRandom(1000), VALUE_TYPE_INT32);
+            break;
+        case 2:
+            key = Value(nextRandom(10000) / 10.0, VALUE_TYPE_DOUBLE);
+            break;
+        default:
+            key = makeWord(4);
+            break;
+        }
+        arrayValue.getArray()->values[i] = makeRow(key, Value(), i);
+    }
+    return arrayValue;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static const Value &getField(const Value &value, uint32_t fieldIndex) {
+    return value.getArray()->values[fieldIndex];
+}
+
+// -1 when the key can't be converted to a number
+static int getNumber(const Value &value, double &num) {
+    int err;
+    num = value.toDouble(&err);
+    return err || isnan(num) ? -1 : 0;
+}
+
+static int compareNumbers(const Value &a, const Value &b) {
+    double aNum, bNum;
+    bool aValid = getNumber(a, aNum) == 0;
+    bool bValid = getNumber(b, bNum) == 0;
+    if (!aValid || !bValid) {
+        return aValid == bValid ? 0 : aValid ? -1 : 1;
+    }
+    return aNum < bNum ? -1 : aNum > bNum ? 1 : 0;
+}
+
+static int compareRows(const SortArrayComponentAsset &asset, const Value &a, const Value &b, bool numeric) {
+    int result;
+    if (asset.component.arrayType == -1) {
+        if (numeric) {
+            result = compareNumbers(a, b);
+        } else {
+            result = (asset.component.flags & SORT_ARRAY_FLAG_IGNORE_CASE) ? utf8casecmp(a.getString(), b.getString()) : utf8cmp(a.getString(), b.getString());
+        }
+        return (asset.component.flags & SORT_ARRAY_FLAG_ASCENDING) ? result : -result;
+    }
+
+    const Value &aKey = getField(a, ROW_FIELD_KEY);
+    const Value &bKey = getField(b, ROW_FIELD_KEY);
+    if (numeric) {
+        double num;
+        if (getNumber(aKey, num) != 0 || getNumber(bKey, num) != 0) {
+            // invalid keys are last in both directions
+            return compareNumbers(aKey, bKey);
+        }
+        result = compareNumbers(aKey, bKey);
+    } else {
+        result = utf8cmp(aKey.getString(), bKey.getString());
+    }
+    if (!(asset.component.flags & SORT_ARRAY_FLAG_ASCENDING)) {
+        result = -result;
+    }
+    if (result == 0 && (asset.component.flags & SORT_ARRAY_FLAG_THEN_BY)) {
+        result = compareNumbers(getField(a, ROW_FIELD_THEN_BY), getField(b, ROW_FIELD_THEN_BY));
+        if (!(asset.thenBy[0].flags & SORT_ARRAY_FLAG_ASCENDING)) {
+            result = -result;
+        }
+    }
+    return result;
+}
+
+static bool checkSorted(const SortArrayComponentAsset &asset, ArrayValue *array, bool numeric) {
+    for (uint32_t i = 1; i < array->arraySize; i++) {
+        int result = compareRows(asset, array->values[i - 1], array->values[i], numeric);
+        if (result > 0) {
+            return false;
+        }
+        if (result == 0 && asset.component.arrayType != -1) {
+            if (getField(array->values[i - 1], ROW_FIELD_INDEX).getInt() > getField(array->values[i], ROW_FIELD_INDEX).getInt()) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+typedef bool (*SortArrayFunction)(SortArrayActionComponent *component, ArrayValue *array);
+
+// returns ms per sort, or -1 if the result is not sorted
+static double measure(SortArrayFunction sort, SortArrayComponentAsset &asset, Value &source, bool numeric, uint32_t iterations) {
+    double ms = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        auto arrayValue = source.clone();
+
+        auto start = std::chrono::steady_clock::now();
+        bool result = sort(&asset.component, arrayValue.getArray());
+        auto end = std::chrono::steady_clock::now();
+
+        if (!result || (sort == sortArray && !checkSorted(asset, arrayValue.getArray(), numeric))) {
+            return -1;
+        }
+
+        ms += std::chrono::duration<double, std::milli>(end - start).count();
+    }
+    return ms / iterations;
+}
+
+static bool run(const char *name, Value source, int32_t arrayType, uint32_t flags, uint32_t thenByFlags, bool numeric, bool measurePrevious, uint32_t iterations) {
+    SortArrayComponentAsset asset;
+    initComponent(asset, arrayType, flags, thenByFlags);
+
+    double ms = measure(sortArray, asset, source, numeric, iterations);
+    if (ms < 0) {
+        fprintf(stderr, "%s: not sorted\n", name);
+        return false;
+    }
+
+    if (measurePrevious) {
+        SortArrayComponentAsset previousAsset;
+        initComponent(previousAsset, arrayType, flags & ~SORT_ARRAY_FLAG_THEN_BY, 0);
+        double previousMs = measure(previousSortArray, previousAsset, source, numeric, iterations);
+        printf("%-34s %9.2f ms %9.2f ms\n", name, ms, previousMs);
+    } else {
+        printf("%-34s %9.2f ms %12s\n", name, ms, "-");
+    }
+
+    return true;
+}
+
+int main(int argc, char **argv) {
+    uint32_t numRows = argc > 1 ? (uint32_t)atoi(argv[1]) : 100000;
+    uint32_t iterations = argc > 2 ? (uint32_t)atoi(argv[2]) : 5;
+
+    lv_init();
+
+    // LV_MEM_SIZE from lv_conf.h is too small for two copies of 100k rows
+    static const size_t POOL_SIZE = 128 * 1024 * 1024;
+    lv_mem_add_pool(::malloc(POOL_SIZE), POOL_SIZE);
+
+    printf("%u rows, %u iterations\n", (unsigned)numRows, (unsigned)iterations);
+    printf("%-34s %12s %12s\n", "", "sortArray", "previous");
+
+    bool ok = true;
+
+    ok = run("integer, ascending", makeIntegerArray(numRows), -1, SORT_ARRAY_FLAG_ASCENDING, 0, true, true, iterations) && ok;
+    ok = run("double, descending", makeDoubleArray(numRows), -1, 0, 0, true, true, iterations) && ok;
+    ok = run("string, ignore case", makeStringArray(numRows), -1, SORT_ARRAY_FLAG_ASCENDING | SORT_ARRAY_FLAG_IGNORE_CASE, 0, false, true, iterations) && ok;
+    ok = run("struct, string key", makeStructArray(numRows), ROW_TYPE, SORT_ARRAY_FLAG_ASCENDING, 0, false, true, iterations) && ok;
+    ok = run("struct, string key, then by int", makeStructArray(numRows), ROW_TYPE, SORT_ARRAY_FLAG_ASCENDING | SORT_ARRAY_FLAG_THEN_BY, 0, false, false, iterations) && ok;
+
+    // the previous implementation doesn't give a consistent order here
+    ok = run("struct, mixed key", makeMixedArray(numRows), ROW_TYPE, SORT_ARRAY_FLAG_ASCENDING, 0, true, false, iterations) && ok;
+    ok = run("struct, mixed key, descending", makeMixedArray(numRows), ROW_TYPE, 0, 0, true, false, iterations) && ok;
+
+    return ok ? 0 : 1;
+}
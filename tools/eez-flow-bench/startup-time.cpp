@@ -0,0 +1,144 @@
+// Measures how long it takes to get the main assets ready at startup: reading
+// the whole file and calling loadMainAssets versus mapping it with
+// loadMainAssetsFromFile, and the cost of the first access to the flow
+// definition and the translations (decompressed on demand for chunked
+// assets).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+#include "eez-flow.h"
+
+using namespace eez;
+
+extern "C" void create_screens() {}
+native_var_t native_vars[] = { { NATIVE_VAR_TYPE_NONE, 0, 0 } };
+
+// keeps the reads in touchAllAssets from being optimized away
+static volatile uint32_t g_checksum;
+
+static uint8_t *readFile(const char *filePath, uint32_t &size) {
+    FILE *fp = fopen(filePath, "rb");
+    if (!fp) {
+        return nullptr;
+    }
+    fseek(fp, 0, SEEK_END);
+    size = (uint32_t)ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    auto data = (uint8_t *)::malloc(size);
+    if (data && fread(data, 1, size, fp) != size) {
+        ::free(data);
+        data = nullptr;
+    }
+    fclose(fp);
+    return data;
+}
+
+// Reads everything the LVGL runtime reads from the assets: the flow
+// definition and the translations of every language (decompressed on first
+// use for chunked assets). For mapped assets this also faults in the pages.
+static double touchAllAssets() {
+    auto start = std::chrono::steady_clock::now();
+    uint32_t checksum = 0;
+    auto flowDefinition = static_cast<FlowDefinition *>(g_mainAssets->flowDefinition);
+    if (flowDefinition) {
+        for (uint32_t i = 0; i < flowDefinition->flows.count; i++) {
+            auto flow = flowDefinition->flows[i];
+            for (uint32_t j = 0; j < flow->components.count; j++) {
+                auto component = flow->components[j];
+                checksum += component->type;
+                for (uint32_t k = 0; k < component->properties.count; k++) {
+                    checksum += component->properties[k]->evalInstructions[0];
+                }
+            }
+        }
+        for (uint32_t i = 0; i < flowDefinition->constants.count; i++) {
+            checksum += flowDefinition->constants[i]->type;
+        }
+        for (uint32_t i = 0; i < flowDefinition->globalVariables.count; i++) {
+            checksum += flowDefinition->globalVariables[i]->type;
+        }
+    }
+    for (uint32_t i = 0; i < g_mainAssets->languages.count; i++) {
+        loadLazyLanguage(g_mainAssets, i);
+        auto language = g_mainAssets->languages[i];
+        for (uint32_t j = 0; j < language->translations.count; j++) {
+            checksum += (uint8_t)language->translations[j][0];
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    g_checksum += checksum;
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static const char *getAssetsFormat(const char *filePath) {
+    uint32_t size;
+    auto data = readFile(filePath, size);
+    if (!data || size < sizeof(Header)) {
+        ::free(data);
+        return nullptr;
+    }
+    auto tag = ((Header *)data)->tag;
+    ::free(data);
+    return tag == HEADER_TAG ? "uncompressed" : tag == HEADER_TAG_ALIGNED ? "uncompressed, aligned" : tag == HEADER_TAG_COMPRESSED ? "compressed" : tag == HEADER_TAG_CHUNKED ? "chunked" : nullptr;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <assets file> [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    const char *filePath = argv[1];
+    uint32_t iterations = argc > 2 ? (uint32_t)atoi(argv[2]) : 100;
+
+    lv_init();
+
+    auto format = getAssetsFormat(filePath);
+    if (!format) {
+        fprintf(stderr, "%s is not an assets file\n", filePath);
+        return 1;
+    }
+
+    double readAndLoadTime = 0;
+    double readAndLoadTouchTime = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        auto start = std::chrono::steady_clock::now();
+        uint32_t size;
+        auto data = readFile(filePath, size);
+        loadMainAssets(data, size);
+        auto end = std::chrono::steady_clock::now();
+        if (!g_isMainAssetsLoaded) {
+            ::free(data);
+            fprintf(stderr, "loadMainAssets failed\n");
+            return 1;
+        }
+        readAndLoadTime += std::chrono::duration<double, std::milli>(end - start).count();
+        readAndLoadTouchTime += touchAllAssets();
+        unloadMainAssets();
+        ::free(data);
+    }
+
+    double mmapLoadTime = 0;
+    double mmapLoadTouchTime = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        auto start = std::chrono::steady_clock::now();
+        int err;
+        bool loaded = loadMainAssetsFromFile(filePath, &err);
+        auto end = std::chrono::steady_clock::now();
+        if (!loaded) {
+            fprintf(stderr, "loadMainAssetsFromFile failed: %d\n", err);
+            return 1;
+        }
+        mmapLoadTime += std::chrono::duration<double, std::milli>(end - start).count();
+        mmapLoadTouchTime += touchAllAssets();
+        unloadMainAssets();
+    }
+
+    printf("%s assets, %d iterations\n", format, (int)iterations);
+    printf("%-24s %8.3f ms load %8.3f ms first access\n", "read + loadMainAssets", readAndLoadTime / iterations, readAndLoadTouchTime / iterations);
+    printf("%-24s %8.3f ms load %8.3f ms first access\n", "loadMainAssetsFromFile", mmapLoadTime / iterations, mmapLoadTouchTime / iterations);
+
+    return 0;
+}
@@ -50,6 +50,12 @@ const EEZ_FRAMEWORK_PATH = path.resolve("../../../wasm//eez-framework");
 
 const BASE_PATH = path.resolve(EEZ_FRAMEWORK_PATH + "/src/eez");
 
+// Changes of the amalgamated eez-flow.cpp and eez-flow.h which are not in
+// the eez-framework submodule yet, applied in file name order.
+const PATCHES_DIR = path.resolve("../patches");
+
+const STUDIO_PATH = path.resolve("../../..");
+
 const CONFIG = {
     ignore: [
         "fs",
@@ -546,6 +552,36 @@ extern "C" {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+async function applyPatches(outDir: string) {
+    const patchFiles = (await fs.promises.readdir(PATCHES_DIR))
+        .filter(fileName => fileName.endsWith(".patch"))
+        .sort();
+
+    // patches are made with git diff from the studio root directory,
+    // i.e. a/resources/eez-framework-amalgamation/eez-flow.cpp
+    const directory = path
+        .relative(STUDIO_PATH, path.resolve(outDir))
+        .replace(/\\/g, "/");
+
+    for (const patchFile of patchFiles) {
+        await new Promise<void>((resolve, reject) => {
+            exec(
+                `git apply -p3 --whitespace=nowarn --directory="${directory}" "${PATCHES_DIR}/${patchFile}"`,
+                { cwd: STUDIO_PATH },
+                function (error, stdout, stderr) {
+                    if (error) {
+                        reject(`failed to apply ${patchFile}: ${stderr}`);
+                    } else {
+                        resolve();
+                    }
+                }
+            );
+        });
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 walk(BASE_PATH, async (err, results) => {
     if (err) {
         console.error(err);
@@ -709,4 +745,11 @@ walk(BASE_PATH, async (err, results) => {
         BASE_PATH + "/libs/sha256/sha256.h",
         OUT_DIR + "/eez-flow-sha256.h"
     );
+
+    try {
+        await applyPatches(OUT_DIR);
+    } catch (err) {
+        console.error(err);
+        process.exit(-3);
+    }
 });
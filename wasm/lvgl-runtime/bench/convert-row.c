@@ -0,0 +1,156 @@
+// Measures convert_row (LVGL draw buffer -> canvas RGBA) the same way
+// my_driver_flush uses it, for full screen and partial flushes, and compares
+// it with a plain per pixel conversion which is also used to check results.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef LV_COLOR_DEPTH
+#define LV_COLOR_DEPTH 32
+#endif
+
+#ifndef LVGL_VERSION_MAJOR
+#define LVGL_VERSION_MAJOR 9
+#endif
+
+#ifndef LV_COLOR_16_SWAP
+#define LV_COLOR_16_SWAP 0
+#endif
+
+#include "convert-row.h"
+
+#define HOR_RES 800
+#define VER_RES 480
+
+// number of pixels converted per measurement
+#define PIXELS_PER_RUN (200 * 1000 * 1000)
+
+typedef void (*convert_row_t)(uint8_t *dst, const uint8_t *src, int32_t width);
+
+static void convert_row_reference(uint8_t *dst, const uint8_t *src, int32_t width) {
+    for (int32_t x = 0; x < width; x++) {
+#if LV_COLOR_DEPTH == 32
+        dst[4 * x + 0] = src[4 * x + 2];
+        dst[4 * x + 1] = src[4 * x + 1];
+        dst[4 * x + 2] = src[4 * x + 0];
+        dst[4 * x + 3] = src[4 * x + 3];
+#else
+#if RGB565_SWAPPED
+        uint16_t c = (src[2 * x] << 8) | src[2 * x + 1];
+#else
+        uint16_t c = src[2 * x] | (src[2 * x + 1] << 8);
+#endif
+        uint8_t r = c >> 11;
+        uint8_t g = (c >> 5) & 0x3F;
+        uint8_t b = c & 0x1F;
+        dst[4 * x + 0] = (r << 3) | (r >> 2);
+        dst[4 * x + 1] = (g << 2) | (g >> 4);
+        dst[4 * x + 2] = (b << 3) | (b >> 2);
+        dst[4 * x + 3] = 0xFF;
+#endif
+    }
+}
+
+static uint8_t draw_buffer[PIXEL_SIZE * HOR_RES * VER_RES];
+static uint8_t display_fb[4 * HOR_RES * VER_RES];
+static uint8_t display_fb_reference[4 * HOR_RES * VER_RES];
+
+static double now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+// same loop as in my_driver_flush
+static void flush(convert_row_t convert, uint8_t *fb, int32_t x1, int32_t y1, int32_t width, int32_t height) {
+    const uint8_t *src = draw_buffer;
+    int32_t src_stride = PIXEL_SIZE * width;
+    uint8_t *dst = fb + 4 * (y1 * HOR_RES + x1);
+    for (int32_t y = 0; y < height; y++) {
+        convert(dst, src, width);
+        src += src_stride;
+        dst += 4 * HOR_RES;
+    }
+}
+
+// flushes of width x height areas moved over the screen, returns ms per flush
+static double run(convert_row_t convert, uint8_t *fb, int32_t width, int32_t height, uint32_t iterations) {
+    int32_t x1 = 0;
+    int32_t y1 = 0;
+
+    double start = now_ms();
+    for (uint32_t i = 0; i < iterations; i++) {
+        flush(convert, fb, x1, y1, width, height);
+
+        x1 += width;
+        if (x1 + width > HOR_RES) {
+            x1 = 0;
+            y1 += height;
+            if (y1 + height > VER_RES) {
+                y1 = 0;
+            }
+        }
+    }
+    return (now_ms() - start) / iterations;
+}
+
+static int bench(const char *name, int32_t width, int32_t height) {
+    uint32_t iterations = PIXELS_PER_RUN / (width * height);
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    double time = run(convert_row, display_fb, width, height, iterations);
+    double referenceTime = run(convert_row_reference, display_fb_reference, width, height, iterations);
+
+    if (memcmp(display_fb, display_fb_reference, sizeof(display_fb)) != 0) {
+        printf("%s: convert_row result differs from the reference\n", name);
+        return 0;
+    }
+
+    double mpixels = width * height / 1000.0;
+    printf("%-26s %4dx%-4d %9.1f us/flush %8.1f Mpx/s %8.1f Mpx/s reference %5.2fx\n",
+        name, (int)width, (int)height,
+        time * 1000,
+        mpixels / time,
+        mpixels / referenceTime,
+        referenceTime / time
+    );
+
+    return 1;
+}
+
+int main() {
+    srand(1);
+    for (size_t i = 0; i < sizeof(draw_buffer); i++) {
+        draw_buffer[i] = (uint8_t)rand();
+    }
+
+#if defined(__wasm_simd128__)
+    const char *simd = "wasm simd128";
+#elif defined(__SSSE3__)
+    const char *simd = "SSSE3";
+#elif defined(__ARM_NEON)
+    const char *simd = "NEON";
+#else
+    const char *simd = "none";
+#endif
+    printf("LV_COLOR_DEPTH %d, SIMD: %s, display %dx%d\n", LV_COLOR_DEPTH, simd, HOR_RES, VER_RES);
+
+    int ok = 1;
+
+    // DRAW_BUFFER_DIVISOR 0, one flush per frame
+    ok &= bench("full screen", HOR_RES, VER_RES);
+
+    // DRAW_BUFFER_DIVISOR 10, full screen redraw is flushed in strips
+    ok &= bench("full screen in 1/10 strips", HOR_RES, VER_RES / 10);
+
+    // typical partial redraws: a button, a label, a cursor
+    ok &= bench("partial, button", 120, 50);
+    ok &= bench("partial, label", 64, 16);
+    ok &= bench("partial, cursor", 3, 20);
+
+    return ok ? 0 : 1;
+}
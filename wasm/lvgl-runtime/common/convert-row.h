@@ -0,0 +1,139 @@
+#pragma once
+
+// LVGL pixels -> canvas RGBA, vectorised when the target has SIMD.
+// Expects LV_COLOR_DEPTH (and for 16 bit LVGL_VERSION_MAJOR and
+// LV_COLOR_16_SWAP) to be defined, shared by main.c and bench/convert-row.c
+
+#include <stdint.h>
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#if LV_COLOR_DEPTH == 32
+
+#define PIXEL_SIZE 4
+
+// B, G, R, A -> R, G, B, A
+static void convert_row(uint8_t *dst, const uint8_t *src, int32_t width) {
+    int32_t x = 0;
+
+#if defined(__wasm_simd128__)
+    for (; x + 4 <= width; x += 4) {
+        v128_t v = wasm_v128_load(src + 4 * x);
+        v = wasm_i8x16_shuffle(v, v, 2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+        wasm_v128_store(dst + 4 * x, v);
+    }
+#elif defined(__SSSE3__)
+    const __m128i mask = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    for (; x + 4 <= width; x += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + 4 * x));
+        _mm_storeu_si128((__m128i *)(dst + 4 * x), _mm_shuffle_epi8(v, mask));
+    }
+#elif defined(__ARM_NEON)
+    for (; x + 16 <= width; x += 16) {
+        uint8x16x4_t v = vld4q_u8(src + 4 * x);
+        uint8x16_t b = v.val[0];
+        v.val[0] = v.val[2];
+        v.val[2] = b;
+        vst4q_u8(dst + 4 * x, v);
+    }
+#endif
+
+    for (; x < width; x++) {
+        dst[4 * x + 0] = src[4 * x + 2];
+        dst[4 * x + 1] = src[4 * x + 1];
+        dst[4 * x + 2] = src[4 * x + 0];
+        dst[4 * x + 3] = src[4 * x + 3];
+    }
+}
+
+#elif LV_COLOR_DEPTH == 16
+
+#define PIXEL_SIZE 2
+
+#if LVGL_VERSION_MAJOR < 9 && LV_COLOR_16_SWAP
+#define RGB565_SWAPPED 1
+#else
+#define RGB565_SWAPPED 0
+#endif
+
+// RGB565 -> R, G, B, 0xFF
+static void convert_row(uint8_t *dst, const uint8_t *src, int32_t width) {
+    int32_t x = 0;
+
+#if defined(__wasm_simd128__)
+    for (; x + 8 <= width; x += 8) {
+        v128_t v = wasm_v128_load(src + 2 * x);
+#if RGB565_SWAPPED
+        v = wasm_i8x16_shuffle(v, v, 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+#endif
+        v128_t r = wasm_u16x8_shr(v, 11);
+        v128_t g = wasm_v128_and(wasm_u16x8_shr(v, 5), wasm_i16x8_splat(0x3F));
+        v128_t b = wasm_v128_and(v, wasm_i16x8_splat(0x1F));
+        r = wasm_v128_or(wasm_i16x8_shl(r, 3), wasm_u16x8_shr(r, 2));
+        g = wasm_v128_or(wasm_i16x8_shl(g, 2), wasm_u16x8_shr(g, 4));
+        b = wasm_v128_or(wasm_i16x8_shl(b, 3), wasm_u16x8_shr(b, 2));
+        v128_t rg = wasm_v128_or(r, wasm_i16x8_shl(g, 8));
+        v128_t ba = wasm_v128_or(b, wasm_i16x8_splat((int16_t)0xFF00));
+        wasm_v128_store(dst + 4 * x, wasm_i16x8_shuffle(rg, ba, 0, 8, 1, 9, 2, 10, 3, 11));
+        wasm_v128_store(dst + 4 * x + 16, wasm_i16x8_shuffle(rg, ba, 4, 12, 5, 13, 6, 14, 7, 15));
+    }
+#elif defined(__SSSE3__)
+    for (; x + 8 <= width; x += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + 2 * x));
+#if RGB565_SWAPPED
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+#endif
+        __m128i r = _mm_srli_epi16(v, 11);
+        __m128i g = _mm_and_si128(_mm_srli_epi16(v, 5), _mm_set1_epi16(0x3F));
+        __m128i b = _mm_and_si128(v, _mm_set1_epi16(0x1F));
+        r = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
+        g = _mm_or_si128(_mm_slli_epi16(g, 2), _mm_srli_epi16(g, 4));
+        b = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+        __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+        __m128i ba = _mm_or_si128(b, _mm_set1_epi16((short)0xFF00));
+        _mm_storeu_si128((__m128i *)(dst + 4 * x), _mm_unpacklo_epi16(rg, ba));
+        _mm_storeu_si128((__m128i *)(dst + 4 * x + 16), _mm_unpackhi_epi16(rg, ba));
+    }
+#elif defined(__ARM_NEON)
+    for (; x + 8 <= width; x += 8) {
+        uint16x8_t v = vld1q_u16((const uint16_t *)(src + 2 * x));
+#if RGB565_SWAPPED
+        v = vreinterpretq_u16_u8(vrev16q_u8(vreinterpretq_u8_u16(v)));
+#endif
+        uint16x8_t r = vshrq_n_u16(v, 11);
+        uint16x8_t g = vandq_u16(vshrq_n_u16(v, 5), vdupq_n_u16(0x3F));
+        uint16x8_t b = vandq_u16(v, vdupq_n_u16(0x1F));
+        r = vorrq_u16(vshlq_n_u16(r, 3), vshrq_n_u16(r, 2));
+        g = vorrq_u16(vshlq_n_u16(g, 2), vshrq_n_u16(g, 4));
+        b = vorrq_u16(vshlq_n_u16(b, 3), vshrq_n_u16(b, 2));
+        uint16x8x2_t rgba = vzipq_u16(vorrq_u16(r, vshlq_n_u16(g, 8)), vorrq_u16(b, vdupq_n_u16(0xFF00)));
+        vst1q_u16((uint16_t *)(dst + 4 * x), rgba.val[0]);
+        vst1q_u16((uint16_t *)(dst + 4 * x + 16), rgba.val[1]);
+    }
+#endif
+
+    for (; x < width; x++) {
+#if RGB565_SWAPPED
+        uint16_t c = (src[2 * x] << 8) | src[2 * x + 1];
+#else
+        uint16_t c = src[2 * x] | (src[2 * x + 1] << 8);
+#endif
+        uint8_t r = c >> 11;
+        uint8_t g = (c >> 5) & 0x3F;
+        uint8_t b = c & 0x1F;
+        dst[4 * x + 0] = (r << 3) | (r >> 2);
+        dst[4 * x + 1] = (g << 2) | (g >> 4);
+        dst[4 * x + 2] = (b << 3) | (b >> 2);
+        dst[4 * x + 3] = 0xFF;
+    }
+}
+
+#else
+#error "LVGL runtime supports only 16 and 32 bit color depth"
+#endif
@@ -8,6 +8,7 @@
 #include "lvgl/lvgl.h"
 
 #include "src/flow.h"
+#include "convert-row.h"
 
 #define EM_PORT_API(rettype) rettype EMSCRIPTEN_KEEPALIVE
 
@@ -21,6 +22,101 @@ int ver_res;
 uint32_t *display_fb;
 bool display_fb_dirty;
 
+// areas flushed since the last getSyncedBuffer() call
+#define MAX_DIRTY_RECTS 16
+
+typedef struct {
+    int32_t x1;
+    int32_t y1;
+    int32_t x2;
+    int32_t y2;
+} dirty_rect_t;
+
+static dirty_rect_t dirty_rects[MAX_DIRTY_RECTS];
+static int num_dirty_rects;
+
+static int32_t synced_dirty_rects[4 * MAX_DIRTY_RECTS];
+static int num_synced_dirty_rects;
+
+static int32_t dirty_rect_area(const dirty_rect_t *r) {
+    return (r->x2 - r->x1 + 1) * (r->y2 - r->y1 + 1);
+}
+
+static void dirty_rect_union(dirty_rect_t *result, const dirty_rect_t *a, const dirty_rect_t *b) {
+    result->x1 = a->x1 < b->x1 ? a->x1 : b->x1;
+    result->y1 = a->y1 < b->y1 ? a->y1 : b->y1;
+    result->x2 = a->x2 > b->x2 ? a->x2 : b->x2;
+    result->y2 = a->y2 > b->y2 ? a->y2 : b->y2;
+}
+
+static void add_dirty_rect(int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+    dirty_rect_t rect = { x1, y1, x2, y2 };
+
+    // merge with rectangles whose bounding box doesn't cover more pixels than both of them
+    bool merged;
+    do {
+        merged = false;
+        for (int i = 0; i < num_dirty_rects; i++) {
+            dirty_rect_t u;
+            dirty_rect_union(&u, &rect, &dirty_rects[i]);
+            if (dirty_rect_area(&u) <= dirty_rect_area(&rect) + dirty_rect_area(&dirty_rects[i])) {
+                rect = u;
+                dirty_rects[i] = dirty_rects[--num_dirty_rects];
+                merged = true;
+                break;
+            }
+        }
+    } while (merged);
+
+    if (num_dirty_rects == MAX_DIRTY_RECTS) {
+        // list is full, grow the rectangle that needs the fewest extra pixels
+        int best = 0;
+        int32_t best_growth = INT32_MAX;
+        for (int i = 0; i < num_dirty_rects; i++) {
+            dirty_rect_t u;
+            dirty_rect_union(&u, &rect, &dirty_rects[i]);
+            int32_t growth = dirty_rect_area(&u) - dirty_rect_area(&dirty_rects[i]);
+            if (growth < best_growth) {
+                best = i;
+                best_growth = growth;
+            }
+        }
+        dirty_rect_t u;
+        dirty_rect_union(&u, &rect, &dirty_rects[best]);
+        dirty_rects[best] = dirty_rects[--num_dirty_rects];
+        add_dirty_rect(u.x1, u.y1, u.x2, u.y2);
+        return;
+    }
+
+    dirty_rects[num_dirty_rects++] = rect;
+}
+
+// LVGL draw buffers: 0 selects one full screen buffer, N > 1 selects two
+// buffers of 1/N of the screen each (LVGL renders into one while the other is
+// flushed), so the memory used doesn't grow with the display height
+#ifndef DRAW_BUFFER_DIVISOR
+#define DRAW_BUFFER_DIVISOR 0
+#endif
+
+static uint32_t draw_buffer_divisor = DRAW_BUFFER_DIVISOR;
+
+// frame statistics, read by the host through getFrameStats()
+enum {
+    FRAME_STATS_FRAMES,           // number of frames rendered
+    FRAME_STATS_LAST_TIME,        // lv_task_handler() time of the last frame (ms)
+    FRAME_STATS_AVG_TIME,         // exponential moving average of the frame time (ms)
+    FRAME_STATS_MAX_TIME,         // max. frame time (ms)
+    FRAME_STATS_LAST_FLUSHES,     // number of flushes in the last frame
+    FRAME_STATS_LAST_PIXELS,      // number of pixels flushed in the last frame
+    FRAME_STATS_DRAW_BUFFER_SIZE, // size of one draw buffer (pixels)
+    FRAME_STATS_NUM_DRAW_BUFFERS, // 1 or 2
+    FRAME_STATS_COUNT
+};
+
+static double frame_stats[FRAME_STATS_COUNT];
+static uint32_t frame_flushes;
+static uint32_t frame_pixels;
+
 #if LVGL_VERSION_MAJOR >= 9
 void my_driver_flush(lv_display_t *disp_drv, const lv_area_t *area, uint8_t *px_map) {
 #else
@@ -32,40 +128,124 @@ void my_driver_flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_
         return;
     }
 
-    uint8_t *dst = (uint8_t *)&display_fb[area->y1 * hor_res + area->x1];
-    uint32_t s = 4 * (hor_res - lv_area_get_width(area));
-    for (int y = area->y1; y <= area->y2 && y < ver_res; y++) {
-        for (int x = area->x1; x <= area->x2; x++) {
 #if LVGL_VERSION_MAJOR >= 9
-            uint8_t *src = px_map;
-            px_map += 4;
+    const uint8_t *src = px_map;
 #else
-            uint8_t *src = (uint8_t *)color_p++;
+    const uint8_t *src = (const uint8_t *)color_p;
 #endif
+    int32_t src_stride = PIXEL_SIZE * lv_area_get_width(area);
 
-            // bgr -> rgb
-            *dst++ = src[2];
-            *dst++ = src[1];
-            *dst++ = src[0];
-            *dst++ = src[3];
-        }
-
-        dst += s;
+    int32_t width = (area->x2 < hor_res ? area->x2 : hor_res - 1) - area->x1 + 1;
+    uint8_t *dst = (uint8_t *)&display_fb[area->y1 * hor_res + area->x1];
+    for (int y = area->y1; y <= area->y2 && y < ver_res; y++) {
+        convert_row(dst, src, width);
+        src += src_stride;
+        dst += 4 * hor_res;
     }
 
     lv_disp_flush_ready(disp_drv);
 
     display_fb_dirty = true;
+
+    frame_flushes++;
+    frame_pixels += width * lv_area_get_height(area);
+
+    add_dirty_rect(
+        area->x1 < 0 ? 0 : area->x1,
+        area->y1 < 0 ? 0 : area->y1,
+        area->x2 > hor_res - 1 ? hor_res - 1 : area->x2,
+        area->y2 > ver_res - 1 ? ver_res - 1 : area->y2
+    );
 }
 
-static int mouse_x = 0;
-static int mouse_y = 0;
-static int mouse_pressed = 0;
+// Input events received between two mainLoop calls are queued per input
+// device and drained by the indev read callbacks with continue_reading set,
+// so LVGL processes all of them in the next indev read.
+
+#ifndef INPUT_EVENT_QUEUE_SIZE
+#define INPUT_EVENT_QUEUE_SIZE 64
+#endif
 
-#define KEYBOARD_BUFFER_SIZE 1
-static uint32_t keyboard_buffer[KEYBOARD_BUFFER_SIZE];
-static uint32_t keyboard_buffer_index = 0;
+typedef struct {
+    int16_t x;
+    int16_t y;
+    uint8_t pressed;
+} pointer_event_t;
+
+static pointer_event_t pointer_queue[INPUT_EVENT_QUEUE_SIZE];
+static uint32_t pointer_queue_head = 0;
+static uint32_t pointer_queue_count = 0;
+static pointer_event_t pointer_last = { 0, 0, 0 };
+
+static uint32_t keyboard_queue[INPUT_EVENT_QUEUE_SIZE];
+static uint32_t keyboard_queue_head = 0;
+static uint32_t keyboard_queue_count = 0;
 static bool keyboard_pressed = false;
+static uint32_t keyboard_key = 0;
+
+typedef struct {
+    int16_t diff;
+    uint8_t pressed;
+} encoder_event_t;
+
+static encoder_event_t encoder_queue[INPUT_EVENT_QUEUE_SIZE];
+static uint32_t encoder_queue_head = 0;
+static uint32_t encoder_queue_count = 0;
+static uint8_t encoder_pressed = 0;
+
+#define INPUT_QUEUE_TAIL(head, count) (((head) + (count) - 1) % INPUT_EVENT_QUEUE_SIZE)
+
+static void pointer_queue_push(int x, int y, int pressed) {
+    if (pointer_queue_count > 0) {
+        pointer_event_t *last = &pointer_queue[INPUT_QUEUE_TAIL(pointer_queue_head, pointer_queue_count)];
+        if (last->pressed == pressed && (pointer_queue_count == INPUT_EVENT_QUEUE_SIZE || (last->x == x && last->y == y))) {
+            // queue is full or nothing changed: only update the position of
+            // the last event, press/release transitions are never merged
+            last->x = (int16_t)x;
+            last->y = (int16_t)y;
+            return;
+        }
+        if (pointer_queue_count == INPUT_EVENT_QUEUE_SIZE) {
+            // drop the oldest event
+            pointer_queue_head = (pointer_queue_head + 1) % INPUT_EVENT_QUEUE_SIZE;
+            pointer_queue_count--;
+        }
+    }
+
+    pointer_event_t *event = &pointer_queue[(pointer_queue_head + pointer_queue_count) % INPUT_EVENT_QUEUE_SIZE];
+    event->x = (int16_t)x;
+    event->y = (int16_t)y;
+    event->pressed = pressed ? 1 : 0;
+    pointer_queue_count++;
+}
+
+static void keyboard_queue_push(uint32_t key) {
+    if (keyboard_queue_count < INPUT_EVENT_QUEUE_SIZE) {
+        keyboard_queue[(keyboard_queue_head + keyboard_queue_count) % INPUT_EVENT_QUEUE_SIZE] = key;
+        keyboard_queue_count++;
+    }
+}
+
+static void encoder_queue_push(int diff, int pressed) {
+    if (encoder_queue_count > 0) {
+        encoder_event_t *last = &encoder_queue[INPUT_QUEUE_TAIL(encoder_queue_head, encoder_queue_count)];
+        if (last->pressed == pressed) {
+            // rotations with the same button state are summed up
+            int sum = last->diff + diff;
+            last->diff = (int16_t)(sum > INT16_MAX ? INT16_MAX : sum < INT16_MIN ? INT16_MIN : sum);
+            return;
+        }
+        if (encoder_queue_count == INPUT_EVENT_QUEUE_SIZE) {
+            encoder_queue_head = (encoder_queue_head + 1) % INPUT_EVENT_QUEUE_SIZE;
+            encoder_queue_count--;
+        }
+    }
+
+    encoder_event_t *event = &encoder_queue[(encoder_queue_head + encoder_queue_count) % INPUT_EVENT_QUEUE_SIZE];
+    event->diff = (int16_t)diff;
+    event->pressed = pressed ? 1 : 0;
+    encoder_queue_count++;
+}
 
 #if LVGL_VERSION_MAJOR >= 9
 void my_mouse_read(lv_indev_t * indev_drv, lv_indev_data_t * data) {
@@ -74,10 +254,17 @@ void my_mouse_read(lv_indev_drv_t * indev_drv, lv_indev_data_t * data) {
 #endif
     EEZ_UNUSED(indev_drv);
 
+    if (pointer_queue_count > 0) {
+        pointer_last = pointer_queue[pointer_queue_head];
+        pointer_queue_head = (pointer_queue_head + 1) % INPUT_EVENT_QUEUE_SIZE;
+        pointer_queue_count--;
+    }
+
     /*Store the collected data*/
-    data->point.x = (lv_coord_t)mouse_x;
-    data->point.y = (lv_coord_t)mouse_y;
-    data->state = mouse_pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    data->point.x = (lv_coord_t)pointer_last.x;
+    data->point.y = (lv_coord_t)pointer_last.y;
+    data->state = pointer_last.pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    data->continue_reading = pointer_queue_count > 0;
 }
 
 #if LVGL_VERSION_MAJOR >= 9
@@ -91,19 +278,20 @@ void my_keyboard_read(lv_indev_drv_t * indev_drv, lv_indev_data_t * data) {
         /*Send a release manually*/
         keyboard_pressed = false;
         data->state = LV_INDEV_STATE_RELEASED;
-    } else if (keyboard_buffer_index > 0) {
+        data->key = keyboard_key;
+    } else if (keyboard_queue_count > 0) {
         /*Send the pressed character*/
         keyboard_pressed = true;
+        keyboard_key = keyboard_queue[keyboard_queue_head];
+        keyboard_queue_head = (keyboard_queue_head + 1) % INPUT_EVENT_QUEUE_SIZE;
+        keyboard_queue_count--;
         data->state = LV_INDEV_STATE_PRESSED;
-        data->key = keyboard_buffer[--keyboard_buffer_index];
+        data->key = keyboard_key;
     }
 
-
+    data->continue_reading = keyboard_pressed || keyboard_queue_count > 0;
 }
 
-static int mouse_wheel_delta = 0;
-static int mouse_wheel_pressed = 0;
-
 #if LVGL_VERSION_MAJOR >= 9
 void my_mousewheel_read(lv_indev_t * indev_drv, lv_indev_data_t * data) {
 #else
@@ -111,23 +299,34 @@ void my_mousewheel_read(lv_indev_drv_t * indev_drv, lv_indev_data_t * data) {
 #endif
     (void) indev_drv;      /*Unused*/
 
-    data->state = mouse_wheel_pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
-    data->enc_diff = (int16_t)mouse_wheel_delta;
+    int16_t diff = 0;
+    if (encoder_queue_count > 0) {
+        diff = encoder_queue[encoder_queue_head].diff;
+        encoder_pressed = encoder_queue[encoder_queue_head].pressed;
+        encoder_queue_head = (encoder_queue_head + 1) % INPUT_EVENT_QUEUE_SIZE;
+        encoder_queue_count--;
+    }
 
-    mouse_wheel_delta = 0;
+    data->state = encoder_pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    data->enc_diff = diff;
+    data->continue_reading = encoder_queue_count > 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // memory based file system
 
+// Files are already in memory, so lv_fs read cache would only add another copy.
 uint16_t my_cache_size = 0;
 
 #if LV_USE_USER_DATA
 void *my_user_data = 0;
 #endif
 
+// Path is "M:<address>" or "M:<address>:<size>". Size is optional, but without
+// it reads are not bounded and LV_FS_SEEK_END is not supported.
 typedef struct {
     uint8_t *ptr;
+    uint32_t size;
     uint32_t pos;
 } my_file_t;
 
@@ -149,7 +348,9 @@ void *my_open_cb(struct _lv_fs_drv_t * drv, const char * path, lv_fs_mode_t mode
 #endif
     EEZ_UNUSED(drv);
     EEZ_UNUSED(mode);
-    file->ptr = (void *)atoi(path);
+    char *end;
+    file->ptr = (uint8_t *)strtoul(path, &end, 10);
+    file->size = *end == ':' ? strtoul(end + 1, 0, 10) : UINT32_MAX;
     file->pos = 0;
     return file;
 }
@@ -172,6 +373,11 @@ lv_fs_res_t my_read_cb(struct _lv_fs_drv_t * drv, void * file_p, void * buf, uin
 #endif
     EEZ_UNUSED(drv);
     my_file_t *file = (my_file_t *)file_p;
+    if (file->pos >= file->size) {
+        btr = 0;
+    } else if (btr > file->size - file->pos) {
+        btr = file->size - file->pos;
+    }
     memcpy(buf, file->ptr + file->pos, btr);
     file->pos += btr;
     if (br != 0)
@@ -194,6 +400,10 @@ lv_fs_res_t my_seek_cb(struct _lv_fs_drv_t * drv, void * file_p, uint32_t pos, l
         file->pos += pos;
         return LV_FS_RES_OK;
     }
+    if (whence == LV_FS_SEEK_END && file->size != UINT32_MAX) {
+        file->pos = file->size + pos;
+        return LV_FS_RES_OK;
+    }
     return LV_FS_RES_NOT_IMP;
 }
 
@@ -252,18 +462,28 @@ static void hal_init() {
     display_fb = (uint32_t *)malloc(sizeof(uint32_t) * hor_res * ver_res);
     memset(display_fb, 0x44, hor_res * ver_res * sizeof(uint32_t));
 
+    uint32_t draw_buffer_size = hor_res * ver_res;
+    bool double_buffered = false;
+    if (draw_buffer_divisor > 1) {
+        draw_buffer_size = hor_res * ((ver_res + draw_buffer_divisor - 1) / draw_buffer_divisor);
+        double_buffered = true;
+    }
+    frame_stats[FRAME_STATS_DRAW_BUFFER_SIZE] = draw_buffer_size;
+    frame_stats[FRAME_STATS_NUM_DRAW_BUFFERS] = double_buffered ? 2 : 1;
+
 #if LVGL_VERSION_MAJOR >= 9
     lv_display_t * disp = lv_display_create(hor_res, ver_res);
     lv_display_set_flush_cb(disp, my_driver_flush);
 
-    uint8_t *buf1 = malloc(sizeof(uint32_t) * hor_res * ver_res);
-    uint8_t *buf2 = NULL;
-    lv_display_set_buffers(disp, buf1, buf2, sizeof(uint32_t) * hor_res * ver_res, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    uint8_t *buf1 = malloc(PIXEL_SIZE * draw_buffer_size);
+    uint8_t *buf2 = double_buffered ? malloc(PIXEL_SIZE * draw_buffer_size) : NULL;
+    lv_display_set_buffers(disp, buf1, buf2, PIXEL_SIZE * draw_buffer_size, LV_DISPLAY_RENDER_MODE_PARTIAL);
 #else
     /*Create a display buffer*/
     static lv_disp_draw_buf_t disp_buf1;
-    lv_color_t * buf1_1 = malloc(sizeof(lv_color_t) * hor_res * ver_res);
-    lv_disp_draw_buf_init(&disp_buf1, buf1_1, NULL, hor_res * ver_res);
+    lv_color_t * buf1_1 = malloc(sizeof(lv_color_t) * draw_buffer_size);
+    lv_color_t * buf1_2 = double_buffered ? malloc(sizeof(lv_color_t) * draw_buffer_size) : NULL;
+    lv_disp_draw_buf_init(&disp_buf1, buf1_1, buf1_2, draw_buffer_size);
 
     /*Create a display*/
     static lv_disp_drv_t disp_drv;
@@ -382,19 +602,68 @@ EM_PORT_API(bool) mainLoop() {
 #endif
 
     /* Periodically call the lv_task handler */
+    frame_flushes = 0;
+    frame_pixels = 0;
+    double frameStart = emscripten_get_now();
+
     lv_task_handler();
 
+    if (frame_flushes > 0) {
+        double frameTime = emscripten_get_now() - frameStart;
+        frame_stats[FRAME_STATS_AVG_TIME] = frame_stats[FRAME_STATS_FRAMES] == 0 ? frameTime :
+            0.9 * frame_stats[FRAME_STATS_AVG_TIME] + 0.1 * frameTime;
+        frame_stats[FRAME_STATS_FRAMES]++;
+        frame_stats[FRAME_STATS_LAST_TIME] = frameTime;
+        if (frameTime > frame_stats[FRAME_STATS_MAX_TIME]) {
+            frame_stats[FRAME_STATS_MAX_TIME] = frameTime;
+        }
+        frame_stats[FRAME_STATS_LAST_FLUSHES] = frame_flushes;
+        frame_stats[FRAME_STATS_LAST_PIXELS] = frame_pixels;
+    }
+
     return flowTick();
 }
 
+// Must be called before init(), see DRAW_BUFFER_DIVISOR.
+EM_PORT_API(void) setDrawBufferDivisor(uint32_t divisor) {
+    if (!initialized) {
+        draw_buffer_divisor = divisor;
+    }
+}
+
+EM_PORT_API(double *) getFrameStats() {
+    return frame_stats;
+}
+
 EM_PORT_API(uint8_t*) getSyncedBuffer() {
     if (display_fb_dirty) {
         display_fb_dirty = false;
+
+        num_synced_dirty_rects = num_dirty_rects;
+        for (int i = 0; i < num_dirty_rects; i++) {
+            synced_dirty_rects[4 * i + 0] = dirty_rects[i].x1;
+            synced_dirty_rects[4 * i + 1] = dirty_rects[i].y1;
+            synced_dirty_rects[4 * i + 2] = dirty_rects[i].x2 - dirty_rects[i].x1 + 1;
+            synced_dirty_rects[4 * i + 3] = dirty_rects[i].y2 - dirty_rects[i].y1 + 1;
+        }
+        num_dirty_rects = 0;
+
         return (uint8_t*)display_fb;
     }
 	return NULL;
 }
 
+// Number of rectangles changed in the buffer returned by the last non-NULL
+// getSyncedBuffer() call.
+EM_PORT_API(int) getSyncedDirtyRectsCount() {
+    return num_synced_dirty_rects;
+}
+
+// (x, y, width, height) for each of the getSyncedDirtyRectsCount() rectangles.
+EM_PORT_API(int32_t*) getSyncedDirtyRects() {
+    return synced_dirty_rects;
+}
+
 EM_PORT_API(bool) isRTL() {
     return false;
 }
@@ -402,26 +671,46 @@ EM_PORT_API(bool) isRTL() {
 EM_PORT_API(void) onPointerEvent(int x, int y, int pressed) {
     if (x < 0) x = 0;
     else if (x >= hor_res) x = hor_res - 1;
-    mouse_x = x;
 
     if (y < 0) y = 0;
     else if (y >= ver_res) y = ver_res - 1;
-    mouse_y = y;
 
-    mouse_pressed = pressed;
+    pointer_queue_push(x, y, pressed);
 }
 
 EM_PORT_API(void) onMouseWheelEvent(double yMouseWheel, int pressed) {
     if (yMouseWheel >= 100 || yMouseWheel <= -100) {
         yMouseWheel /= 100;
     }
-    mouse_wheel_delta = round(yMouseWheel);
-    mouse_wheel_pressed = pressed;
+    encoder_queue_push((int)round(yMouseWheel), pressed);
 }
 
 EM_PORT_API(void) onKeyPressed(uint32_t key) {
-    if (keyboard_buffer_index < KEYBOARD_BUFFER_SIZE) {
-        keyboard_buffer[keyboard_buffer_index++] = key;
+    keyboard_queue_push(key);
+}
+
+// must be the same as in project-editor/flow/runtime/wasm-worker.ts
+#define INPUT_EVENT_POINTER 1 // x, y, pressed
+#define INPUT_EVENT_KEY 2 // key
+#define INPUT_EVENT_WHEEL 3 // wheelDeltaY, pressed
+#define INPUT_EVENT_SIZE 4
+
+// Bulk version of onPointerEvent, onMouseWheelEvent and onKeyPressed: events
+// is an array of count events, INPUT_EVENT_SIZE int32 values each (type
+// followed by the arguments).
+EM_PORT_API(void) onInputEvents(const int32_t *events, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++, events += INPUT_EVENT_SIZE) {
+        switch (events[0]) {
+        case INPUT_EVENT_POINTER:
+            onPointerEvent(events[1], events[2], events[3]);
+            break;
+        case INPUT_EVENT_KEY:
+            onKeyPressed((uint32_t)events[1]);
+            break;
+        case INPUT_EVENT_WHEEL:
+            onMouseWheelEvent(events[1], events[2]);
+            break;
+        }
     }
 }
 
@@ -1,25 +1,16 @@
 #include <stdio.h>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <string>
+#include <algorithm>
+#include <functional>
 #include <emscripten.h>
 
-#include <eez/core/os.h>
-#include <eez/core/assets.h>
-#include <eez/core/action.h>
-#include <eez/core/vars.h>
-#include <eez/core/util.h>
-
-#include <eez/flow/flow.h>
-#include <eez/flow/expression.h>
-#include <eez/flow/hooks.h>
-#include <eez/flow/debugger.h>
-#include <eez/flow/components.h>
-#include <eez/flow/flow_defs_v3.h>
-#include <eez/flow/operations.h>
-#include <eez/flow/lvgl_api.h>
-#include <eez/flow/date.h>
+#include "eez-flow.h"
 
 #include "flow.h"
+#include "update-tasks.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -107,6 +98,20 @@ struct TimelineKeyframe {
     int32_t cp2y;
 };
 
+// widget property values after some keyframes have finished,
+// enabledProperties tells which properties were set by these keyframes
+struct TimelineValues {
+    uint32_t enabledProperties;
+
+    float x;
+    float y;
+    float width;
+    float height;
+    float opacity;
+    float scale;
+    float rotate;
+};
+
 struct WidgetTimeline {
     lv_obj_t *obj;
     void *flowState;
@@ -121,10 +126,22 @@ struct WidgetTimeline {
     int16_t scale;
     int16_t rotate;
 
+    // keyframes sorted by start
     std::vector<TimelineKeyframe> timeline;
+
+    // for each keyframe i: values after keyframes [0..i] have finished and
+    // the max. end of keyframes [0..i], rebuilt after a keyframe is added
+    bool indexValid;
+    std::vector<TimelineValues> completedValues;
+    std::vector<float> maxEnd;
+
+    // number of keyframes started at the last timeline position
+    size_t lastNumStarted;
 };
 
 std::vector<WidgetTimeline> widgetTimelines;
+static std::unordered_map<lv_obj_t *, size_t> objectTimelines;
+static std::unordered_map<void *, std::vector<size_t>> flowStateTimelines;
 
 void addTimelineKeyframe(
     lv_obj_t *obj,
@@ -173,12 +190,23 @@ void addTimelineKeyframe(
     timelineKeyframe.cp2x = cp2x;
     timelineKeyframe.cp2y = cp2y;
 
-    for (auto it = widgetTimelines.begin(); it != widgetTimelines.end(); it++) {
-        WidgetTimeline &widgetTimeline = *it;
-        if (widgetTimeline.obj == obj) {
-            widgetTimeline.timeline.push_back(timelineKeyframe);
-            return;
-        }
+    auto it = objectTimelines.find(obj);
+    if (it != objectTimelines.end()) {
+        WidgetTimeline &widgetTimeline = widgetTimelines[it->second];
+
+        // after the keyframes with the same start, keyframes are usually
+        // added in order so this is an append
+        auto position = std::upper_bound(
+            widgetTimeline.timeline.begin(),
+            widgetTimeline.timeline.end(),
+            start,
+            [](float start, const TimelineKeyframe &keyframe) {
+                return start < keyframe.start;
+            }
+        );
+        widgetTimeline.timeline.insert(position, timelineKeyframe);
+        widgetTimeline.indexValid = false;
+        return;
     }
 
     WidgetTimeline widgetTimeline;
@@ -187,10 +215,94 @@ void addTimelineKeyframe(
     widgetTimeline.flowState = flowState;
 
     widgetTimeline.timeline.push_back(timelineKeyframe);
+    widgetTimeline.indexValid = false;
+    widgetTimeline.lastNumStarted = 0;
 
+    objectTimelines[obj] = widgetTimelines.size();
+    flowStateTimelines[flowState].push_back(widgetTimelines.size());
     widgetTimelines.push_back(widgetTimeline);
 }
 
+static void buildTimelineIndex(WidgetTimeline &widgetTimeline) {
+    widgetTimeline.completedValues.resize(widgetTimeline.timeline.size());
+    widgetTimeline.maxEnd.resize(widgetTimeline.timeline.size());
+
+    TimelineValues values = {};
+    float maxEnd = 0;
+
+    for (size_t i = 0; i < widgetTimeline.timeline.size(); i++) {
+        TimelineKeyframe &keyframe = widgetTimeline.timeline[i];
+
+        if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_X) {
+            values.x = keyframe.x;
+        }
+        if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_Y) {
+            values.y = keyframe.y;
+        }
+        if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_WIDTH) {
+            values.width = keyframe.width;
+        }
+        if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_HEIGHT) {
+            values.height = keyframe.height;
+        }
+        if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_OPACITY) {
+            values.opacity = keyframe.opacity;
+        }
+        if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_SCALE) {
+            values.scale = keyframe.scale;
+        }
+        if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_ROTATE) {
+            values.rotate = keyframe.rotate;
+        }
+        values.enabledProperties |= keyframe.enabledProperties;
+        widgetTimeline.completedValues[i] = values;
+
+        if (i == 0 || keyframe.end > maxEnd) {
+            maxEnd = keyframe.end;
+        }
+        widgetTimeline.maxEnd[i] = maxEnd;
+    }
+
+    widgetTimeline.lastNumStarted = 0;
+    widgetTimeline.indexValid = true;
+}
+
+// Returns the index of the first keyframe containing the timeline position,
+// or -1 if there is none, and the number of keyframes started at this position.
+static int findTimelineKeyframe(WidgetTimeline &widgetTimeline, float timelinePosition, size_t &numStarted) {
+    auto &timeline = widgetTimeline.timeline;
+
+    // the position usually stays within the segment of the last frame
+    size_t n = widgetTimeline.lastNumStarted;
+    if (
+        (n > 0 && timelinePosition < timeline[n - 1].start) ||
+        (n < timeline.size() && timelinePosition >= timeline[n].start)
+    ) {
+        n = std::upper_bound(
+            timeline.begin(),
+            timeline.end(),
+            timelinePosition,
+            [](float timelinePosition, const TimelineKeyframe &keyframe) {
+                return timelinePosition < keyframe.start;
+            }
+        ) - timeline.begin();
+        widgetTimeline.lastNumStarted = n;
+    }
+
+    numStarted = n;
+
+    if (n == 0 || widgetTimeline.maxEnd[n - 1] < timelinePosition) {
+        return -1;
+    }
+
+    if (n == 1 || widgetTimeline.maxEnd[n - 2] < timelinePosition) {
+        return n - 1;
+    }
+
+    // overlapping keyframes, or a position at the end of the previous one
+    return std::lower_bound(widgetTimeline.maxEnd.begin(), widgetTimeline.maxEnd.begin() + n, timelinePosition) - widgetTimeline.maxEnd.begin();
+}
+
 void updateTimelineProperties(WidgetTimeline &widgetTimeline, float timelinePosition) {
     if (widgetTimeline.lastTimelinePosition == -1) {
         widgetTimeline.x = lv_obj_get_style_prop(widgetTimeline.obj, LV_PART_MAIN, LV_STYLE_X).num;
@@ -225,122 +337,123 @@ void updateTimelineProperties(WidgetTimeline &widgetTimeline, float timelinePosi
     float scale = widgetTimeline.scale;
     float rotate = widgetTimeline.rotate;
 
-    for (auto itKeyframe = widgetTimeline.timeline.begin(); itKeyframe != widgetTimeline.timeline.end(); itKeyframe++) {
-        TimelineKeyframe &keyframe = *itKeyframe;
-
-        if (timelinePosition < keyframe.start) {
-            continue;
-        }
-
-        if (timelinePosition >= keyframe.start && timelinePosition <= keyframe.end) {
-            auto t =
-                keyframe.start == keyframe.end
-                    ? 1
-                    : (timelinePosition - keyframe.start) /
-                    (keyframe.end - keyframe.start);
-
-            if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_X) {
-                auto t2 = eez::g_easingFuncs[keyframe.xEasingFunc](t);
-
-                if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_CP2) {
-                    auto p1 = x;
-                    auto p2 = keyframe.cp1x;
-                    auto p3 = keyframe.cp2x;
-                    auto p4 = keyframe.x;
-                    x =
-                        (1 - t2) * (1 - t2) * (1 - t2) * p1 +
-                        3 * (1 - t2) * (1 - t2) * t2 * p2 +
-                        3 * (1 - t2) * t2 * t2 * p3 +
-                        t2 * t2 * t2 * p4;
-                } else if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_CP1) {
-                    auto p1 = x;
-                    auto p2 = keyframe.cp1x;
-                    auto p3 = keyframe.x;
-                    x =
-                        (1 - t2) * (1 - t2) * p1 +
-                        2 * (1 - t2) * t2 * p2 +
-                        t2 * t2 * p3;
-                } else {
-                    auto p1 = x;
-                    auto p2 = keyframe.x;
-                    x = (1 - t2) * p1 + t2 * p2;
-                }
-            }
-
-            if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_WIDTH) {
-                w += eez::g_easingFuncs[keyframe.widthEasingFunc](t) * (keyframe.width - w);
-            }
+    if (!widgetTimeline.indexValid) {
+        buildTimelineIndex(widgetTimeline);
+    }
 
-            if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_Y) {
-                auto t2 = eez::g_easingFuncs[keyframe.yEasingFunc](t);
-
-                if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_CP2) {
-                    auto p1 = y;
-                    auto p2 = keyframe.cp1y;
-                    auto p3 = keyframe.cp2y;
-                    auto p4 = keyframe.y;
-                    y =
-                        (1 - t2) * (1 - t2) * (1 - t2) * p1 +
-                        3 * (1 - t2) * (1 - t2) * t2 * p2 +
-                        3 * (1 - t2) * t2 * t2 * p3 +
-                        t2 * t2 * t2 * p4;
-                } else if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_CP1) {
-                    auto p1 = y;
-                    auto p2 = keyframe.cp1y;
-                    auto p3 = keyframe.y;
-                    y =
-                        (1 - t2) * (1 - t2) * p1 +
-                        2 * (1 - t2) * t2 * p2 +
-                        t2 * t2 * p3;
-                } else {
-                    auto p1 = y;
-                    auto p2 = keyframe.y;
-                    y = (1 - t2) * p1 + t2 * p2;
-                }
-            }
+    size_t numStarted;
+    int keyframeIndex = findTimelineKeyframe(widgetTimeline, timelinePosition, numStarted);
 
-            if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_HEIGHT) {
-                h += eez::g_easingFuncs[keyframe.heightEasingFunc](t) * (keyframe.height - h);
-            }
+    // all the keyframes before the one containing the position have finished
+    size_t numCompleted = keyframeIndex != -1 ? keyframeIndex : numStarted;
+    if (numCompleted > 0) {
+        TimelineValues &completedValues = widgetTimeline.completedValues[numCompleted - 1];
+        if (completedValues.enabledProperties & WIDGET_TIMELINE_PROPERTY_X) {
+            x = completedValues.x;
+        }
+        if (completedValues.enabledProperties & WIDGET_TIMELINE_PROPERTY_Y) {
+            y = completedValues.y;
+        }
+        if (completedValues.enabledProperties & WIDGET_TIMELINE_PROPERTY_WIDTH) {
+            w = completedValues.width;
+        }
+        if (completedValues.enabledProperties & WIDGET_TIMELINE_PROPERTY_HEIGHT) {
+            h = completedValues.height;
+        }
+        if (completedValues.enabledProperties & WIDGET_TIMELINE_PROPERTY_OPACITY) {
+            opacity = completedValues.opacity;
+        }
+        if (completedValues.enabledProperties & WIDGET_TIMELINE_PROPERTY_SCALE) {
+            scale = completedValues.scale;
+        }
+        if (completedValues.enabledProperties & WIDGET_TIMELINE_PROPERTY_ROTATE) {
+            rotate = completedValues.rotate;
+        }
+    }
 
-            if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_OPACITY) {
-                opacity += eez::g_easingFuncs[keyframe.opacityEasingFunc](t) * (keyframe.opacity - opacity);
-            }
+    if (keyframeIndex != -1) {
+        TimelineKeyframe &keyframe = widgetTimeline.timeline[keyframeIndex];
 
-            if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_SCALE) {
-                scale += eez::g_easingFuncs[keyframe.scaleEasingFunc](t) * (keyframe.scale - scale);
-            }
+        auto t =
+            keyframe.start == keyframe.end
+                ? 1
+                : (timelinePosition - keyframe.start) /
+                (keyframe.end - keyframe.start);
 
-            if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_ROTATE) {
-                rotate += eez::g_easingFuncs[keyframe.rotateEasingFunc](t) * (keyframe.rotate - rotate);
+        if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_X) {
+            auto t2 = eez::g_easingFuncs[keyframe.xEasingFunc](t);
+
+            if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_CP2) {
+                auto p1 = x;
+                auto p2 = keyframe.cp1x;
+                auto p3 = keyframe.cp2x;
+                auto p4 = keyframe.x;
+                x =
+                    (1 - t2) * (1 - t2) * (1 - t2) * p1 +
+                    3 * (1 - t2) * (1 - t2) * t2 * p2 +
+                    3 * (1 - t2) * t2 * t2 * p3 +
+                    t2 * t2 * t2 * p4;
+            } else if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_CP1) {
+                auto p1 = x;
+                auto p2 = keyframe.cp1x;
+                auto p3 = keyframe.x;
+                x =
+                    (1 - t2) * (1 - t2) * p1 +
+                    2 * (1 - t2) * t2 * p2 +
+                    t2 * t2 * p3;
+            } else {
+                auto p1 = x;
+                auto p2 = keyframe.x;
+                x = (1 - t2) * p1 + t2 * p2;
             }
-
-            break;
         }
 
-        if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_X) {
-            x = keyframe.x;
+        if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_WIDTH) {
+            w += eez::g_easingFuncs[keyframe.widthEasingFunc](t) * (keyframe.width - w);
         }
+
         if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_Y) {
-            y = keyframe.y;
-        }
-        if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_WIDTH) {
-            w = keyframe.width;
+            auto t2 = eez::g_easingFuncs[keyframe.yEasingFunc](t);
+
+            if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_CP2) {
+                auto p1 = y;
+                auto p2 = keyframe.cp1y;
+                auto p3 = keyframe.cp2y;
+                auto p4 = keyframe.y;
+                y =
+                    (1 - t2) * (1 - t2) * (1 - t2) * p1 +
+                    3 * (1 - t2) * (1 - t2) * t2 * p2 +
+                    3 * (1 - t2) * t2 * t2 * p3 +
+                    t2 * t2 * t2 * p4;
+            } else if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_CP1) {
+                auto p1 = y;
+                auto p2 = keyframe.cp1y;
+                auto p3 = keyframe.y;
+                y =
+                    (1 - t2) * (1 - t2) * p1 +
+                    2 * (1 - t2) * t2 * p2 +
+                    t2 * t2 * p3;
+            } else {
+                auto p1 = y;
+                auto p2 = keyframe.y;
+                y = (1 - t2) * p1 + t2 * p2;
+            }
         }
+
         if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_HEIGHT) {
-            h = keyframe.height;
+            h += eez::g_easingFuncs[keyframe.heightEasingFunc](t) * (keyframe.height - h);
         }
 
         if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_OPACITY) {
-            opacity = keyframe.opacity;
+            opacity += eez::g_easingFuncs[keyframe.opacityEasingFunc](t) * (keyframe.opacity - opacity);
         }
 
         if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_SCALE) {
-            scale = keyframe.scale;
+            scale += eez::g_easingFuncs[keyframe.scaleEasingFunc](t) * (keyframe.scale - scale);
         }
 
         if (keyframe.enabledProperties & WIDGET_TIMELINE_PROPERTY_ROTATE) {
-            rotate = keyframe.rotate;
+            rotate += eez::g_easingFuncs[keyframe.rotateEasingFunc](t) * (keyframe.rotate - rotate);
         }
     }
 
@@ -382,10 +495,10 @@ void updateTimelineProperties(WidgetTimeline &widgetTimeline, float timelinePosi
 }
 
 void doAnimateFlowState(eez::flow::FlowState *flowState) {
-    for (auto it = widgetTimelines.begin(); it != widgetTimelines.end(); it++) {
-        WidgetTimeline &widgetTimeline = *it;
-        if (widgetTimeline.flowState == flowState) {
-            updateTimelineProperties(widgetTimeline, flowState->timelinePosition);
+    auto it = flowStateTimelines.find(flowState);
+    if (it != flowStateTimelines.end()) {
+        for (auto itIndex = it->second.begin(); itIndex != it->second.end(); itIndex++) {
+            updateTimelineProperties(widgetTimelines[*itIndex], flowState->timelinePosition);
         }
     }
 
@@ -410,20 +523,12 @@ void setTimelinePosition(float timelinePosition) {
 
 void clearTimeline() {
     widgetTimelines.clear();
+    objectTimelines.clear();
+    flowStateTimelines.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-struct UpdateTask {
-    UpdateTaskType updateTaskType;
-    lv_obj_t *obj;
-    void *flow_state;
-    unsigned component_index;
-    unsigned property_index;
-    void *subobj;
-    int param;
-};
-
 static UpdateTask *g_updateTask;
 
 #if LVGL_VERSION_MAJOR >= 9
@@ -502,7 +607,11 @@ void flow_event_callback_delete_user_data(lv_event_t *e) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-std::vector<UpdateTask> updateTasks;
+static uint32_t updateTasksValuesVersion;
+
+static inline bool isNewerVersion(uint32_t version, uint32_t sinceVersion) {
+    return (int32_t)(version - sinceVersion) > 0;
+}
 
 void addUpdateTask(UpdateTaskType updateTaskType, lv_obj_t *obj, void *flow_state, unsigned component_index, unsigned property_index, void *subobj, int param) {
     UpdateTask updateTask;
@@ -513,37 +622,100 @@ void addUpdateTask(UpdateTaskType updateTaskType, lv_obj_t *obj, void *flow_stat
     updateTask.property_index = property_index;
     updateTask.subobj = subobj;
     updateTask.param = param;
-    updateTasks.push_back(updateTask);
+    updateTask.polled = !eez::flow::getPropertyDependencies((eez::flow::FlowState *)flow_state, component_index, property_index, updateTask.dependencies);
+    updateTask.dirty = true;
+    updateTask.value = false;
+    insertUpdateTask(updateTask);
+}
+
+static void markDirtyUpdateTasks() {
+    for (auto it = polledUpdateTasks.begin(); it != polledUpdateTasks.end(); it++) {
+        updateTasks[*it].dirty = true;
+    }
+
+    uint32_t valuesVersion = eez::flow::getValuesVersion();
+    if (valuesVersion == updateTasksValuesVersion) {
+        return;
+    }
+
+    if (isNewerVersion(eez::flow::getNestedValuesVersion(), updateTasksValuesVersion)) {
+        // an array element or a struct field has changed, it could be
+        // reachable from any variable
+        for (auto it = updateTasks.begin(); it != updateTasks.end(); it++) {
+            it->dirty = true;
+        }
+    } else {
+        // local variables and inputs can be references to the properties
+        // of the parent flow, so they depend on any change
+        for (auto it = flowValuesUpdateTasks.begin(); it != flowValuesUpdateTasks.end(); it++) {
+            updateTasks[*it].dirty = true;
+        }
+
+        for (auto it = globalVariableUpdateTasks.begin(); it != globalVariableUpdateTasks.end(); it++) {
+            if (isNewerVersion(eez::flow::getGlobalVariableVersion(it->first), updateTasksValuesVersion)) {
+                for (auto taskIt = it->second.begin(); taskIt != it->second.end(); taskIt++) {
+                    updateTasks[*taskIt].dirty = true;
+                }
+            }
+        }
+    }
+
+    updateTasksValuesVersion = valuesVersion;
+}
+
+static bool evalUpdateTask(UpdateTask &updateTask) {
+    if (updateTask.updateTaskType == UPDATE_TASK_TYPE_CHECKED_STATE) {
+        return evalBooleanProperty(updateTask.flow_state, updateTask.component_index, updateTask.property_index, "Failed to evaluate Checked state");
+    } else if (updateTask.updateTaskType == UPDATE_TASK_TYPE_DISABLED_STATE) {
+        return evalBooleanProperty(updateTask.flow_state, updateTask.component_index, updateTask.property_index, "Failed to evaluate Disabled state");
+    } else if (updateTask.updateTaskType == UPDATE_TASK_TYPE_HIDDEN_FLAG) {
+        return evalBooleanProperty(updateTask.flow_state, updateTask.component_index, updateTask.property_index, "Failed to evaluate Hidden flag");
+    } else if (updateTask.updateTaskType == UPDATE_TASK_TYPE_CLICKABLE_FLAG) {
+        return evalBooleanProperty(updateTask.flow_state, updateTask.component_index, updateTask.property_index, "Failed to evaluate Clickable flag");
+    }
+    return false;
 }
 
 void doUpdateTasks() {
+    markDirtyUpdateTasks();
+
     for (auto it = updateTasks.begin(); it != updateTasks.end(); it++) {
         UpdateTask &updateTask = *it;
-        
+
+        if (updateTask.updateTaskType == UPDATE_TASK_TYPE_TICK_PROPERTY) {
+            // evaluated by the Studio page runtime, see lvglIsTickPropertyChanged
+            continue;
+        }
+
         g_updateTask = &updateTask;
+
+        if (updateTask.dirty) {
+            updateTask.value = evalUpdateTask(updateTask);
+            updateTask.dirty = false;
+        }
+
+        // the last evaluated value is applied on every tick, so the widget
+        // state changed outside of the flow is still restored
+        bool new_val = updateTask.value;
         if (updateTask.updateTaskType == UPDATE_TASK_TYPE_CHECKED_STATE) {
-            bool new_val = evalBooleanProperty(updateTask.flow_state, updateTask.component_index, updateTask.property_index, "Failed to evaluate Checked state");
             bool cur_val = lv_obj_has_state(updateTask.obj, LV_STATE_CHECKED);
             if (new_val != cur_val) {
                 if (new_val) lv_obj_add_state(updateTask.obj, LV_STATE_CHECKED);
                 else lv_obj_clear_state(updateTask.obj, LV_STATE_CHECKED);
             }
         } else if (updateTask.updateTaskType == UPDATE_TASK_TYPE_DISABLED_STATE) {
-            bool new_val = evalBooleanProperty(updateTask.flow_state, updateTask.component_index, updateTask.property_index, "Failed to evaluate Disabled state");
             bool cur_val = lv_obj_has_state(updateTask.obj, LV_STATE_DISABLED);
             if (new_val != cur_val) {
                 if (new_val) lv_obj_add_state(updateTask.obj, LV_STATE_DISABLED);
                 else lv_obj_clear_state(updateTask.obj, LV_STATE_DISABLED);
             }
         } else if (updateTask.updateTaskType == UPDATE_TASK_TYPE_HIDDEN_FLAG) {
-            bool new_val = evalBooleanProperty(updateTask.flow_state, updateTask.component_index, updateTask.property_index, "Failed to evaluate Hidden flag");
             bool cur_val = lv_obj_has_flag(updateTask.obj, LV_OBJ_FLAG_HIDDEN);
             if (new_val != cur_val) {
                 if (new_val) lv_obj_add_flag(updateTask.obj, LV_OBJ_FLAG_HIDDEN);
                 else lv_obj_clear_flag(updateTask.obj, LV_OBJ_FLAG_HIDDEN);
             }
         } else if (updateTask.updateTaskType == UPDATE_TASK_TYPE_CLICKABLE_FLAG) {
-            bool new_val = evalBooleanProperty(updateTask.flow_state, updateTask.component_index, updateTask.property_index, "Failed to evaluate Clickable flag");
             bool cur_val = lv_obj_has_flag(updateTask.obj, LV_OBJ_FLAG_CLICKABLE);
             if (new_val != cur_val) {
                 if (new_val) lv_obj_add_flag(updateTask.obj, LV_OBJ_FLAG_CLICKABLE);
@@ -556,6 +728,75 @@ void doUpdateTasks() {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Value, text, ... bindings of the widgets are evaluated by the tick callbacks
+// of the Studio page runtime. They are registered as update tasks, so the
+// callback is skipped until the flow engine reports a change of the variables
+// the property depends on.
+
+static void tick_property_value_changed_callback(lv_event_t *e) {
+    // changed by the user, so the callback restores the bound value
+    auto it = objectUpdateTasks.find(lv_event_get_target_obj(e));
+    if (it != objectUpdateTasks.end()) {
+        for (auto taskIt = it->second.begin(); taskIt != it->second.end(); taskIt++) {
+            if (updateTasks[*taskIt].updateTaskType == UPDATE_TASK_TYPE_TICK_PROPERTY) {
+                updateTasks[*taskIt].dirty = true;
+            }
+        }
+    }
+}
+
+static UpdateTask *findTickProperty(lv_obj_t *obj, unsigned componentIndex, unsigned propertyIndex) {
+    auto it = objectUpdateTasks.find(obj);
+    if (it != objectUpdateTasks.end()) {
+        for (auto taskIt = it->second.begin(); taskIt != it->second.end(); taskIt++) {
+            UpdateTask &updateTask = updateTasks[*taskIt];
+            if (
+                updateTask.updateTaskType == UPDATE_TASK_TYPE_TICK_PROPERTY &&
+                updateTask.component_index == componentIndex &&
+                updateTask.property_index == propertyIndex
+            ) {
+                return &updateTask;
+            }
+        }
+    }
+    return nullptr;
+}
+
+static bool hasTickProperties(lv_obj_t *obj) {
+    auto it = objectUpdateTasks.find(obj);
+    if (it != objectUpdateTasks.end()) {
+        for (auto taskIt = it->second.begin(); taskIt != it->second.end(); taskIt++) {
+            if (updateTasks[*taskIt].updateTaskType == UPDATE_TASK_TYPE_TICK_PROPERTY) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+EM_PORT_API(void) lvglAddTickProperty(lv_obj_t *obj, void *flowState, unsigned componentIndex, unsigned propertyIndex) {
+    if (!hasTickProperties(obj)) {
+        lv_obj_add_event_cb(obj, tick_property_value_changed_callback, LV_EVENT_VALUE_CHANGED, 0);
+    }
+    addUpdateTask(UPDATE_TASK_TYPE_TICK_PROPERTY, obj, flowState, componentIndex, propertyIndex, 0, 0);
+}
+
+// Returns true once after each change, the task is removed together with the
+// other update tasks of the object in deleteObjectIndex.
+EM_PORT_API(bool) lvglIsTickPropertyChanged(lv_obj_t *obj, unsigned componentIndex, unsigned propertyIndex) {
+    UpdateTask *updateTask = findTickProperty(obj, componentIndex, propertyIndex);
+    if (!updateTask) {
+        return true;
+    }
+    if (!updateTask->dirty) {
+        return false;
+    }
+    updateTask->dirty = false;
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void startToDebuggerMessage() {
     EM_ASM({
         startToDebuggerMessage($0);
@@ -618,38 +859,38 @@ EM_PORT_API(void) setDebuggerMessageSubsciptionFilter(uint32_t filter) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-static std::map<int, lv_obj_t *> indexToObject;
+// object indexes are small and dense, nullptr marks an unused index
+static std::vector<lv_obj_t *> indexToObject;
 
 extern "C" void setObjectIndex(lv_obj_t *obj, int32_t index) {
-    indexToObject.insert(std::make_pair(index, obj));
+    if (index < 0) {
+        return;
+    }
+    if ((size_t)index >= indexToObject.size()) {
+        indexToObject.resize(index + 1, nullptr);
+    }
+    if (!indexToObject[index]) {
+        indexToObject[index] = obj;
+    }
 }
 
 void deleteObjectIndex(int32_t index) {
-    auto it = indexToObject.find(index);
-    if (it != indexToObject.end()) {
-        auto obj = it->second;
-
-        updateTasks.erase(
-            std::remove_if(
-                updateTasks.begin(), 
-                updateTasks.end(),
-                [obj](const UpdateTask& updateTask) { 
-                    return updateTask.obj == obj;
-                }
-            ),
-            updateTasks.end()
-        );
+    if (index < 0 || (size_t)index >= indexToObject.size()) {
+        return;
+    }
 
-        indexToObject.erase(it);
+    auto obj = indexToObject[index];
+    if (obj) {
+        deleteObjectUpdateTasks(obj);
+        indexToObject[index] = nullptr;
     }
 }
 
 EM_PORT_API(lv_obj_t *) getLvglObjectFromIndex(int32_t index) {
-    auto it = indexToObject.find(index);
-    if (it == indexToObject.end()) {
+    if (index < 0 || (size_t)index >= indexToObject.size()) {
         return nullptr;
     }
-    return it->second;
+    return indexToObject[index];
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -731,34 +972,114 @@ static lv_group_t *getLvglGroupFromIndex(int32_t index) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Names resolved by JavaScript are cached here, so looking up the same name
+// again doesn't cross into JavaScript. The host can also push the names it
+// knows at startup with lvglSetNameCacheEntry, the first entry for a name
+// is kept as with the JavaScript lookups. Only found names are cached.
+enum NameCacheKind {
+    NAME_CACHE_SCREEN,
+    NAME_CACHE_OBJECT,
+    NAME_CACHE_GROUP,
+    NAME_CACHE_STYLE,
+    NAME_CACHE_IMAGE,
+    NUM_NAME_CACHES
+};
+
+static std::unordered_map<std::string, int32_t> nameCaches[NUM_NAME_CACHES];
+
+static bool getCachedName(NameCacheKind kind, const char *name, int32_t &value) {
+    auto &nameCache = nameCaches[kind];
+    if (nameCache.empty()) {
+        return false;
+    }
+    auto it = nameCache.find(name);
+    if (it == nameCache.end()) {
+        return false;
+    }
+    value = it->second;
+    return true;
+}
+
+EM_PORT_API(void) lvglSetNameCacheEntry(uint32_t kind, const char *name, int32_t value) {
+    if (kind < NUM_NAME_CACHES) {
+        nameCaches[kind].emplace(name, value);
+    }
+}
+
+EM_PORT_API(void) lvglClearNameCache() {
+    for (int kind = 0; kind < NUM_NAME_CACHES; kind++) {
+        nameCaches[kind].clear();
+    }
+}
+
 static int32_t getLvglScreenByName(const char *name) {
-    return (int32_t)EM_ASM_INT({
+    int32_t screenIndex;
+    if (getCachedName(NAME_CACHE_SCREEN, name, screenIndex)) {
+        return screenIndex;
+    }
+    screenIndex = (int32_t)EM_ASM_INT({
         return getLvglScreenByName($0, UTF8ToString($1));
     }, eez::flow::g_wasmModuleId, name);
+    if (screenIndex != 0) {
+        nameCaches[NAME_CACHE_SCREEN][name] = screenIndex;
+    }
+    return screenIndex;
 }
 
 static int32_t getLvglObjectByName(const char *name) {
-    return (int32_t)EM_ASM_INT({
+    int32_t widgetIndex;
+    if (getCachedName(NAME_CACHE_OBJECT, name, widgetIndex)) {
+        return widgetIndex;
+    }
+    widgetIndex = (int32_t)EM_ASM_INT({
         return getLvglObjectByName($0, UTF8ToString($1));
     }, eez::flow::g_wasmModuleId, name);
+    if (widgetIndex != -1) {
+        nameCaches[NAME_CACHE_OBJECT][name] = widgetIndex;
+    }
+    return widgetIndex;
 }
 
 static int32_t getLvglGroupByName(const char *name) {
-    return (int32_t)EM_ASM_INT({
+    int32_t groupIndex;
+    if (getCachedName(NAME_CACHE_GROUP, name, groupIndex)) {
+        return groupIndex;
+    }
+    groupIndex = (int32_t)EM_ASM_INT({
         return getLvglGroupByName($0, UTF8ToString($1));
     }, eez::flow::g_wasmModuleId, name);
+    if (groupIndex != -1) {
+        nameCaches[NAME_CACHE_GROUP][name] = groupIndex;
+    }
+    return groupIndex;
 }
 
 static int32_t getLvglStyleByName(const char *name) {
-    return (int32_t)EM_ASM_INT({
+    int32_t styleIndex;
+    if (getCachedName(NAME_CACHE_STYLE, name, styleIndex)) {
+        return styleIndex;
+    }
+    styleIndex = (int32_t)EM_ASM_INT({
         return getLvglStyleByName($0, UTF8ToString($1));
     }, eez::flow::g_wasmModuleId, name);
+    if (styleIndex != -1) {
+        nameCaches[NAME_CACHE_STYLE][name] = styleIndex;
+    }
+    return styleIndex;
 }
 
 static const void *getLvglImageByName(const char *name) {
-    return (const void *)EM_ASM_INT({
+    int32_t imagePtr;
+    if (getCachedName(NAME_CACHE_IMAGE, name, imagePtr)) {
+        return (const void *)imagePtr;
+    }
+    imagePtr = (int32_t)EM_ASM_INT({
         return getLvglImageByName($0, UTF8ToString($1));
     }, eez::flow::g_wasmModuleId, name);
+    if (imagePtr != 0) {
+        nameCaches[NAME_CACHE_IMAGE][name] = imagePtr;
+    }
+    return (const void *)imagePtr;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
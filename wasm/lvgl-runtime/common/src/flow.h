@@ -4,7 +4,7 @@
 
 #include "lvgl/lvgl.h"
 
-#include <eez/flow/lvgl_api.h>
+#include "eez-flow.h"
 
 extern bool is_editor;
 
@@ -63,7 +63,8 @@ enum UpdateTaskType {
     UPDATE_TASK_TYPE_CHECKED_STATE,
     UPDATE_TASK_TYPE_DISABLED_STATE,
     UPDATE_TASK_TYPE_HIDDEN_FLAG,
-    UPDATE_TASK_TYPE_CLICKABLE_FLAG
+    UPDATE_TASK_TYPE_CLICKABLE_FLAG,
+    UPDATE_TASK_TYPE_TICK_PROPERTY
 };
 
 void addUpdateTask(enum UpdateTaskType updateTaskType, lv_obj_t *obj, void *flow_state, unsigned component_index, unsigned property_index, void *subobj, int param);
@@ -1,10 +1,11 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <emscripten.h>
 
 #include "lvgl/lvgl.h"
 
-#include <eez/core/os.h>
+#include "eez-flow.h"
 
 #include "flow.h"
 
@@ -616,3 +617,255 @@ EM_PORT_API(int32_t) v8_lv_slider_get_left_value(const lv_obj_t *obj) {
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////
+
+// Batched command stream used by the editor preview to build screens with
+// one call into the runtime instead of one call per object property.
+//
+// Stream is a sequence of int32 words: command code followed by its arguments.
+// Object arguments are either object pointers (0 for no object) or negative
+// values referencing objects created earlier in the same stream: -1 is the
+// first created object, -2 the second, etc. Created objects are returned
+// in the results buffer in creation order.
+
+enum LvglCommand {
+    LVGL_COMMAND_CREATE = 1,                       // createFunctionId, parentObj
+    LVGL_COMMAND_SET_PARENT = 2,                   // obj, parentObj
+    LVGL_COMMAND_SET_POS = 3,                      // obj, x, y
+    LVGL_COMMAND_SET_SIZE = 4,                     // obj, w, h
+    LVGL_COMMAND_SET_OBJECT_INDEX = 5,             // obj, index
+    LVGL_COMMAND_ADD_FLAG = 6,                     // obj, flag
+    LVGL_COMMAND_CLEAR_FLAG = 7,                   // obj, flag
+    LVGL_COMMAND_ADD_STATE = 8,                    // obj, state
+    LVGL_COMMAND_CLEAR_STATE = 9,                  // obj, state
+    LVGL_COMMAND_SET_LOCAL_STYLE_PROP_NUM = 10,    // obj, prop, num, selector
+    LVGL_COMMAND_SET_LOCAL_STYLE_PROP_COLOR = 11,  // obj, prop, color, selector
+    LVGL_COMMAND_SET_LOCAL_STYLE_PROP_PTR = 12,    // obj, prop, ptr, selector
+    LVGL_COMMAND_SET_LOCAL_STYLE_PROP_BUILT_IN_FONT = 13, // obj, prop, font_index, selector
+    LVGL_COMMAND_UPDATE_LAYOUT = 14                // obj
+};
+
+struct CreateFunction {
+    const char *name;
+    lv_obj_t *(*create)(lv_obj_t *parent);
+};
+
+static const CreateFunction CREATE_FUNCTIONS[] = {
+    { "lv_obj_create", lv_obj_create },
+    { "lv_label_create", lv_label_create },
+    { "lv_arc_create", lv_arc_create },
+    { "lv_bar_create", lv_bar_create },
+    { "lv_canvas_create", lv_canvas_create },
+    { "lv_chart_create", lv_chart_create },
+    { "lv_checkbox_create", lv_checkbox_create },
+    { "lv_dropdown_create", lv_dropdown_create },
+    { "lv_keyboard_create", lv_keyboard_create },
+    { "lv_led_create", lv_led_create },
+    { "lv_line_create", lv_line_create },
+    { "lv_list_create", lv_list_create },
+    { "lv_roller_create", lv_roller_create },
+    { "lv_slider_create", lv_slider_create },
+    { "lv_spinbox_create", lv_spinbox_create },
+    { "lv_switch_create", lv_switch_create },
+    { "lv_table_create", lv_table_create },
+    { "lv_textarea_create", lv_textarea_create },
+#if LVGL_VERSION_MAJOR >= 9
+    { "lv_button_create", lv_button_create },
+    { "lv_buttonmatrix_create", lv_buttonmatrix_create },
+    { "lv_image_create", lv_image_create },
+    { "lv_imagebutton_create", lv_imagebutton_create },
+#else
+    { "lv_btn_create", lv_btn_create },
+    { "lv_btnmatrix_create", lv_btnmatrix_create },
+    { "lv_img_create", lv_img_create },
+    { "lv_imgbtn_create", lv_imgbtn_create },
+    { "lv_meter_create", lv_meter_create },
+#endif
+};
+
+static const int32_t NUM_CREATE_FUNCTIONS = sizeof(CREATE_FUNCTIONS) / sizeof(CreateFunction);
+
+// Returns the id to use with LVGL_COMMAND_CREATE, or -1 if the create function
+// can't be called from the command stream.
+EM_PORT_API(int32_t) lvglGetCreateFunctionId(const char *name) {
+    for (int32_t i = 0; i < NUM_CREATE_FUNCTIONS; i++) {
+        if (strcmp(CREATE_FUNCTIONS[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static const int MAX_LAYOUT_SCREENS = 8;
+
+// Executes the command stream and returns the number of created objects,
+// or -1 if the stream is malformed. Commands before the malformed one are
+// executed, and objects created by them are stored in results.
+EM_PORT_API(int32_t) lvglExecuteCommands(const int32_t *commands, uint32_t length, lv_obj_t **results, uint32_t maxResults) {
+    uint32_t numResults = 0;
+    int32_t status = 0;
+
+    // layout is updated once per screen at the end instead of after every command
+    lv_obj_t *layoutScreens[MAX_LAYOUT_SCREENS];
+    int numLayoutScreens = 0;
+
+    uint32_t i = 0;
+    while (i < length) {
+        int32_t command = commands[i++];
+
+        uint32_t numArgs;
+        switch (command) {
+        case LVGL_COMMAND_UPDATE_LAYOUT:
+            numArgs = 1;
+            break;
+        case LVGL_COMMAND_CREATE:
+        case LVGL_COMMAND_SET_PARENT:
+        case LVGL_COMMAND_SET_OBJECT_INDEX:
+        case LVGL_COMMAND_ADD_FLAG:
+        case LVGL_COMMAND_CLEAR_FLAG:
+        case LVGL_COMMAND_ADD_STATE:
+        case LVGL_COMMAND_CLEAR_STATE:
+            numArgs = 2;
+            break;
+        case LVGL_COMMAND_SET_POS:
+        case LVGL_COMMAND_SET_SIZE:
+            numArgs = 3;
+            break;
+        case LVGL_COMMAND_SET_LOCAL_STYLE_PROP_NUM:
+        case LVGL_COMMAND_SET_LOCAL_STYLE_PROP_COLOR:
+        case LVGL_COMMAND_SET_LOCAL_STYLE_PROP_PTR:
+        case LVGL_COMMAND_SET_LOCAL_STYLE_PROP_BUILT_IN_FONT:
+            numArgs = 4;
+            break;
+        default:
+            status = -1;
+            break;
+        }
+
+        if (status != 0 || length - i < numArgs) {
+            status = -1;
+            break;
+        }
+
+        const int32_t *args = commands + i;
+        i += numArgs;
+
+        // first argument is always an object, except for the create command
+        // where it is the second one
+        int32_t objArg = command == LVGL_COMMAND_CREATE ? args[1] : args[0];
+        lv_obj_t *obj;
+        if (objArg < 0) {
+            uint32_t resultIndex = (uint32_t)(-(objArg + 1));
+            if (resultIndex >= numResults) {
+                status = -1;
+                break;
+            }
+            obj = results[resultIndex];
+        } else {
+            obj = (lv_obj_t *)(uintptr_t)objArg;
+        }
+
+        if (command == LVGL_COMMAND_CREATE) {
+            if (args[0] < 0 || args[0] >= NUM_CREATE_FUNCTIONS || numResults >= maxResults) {
+                status = -1;
+                break;
+            }
+            results[numResults++] = CREATE_FUNCTIONS[args[0]].create(obj);
+            continue;
+        }
+
+        if (!obj) {
+            status = -1;
+            break;
+        }
+
+        lv_style_value_t value;
+
+        switch (command) {
+        case LVGL_COMMAND_SET_PARENT: {
+            lv_obj_t *parentObj;
+            if (args[1] < 0) {
+                uint32_t resultIndex = (uint32_t)(-(args[1] + 1));
+                if (resultIndex >= numResults) {
+                    status = -1;
+                    break;
+                }
+                parentObj = results[resultIndex];
+            } else {
+                parentObj = (lv_obj_t *)(uintptr_t)args[1];
+            }
+            lv_obj_set_parent(obj, parentObj);
+            break;
+        }
+        case LVGL_COMMAND_SET_POS:
+            lv_obj_set_pos(obj, args[1], args[2]);
+            break;
+        case LVGL_COMMAND_SET_SIZE:
+            lv_obj_set_size(obj, args[1], args[2]);
+            break;
+        case LVGL_COMMAND_SET_OBJECT_INDEX:
+            setObjectIndex(obj, args[1]);
+            break;
+        case LVGL_COMMAND_ADD_FLAG:
+            lv_obj_add_flag(obj, (lv_obj_flag_t)args[1]);
+            break;
+        case LVGL_COMMAND_CLEAR_FLAG:
+            lv_obj_clear_flag(obj, (lv_obj_flag_t)args[1]);
+            break;
+        case LVGL_COMMAND_ADD_STATE:
+            lv_obj_add_state(obj, (lv_state_t)args[1]);
+            break;
+        case LVGL_COMMAND_CLEAR_STATE:
+            lv_obj_clear_state(obj, (lv_state_t)args[1]);
+            break;
+        case LVGL_COMMAND_SET_LOCAL_STYLE_PROP_NUM:
+            value.num = args[2];
+            lv_obj_set_local_style_prop(obj, (lv_style_prop_t)args[1], value, (lv_style_selector_t)args[3]);
+            break;
+        case LVGL_COMMAND_SET_LOCAL_STYLE_PROP_COLOR:
+            value.color = lv_color_hex((uint32_t)args[2]);
+            lv_obj_set_local_style_prop(obj, (lv_style_prop_t)args[1], value, (lv_style_selector_t)args[3]);
+            break;
+        case LVGL_COMMAND_SET_LOCAL_STYLE_PROP_PTR:
+            value.ptr = (const void *)(uintptr_t)args[2];
+            lv_obj_set_local_style_prop(obj, (lv_style_prop_t)args[1], value, (lv_style_selector_t)args[3]);
+            break;
+        case LVGL_COMMAND_SET_LOCAL_STYLE_PROP_BUILT_IN_FONT:
+            if (args[2] < 0 || args[2] >= (int32_t)(sizeof(BUILT_IN_FONTS) / sizeof(lv_font_t *))) {
+                status = -1;
+                break;
+            }
+            value.ptr = BUILT_IN_FONTS[args[2]];
+            lv_obj_set_local_style_prop(obj, (lv_style_prop_t)args[1], value, (lv_style_selector_t)args[3]);
+            break;
+        }
+
+        if (status != 0) {
+            break;
+        }
+
+        if (command == LVGL_COMMAND_UPDATE_LAYOUT) {
+            lv_obj_update_layout(obj);
+        } else {
+            lv_obj_t *screen = lv_obj_get_screen(obj);
+            int j;
+            for (j = 0; j < numLayoutScreens; j++) {
+                if (layoutScreens[j] == screen) {
+                    break;
+                }
+            }
+            if (j == numLayoutScreens) {
+                if (numLayoutScreens < MAX_LAYOUT_SCREENS) {
+                    layoutScreens[numLayoutScreens++] = screen;
+                } else {
+                    lv_obj_update_layout(obj);
+                }
+            }
+        }
+    }
+
+    for (int j = 0; j < numLayoutScreens; j++) {
+        lv_obj_update_layout(layoutScreens[j]);
+    }
+
+    return status == 0 ? (int32_t)numResults : -1;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+// Storage of the update tasks and of their dependency groups. Expects
+// lv_obj_t, UpdateTaskType and eez::flow::PropertyDependencies to be
+// declared, shared by flow.cpp and tools/eez-flow-bench/screen-churn.cpp
+
+#include <stdint.h>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <algorithm>
+#include <functional>
+
+struct UpdateTask {
+    UpdateTaskType updateTaskType;
+    lv_obj_t *obj;
+    void *flow_state;
+    unsigned component_index;
+    unsigned property_index;
+    void *subobj;
+    int param;
+
+    // tasks with unknown dependencies are evaluated on every tick
+    bool polled;
+    eez::flow::PropertyDependencies dependencies;
+    bool dirty;
+    bool value;
+};
+
+static std::vector<UpdateTask> updateTasks;
+
+// Update tasks are grouped by the variables they depend on and are only
+// evaluated again when the flow engine reports a change of those variables.
+// The groups keep indexes into updateTasks and are updated as tasks are
+// added, removed or moved.
+static std::map<uint32_t, std::vector<size_t>> globalVariableUpdateTasks;
+static std::vector<size_t> flowValuesUpdateTasks;
+static std::vector<size_t> polledUpdateTasks;
+
+// indexes into updateTasks of the tasks of each object
+static std::unordered_map<lv_obj_t *, std::vector<size_t>> objectUpdateTasks;
+
+template <typename Callback>
+static void forEachUpdateTaskGroup(const UpdateTask &updateTask, Callback callback) {
+    if (updateTask.polled) {
+        callback(polledUpdateTasks);
+        return;
+    }
+    if (updateTask.dependencies.flowValues) {
+        callback(flowValuesUpdateTasks);
+    }
+    for (uint32_t i = 0; i < updateTask.dependencies.numGlobalVariables; i++) {
+        callback(globalVariableUpdateTasks[updateTask.dependencies.globalVariables[i]]);
+    }
+}
+
+// Tasks are mostly removed in the reverse order they were added (a screen
+// is deleted with all of its widgets), so the group is searched from the back.
+static std::vector<size_t>::iterator findUpdateTaskIndex(std::vector<size_t> &group, size_t taskIndex) {
+    for (auto it = group.end(); it != group.begin(); ) {
+        --it;
+        if (*it == taskIndex) {
+            return it;
+        }
+    }
+    return group.end();
+}
+
+static void insertUpdateTask(const UpdateTask &updateTask) {
+    size_t taskIndex = updateTasks.size();
+    objectUpdateTasks[updateTask.obj].push_back(taskIndex);
+    updateTasks.push_back(updateTask);
+
+    forEachUpdateTaskGroup(updateTask, [taskIndex](std::vector<size_t> &group) {
+        group.push_back(taskIndex);
+    });
+}
+
+// Removes the tasks of the object by moving the last task into each freed
+// slot, so only the tasks of this object and the moved ones are touched.
+static void deleteObjectUpdateTasks(lv_obj_t *obj) {
+    auto it = objectUpdateTasks.find(obj);
+    if (it == objectUpdateTasks.end()) {
+        return;
+    }
+
+    std::vector<size_t> taskIndexes = it->second;
+    objectUpdateTasks.erase(it);
+
+    // from the highest index, so the last task is never one being removed
+    std::sort(taskIndexes.begin(), taskIndexes.end(), std::greater<size_t>());
+
+    for (auto taskIt = taskIndexes.begin(); taskIt != taskIndexes.end(); taskIt++) {
+        size_t taskIndex = *taskIt;
+        size_t lastTaskIndex = updateTasks.size() - 1;
+
+        forEachUpdateTaskGroup(updateTasks[taskIndex], [taskIndex](std::vector<size_t> &group) {
+            auto groupIt = findUpdateTaskIndex(group, taskIndex);
+            if (groupIt != group.end()) {
+                // order of the tasks in the group doesn't matter
+                *groupIt = group.back();
+                group.pop_back();
+            }
+        });
+
+        if (taskIndex != lastTaskIndex) {
+            updateTasks[taskIndex] = updateTasks[lastTaskIndex];
+
+            std::vector<size_t> &movedTaskIndexes = objectUpdateTasks[updateTasks[taskIndex].obj];
+            std::replace(movedTaskIndexes.begin(), movedTaskIndexes.end(), lastTaskIndex, taskIndex);
+
+            forEachUpdateTaskGroup(updateTasks[taskIndex], [lastTaskIndex, taskIndex](std::vector<size_t> &group) {
+                auto groupIt = findUpdateTaskIndex(group, lastTaskIndex);
+                if (groupIt != group.end()) {
+                    *groupIt = taskIndex;
+                }
+            });
+        }
+
+        updateTasks.pop_back();
+    }
+}
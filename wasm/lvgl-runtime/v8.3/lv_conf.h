@@ -493,6 +493,7 @@ typedef void * lv_user_data_t;
 /*File system interfaces for common APIs
  *To enable set a driver letter for that API*/
 #define LV_USE_FS_STDIO 'A'        /*Uses fopen, fread, etc*/
+#define LV_FS_STDIO_CACHE_SIZE 4096 /*>0 to cache this number of bytes in lv_fs_read()*/
 #define LV_USE_FS_POSIX '\0'        /*Uses open, read, etc*/
 #define LV_USE_FS_FATFS '\0'        /*Uses f_open, F_read, etc*/
 
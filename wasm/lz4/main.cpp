@@ -1,5 +1,15 @@
 #include <emscripten.h>
 
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <vector>
+
+#ifdef __EMSCRIPTEN_PTHREADS__
+#include <thread>
+#endif
+
 #include "lz4hc.h"
 
 #define EM_PORT_API(rettype) rettype EMSCRIPTEN_KEEPALIVE
@@ -11,3 +21,285 @@ extern "C" EM_PORT_API(int) encodeBound(int inputSize) {
 extern "C" EM_PORT_API(int) encodeBlockHC(const char* src, char* dst, int srcSize, int dstCapacity, int compressionLevel) {
     return LZ4_compress_HC(src, dst, srcSize, dstCapacity, compressionLevel);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// Block encoder
+//
+// Input is a list of blocks of src given by srcBlockOffsets and
+// srcBlockSizes, blocks can overlap (e.g. the whole assets image and its
+// chunks). Every block is compressed on its own (no references to other
+// blocks) so each one can be decoded separately, e.g. by the chunked assets
+// loader in the runtime. When built with -pthread blocks are compressed in
+// parallel by the threads from the pool.
+
+#ifdef LZ4_PTHREAD_POOL_SIZE
+static const int MAX_THREADS = LZ4_PTHREAD_POOL_SIZE + 1;
+#else
+static const int MAX_THREADS = 1;
+#endif
+
+struct EncodeBlocksJob {
+    const char *src;
+    const int *srcBlockOffsets;
+    const int *srcBlockSizes;
+    char *scratch;
+    const int *scratchOffsets;
+    int *dstBlockSizes;
+    int numBlocks;
+    int compressionLevel;
+    std::atomic<int> nextBlock;
+    std::atomic<bool> failed;
+};
+
+// 0 or less means as many as there are cores
+static int getNumThreads(int numThreads) {
+#ifdef __EMSCRIPTEN_PTHREADS__
+    if (numThreads <= 0) {
+        numThreads = (int)std::thread::hardware_concurrency();
+    }
+    if (numThreads > MAX_THREADS) {
+        numThreads = MAX_THREADS;
+    }
+    return numThreads > 0 ? numThreads : 1;
+#else
+    (void)numThreads;
+    return MAX_THREADS;
+#endif
+}
+
+static void encodeBlocksWorker(EncodeBlocksJob *job) {
+    // one HC state per worker, reused for all the blocks this worker takes
+    void *state = malloc(LZ4_sizeofStateHC());
+    if (!state) {
+        job->failed = true;
+        return;
+    }
+
+    for (;;) {
+        int i = job->nextBlock++;
+        if (i >= job->numBlocks || job->failed) {
+            break;
+        }
+
+        int srcSize = job->srcBlockSizes[i];
+        int compressedSize = LZ4_compress_HC_extStateHC(
+            state,
+            job->src + job->srcBlockOffsets[i],
+            job->scratch + job->scratchOffsets[i],
+            srcSize,
+            LZ4_compressBound(srcSize),
+            job->compressionLevel
+        );
+
+        if (compressedSize <= 0 && srcSize > 0) {
+            job->failed = true;
+            break;
+        }
+
+        job->dstBlockSizes[i] = compressedSize;
+    }
+
+    free(state);
+}
+
+extern "C" EM_PORT_API(int) encodeBlocksBound(const int *srcBlockSizes, int numBlocks) {
+    int bound = 0;
+    for (int i = 0; i < numBlocks; i++) {
+        bound += LZ4_compressBound(srcBlockSizes[i]);
+    }
+    return bound;
+}
+
+// Returns total compressed size (sum of dstBlockSizes) or -1 on error.
+// dstCapacity must be at least encodeBlocksBound(srcBlockSizes, numBlocks).
+extern "C" EM_PORT_API(int) encodeBlocksHC(
+    const char *src, const int *srcBlockOffsets, const int *srcBlockSizes, int numBlocks,
+    char *dst, int dstCapacity, int *dstBlockSizes,
+    int compressionLevel, int numThreads
+) {
+    if (numBlocks <= 0) {
+        return 0;
+    }
+
+    std::vector<int> scratchOffsets(numBlocks);
+    int scratchOffset = 0;
+    for (int i = 0; i < numBlocks; i++) {
+        scratchOffsets[i] = scratchOffset;
+        scratchOffset += LZ4_compressBound(srcBlockSizes[i]);
+    }
+
+    if (scratchOffset > dstCapacity) {
+        return -1;
+    }
+
+    EncodeBlocksJob job;
+    job.src = src;
+    job.srcBlockOffsets = srcBlockOffsets;
+    job.srcBlockSizes = srcBlockSizes;
+    job.scratch = dst;
+    job.scratchOffsets = scratchOffsets.data();
+    job.dstBlockSizes = dstBlockSizes;
+    job.numBlocks = numBlocks;
+    job.compressionLevel = compressionLevel;
+    job.nextBlock = 0;
+    job.failed = false;
+
+#ifdef __EMSCRIPTEN_PTHREADS__
+    numThreads = getNumThreads(numThreads);
+    if (numThreads > numBlocks) {
+        numThreads = numBlocks;
+    }
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < numThreads; i++) {
+        threads.emplace_back(encodeBlocksWorker, &job);
+    }
+    encodeBlocksWorker(&job);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+#else
+    (void)numThreads;
+    encodeBlocksWorker(&job);
+#endif
+
+    if (job.failed) {
+        return -1;
+    }
+
+    // every block was compressed at its worst case offset, move them together
+    int dstOffset = 0;
+    for (int i = 0; i < numBlocks; i++) {
+        if (dstOffset != scratchOffsets[i]) {
+            memmove(dst + dstOffset, dst + scratchOffsets[i], dstBlockSizes[i]);
+        }
+        dstOffset += dstBlockSizes[i];
+    }
+
+    return dstOffset;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Streaming encoder
+//
+// encodeStreamCreate -> encodeStreamUpdate (many times) -> encodeStreamFinish
+// Input is fed in pieces of any size and compressed into independent blocks
+// of blockSize bytes (the last one can be smaller) by encodeBlocksHC. Only
+// the input of the blocks compressed together (one per thread) is kept in
+// the stream, not the whole input. Compressed blocks are accumulated inside
+// the stream and can be read after encodeStreamFinish.
+
+struct EncodeStream {
+    int compressionLevel;
+    int blockSize;
+    int numThreads;
+    std::vector<char> input;
+    std::vector<char> output;
+    std::vector<int> blockSizes;
+    std::vector<int> compressedBlockSizes;
+};
+
+static bool encodeStreamFlush(EncodeStream *stream) {
+    if (stream->input.empty()) {
+        return true;
+    }
+
+    int inputSize = (int)stream->input.size();
+    int numBlocks = (inputSize + stream->blockSize - 1) / stream->blockSize;
+
+    std::vector<int> srcBlockOffsets(numBlocks);
+    std::vector<int> srcBlockSizes(numBlocks);
+    for (int i = 0; i < numBlocks; i++) {
+        srcBlockOffsets[i] = i * stream->blockSize;
+        srcBlockSizes[i] = std::min(stream->blockSize, inputSize - srcBlockOffsets[i]);
+    }
+
+    int bound = encodeBlocksBound(srcBlockSizes.data(), numBlocks);
+
+    size_t outputSize = stream->output.size();
+    stream->output.resize(outputSize + bound);
+
+    size_t numCompressedBlocks = stream->compressedBlockSizes.size();
+    stream->compressedBlockSizes.resize(numCompressedBlocks + numBlocks);
+
+    int compressedSize = encodeBlocksHC(
+        stream->input.data(), srcBlockOffsets.data(), srcBlockSizes.data(), numBlocks,
+        stream->output.data() + outputSize, bound, stream->compressedBlockSizes.data() + numCompressedBlocks,
+        stream->compressionLevel, stream->numThreads
+    );
+
+    if (compressedSize < 0) {
+        stream->output.resize(outputSize);
+        stream->compressedBlockSizes.resize(numCompressedBlocks);
+        return false;
+    }
+
+    stream->output.resize(outputSize + compressedSize);
+    stream->blockSizes.insert(stream->blockSizes.end(), srcBlockSizes.begin(), srcBlockSizes.end());
+    stream->input.clear();
+
+    return true;
+}
+
+extern "C" EM_PORT_API(EncodeStream *) encodeStreamCreate(int compressionLevel, int blockSize, int numThreads) {
+    if (blockSize <= 0) {
+        return nullptr;
+    }
+
+    auto stream = new EncodeStream;
+    stream->compressionLevel = compressionLevel;
+    stream->blockSize = blockSize;
+    stream->numThreads = getNumThreads(numThreads);
+    stream->input.reserve((size_t)blockSize * stream->numThreads);
+
+    return stream;
+}
+
+// Returns 0 on success or -1 on error.
+extern "C" EM_PORT_API(int) encodeStreamUpdate(EncodeStream *stream, const char *src, int srcSize) {
+    int capacity = stream->blockSize * stream->numThreads;
+
+    while (srcSize > 0) {
+        int n = std::min(capacity - (int)stream->input.size(), srcSize);
+
+        stream->input.insert(stream->input.end(), src, src + n);
+        src += n;
+        srcSize -= n;
+
+        if ((int)stream->input.size() == capacity) {
+            if (!encodeStreamFlush(stream)) {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+// Returns total compressed size or -1 on error.
+extern "C" EM_PORT_API(int) encodeStreamFinish(EncodeStream *stream) {
+    if (!encodeStreamFlush(stream)) {
+        return -1;
+    }
+    return (int)stream->output.size();
+}
+
+extern "C" EM_PORT_API(int) encodeStreamNumBlocks(EncodeStream *stream) {
+    return (int)stream->blockSizes.size();
+}
+
+extern "C" EM_PORT_API(const int *) encodeStreamBlockSizes(EncodeStream *stream) {
+    return stream->blockSizes.data();
+}
+
+extern "C" EM_PORT_API(const int *) encodeStreamCompressedBlockSizes(EncodeStream *stream) {
+    return stream->compressedBlockSizes.data();
+}
+
+extern "C" EM_PORT_API(const char *) encodeStreamData(EncodeStream *stream) {
+    return stream->output.data();
+}
+
+extern "C" EM_PORT_API(void) encodeStreamFree(EncodeStream *stream) {
+    delete stream;
+}